@@ -7,6 +7,11 @@
 #undef ABSOLUTE
 #undef ERROR
 
+//Set to 0 to decode and assemble only the documented opcodes
+#ifndef UNDOCUMENTED_OPCODES
+#define UNDOCUMENTED_OPCODES 1
+#endif
+
 //----------------------------------------------------------------
 ///Upper case char
 char Upper( char aChar );
@@ -41,6 +46,7 @@ struct OpCode
 	const char *pName;							//Opcode name
 	ADDRESS_MODE eMode;							//Addressing mode
 	uint8_t Cycles;								//Cycles for operation
+	bool bUndocumented = false;					//Not part of the documented instruction set
 
 	//----------------------------------------------------------------
 	///Case sensitive compare of string against name
@@ -55,9 +61,17 @@ struct OpCode
 
 	uint8_t QSize(  ) const { return AddrModeSize(eMode); }
 
+	static constexpr uint16_t NOTFOUND = 0x100;	//Find result past every opcode, $ff is ISC abs,x
+	static constexpr uint8_t BADOP = 0x02;		//A JAM, BAD with or without the undocumented opcodes
+
+	//----------------------------------------------------------------
+	///Find OpCode index matching given data, NOTFOUND if not found.
+	/// Documented opcodes win over undocumented ones with the same name and mode
+	static uint16_t Find( const char *apName, ADDRESS_MODE aeMode );
+
 	//----------------------------------------------------------------
-	///Find OpCode index matching given data, 0xff if not found
-	static uint8_t Find( const char *apName, ADDRESS_MODE aeMode );
+	///The original linear search of the table, kept to check and time Find against
+	static uint16_t FindReference( const char *apName, ADDRESS_MODE aeMode );
 
 	//----------------------------------------------------------------
 	///Return OpCode for given index
@@ -218,37 +218,37 @@ bool Assemble::FromString( const char *apSource, uint32_t aSourceLen, uint16_t a
 	uint16_t val = 0;
 	ADDRESS_MODE mode = CompileAddressMode(src, val);
 
+	uint16_t op = OpCode::NOTFOUND;
 	if (mode != ADDRESS_MODE::ERROR) {
-		OP = OpCode::Find(apSource, mode);
+		op = OpCode::Find(apSource, mode);
 
 		//If we didn't find the op and ADDRESS_MODE::ZERO_PAGE
 		// it may be a relative branch, so look for that
-		if ((OP == 0xff) && (Upper(apSource[0]) == 'B')) {
+		if ((op == OpCode::NOTFOUND) && (Upper(apSource[0]) == 'B')) {
 			if (mode == ADDRESS_MODE::ZERO_PAGE) {
 				mode = ADDRESS_MODE::RELATIVE;
-				OP = OpCode::Find(apSource, mode);
+				op = OpCode::Find(apSource, mode);
 			}
 			//If absolute address mode, attempt to convert to relative
 			// using supplied address
 			else if (mode == ADDRESS_MODE::ABSOLUTE) {
 				if (AbsoluteToRelative(aAddress, val)) {
 					mode = ADDRESS_MODE::RELATIVE;
-					OP = OpCode::Find(apSource, mode);
+					op = OpCode::Find(apSource, mode);
 				}
 			}
 		}
 	}
-	else {
-		OP = 0xff;
-	}
 
-	//If not the last operation (which is BAD) then found.
-	if (OP != 0xff) {
+	//$ff is a real opcode (ISC abs,x) so failure is only known from Len
+	if (op != OpCode::NOTFOUND) {
+		OP = static_cast<uint8_t>(op);
 		Len = OpCode::AddrModeSize(mode);
 		B0 = static_cast<uint8_t>(val);
 		B1 = static_cast<uint8_t>(val >> 8);
 	}
 	else {
+		OP = 0xff;
 		Len = 0;
 		B0 = 0;
 		B1 = 0;
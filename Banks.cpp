@@ -0,0 +1,180 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Banks.cpp
+//----------------------------------------------------------------------
+
+#include "Banks.h"
+#include "Command.h"
+#include "Monitor.h"
+#include "Response.h"
+
+#include <imgui.h>
+#include <string>
+#include <vector>
+
+namespace Banks
+{
+
+//----------------------------------------------------------------
+///Bank VICE told us about
+struct Bank
+{
+	uint16_t ID;
+	std::string Name;
+};
+
+const char *MemspaceNames[NUMMEMSPACES] =
+{
+	"C64",
+	"Drive 8",
+	"Drive 9",
+	"Drive 10",
+	"Drive 11"
+};
+
+std::vector<Bank> BankList;						//Banks available, in VICE order
+bool Requested = false;							//BANKS_AVAIL sent this connection
+
+//----------------------------------------------------------------
+bool QValid(  )
+{
+	return !BankList.empty();
+}
+
+//----------------------------------------------------------------
+const char *QName( Space aSpace )
+{
+	static char name[32];
+	const uint8_t memspace = QMemspace(aSpace);
+	const uint16_t bank = QBank(aSpace);
+
+	const char *pspace = memspace < NUMMEMSPACES ? MemspaceNames[memspace] : "?";
+	for ( const auto &entry : BankList ) {
+		if (entry.ID == bank) {
+			snprintf(name, sizeof(name), "%s %s", pspace, entry.Name.c_str());
+			return name;
+		}
+	}
+	snprintf(name, sizeof(name), "%s bank %u", pspace, bank);
+	return name;
+}
+
+//----------------------------------------------------------------
+void Request(  )
+{
+	if (!Requested && !QValid()) {
+		Monitor::Send(CommandPtr(new Command(COMMAND::BANKS_AVAIL)));
+		Requested = true;
+	}
+}
+
+//----------------------------------------------------------------
+void Reset(  )
+{
+	BankList.clear();
+	Requested = false;
+}
+
+//----------------------------------------------------------------
+void FromResponse( const Response &arResponse )
+{
+	//Body is a 16 bit count followed by items of:
+	// size (excluding itself), 16 bit ID, name length, name
+	BankList.clear();
+	const uint8_t *pbody = arResponse.QBody();
+	const uint32_t len = arResponse.QBodyLen();
+	uint32_t count = arResponse.Get16(0);
+	uint32_t pos = 2;
+	for ( ; count && (pos + 4 <= len); --count) {
+		const uint32_t itemSize = pbody[pos];
+		const uint32_t nameLen = pbody[pos + 3];
+		if ((pos + 4 + nameLen > len) || (nameLen + 3 > itemSize)) {
+			break;								//Malformed, keep what we have
+		}
+		BankList.push_back({ arResponse.Get16(pos + 1)
+			, std::string(reinterpret_cast<const char*>(pbody + pos + 4), nameLen) });
+		pos += itemSize + 1;
+	}
+}
+
+//----------------------------------------------------------------
+bool Combo( const char *apID, Space &arSpace )
+{
+	bool bres = false;
+	const float w = ImGui::GetFontSize();
+	uint8_t memspace = QMemspace(arSpace);
+	uint16_t bank = QBank(arSpace);
+
+	ImGui::PushID(apID);
+
+	ImGui::PushItemWidth(w * 4.0f);
+	if (ImGui::BeginCombo("##Space", memspace < NUMMEMSPACES ? MemspaceNames[memspace] : "?")) {
+		for ( uint8_t i = 0; i < NUMMEMSPACES; ++i) {
+			if (ImGui::Selectable(MemspaceNames[i], i == memspace)) {
+				bres |= (i != memspace);
+				memspace = i;
+			}
+		}
+		ImGui::EndCombo();
+	}
+	if (ImGui::IsItemHovered()) {
+		ImGui::SetTooltip("Computer or drive CPU to read memory from");
+	}
+	ImGui::PopItemWidth();
+
+	//Bank names come from VICE, until they arrive only the default is shown
+	const char *pname = "cpu";
+	for ( const auto &entry : BankList ) {
+		if (entry.ID == bank) {
+			pname = entry.Name.c_str();
+		}
+	}
+	ImGui::SameLine(0.0f, 1.0f);
+	ImGui::PushItemWidth(w * 3.5f);
+	if (ImGui::BeginCombo("##Bank", pname)) {
+		for ( const auto &entry : BankList ) {
+			if (ImGui::Selectable(entry.Name.c_str(), entry.ID == bank)) {
+				bres |= (entry.ID != bank);
+				bank = entry.ID;
+			}
+		}
+		ImGui::EndCombo();
+	}
+	if (ImGui::IsItemHovered()) {
+		ImGui::SetTooltip("Bank: cpu is memory as the CPU sees it");
+	}
+	ImGui::PopItemWidth();
+
+	ImGui::PopID();
+
+	arSpace = ToSpace(memspace, bank);
+	return bres;
+}
+
+}	//namespace Banks
@@ -0,0 +1,95 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Banks.h
+//----------------------------------------------------------------------
+
+#pragma once
+
+#include "types.h"
+
+class Response;
+
+///Memory spaces and banks VICE can read memory from. A memspace picks the
+/// computer or one of the drive CPUs, a bank picks what the CPU sees (cpu)
+/// or one layer of it (ram, rom, io, cart). Bank names and IDs depend on
+/// the emulated machine so they are asked for once per connection.
+namespace Banks
+{
+
+///VICE memspace values
+constexpr uint8_t COMPUTER = 0;
+constexpr uint8_t DRIVE8 = 1;
+constexpr uint8_t DRIVE11 = 4;
+constexpr uint8_t NUMMEMSPACES = DRIVE11 + 1;
+
+///A memspace and bank packed in one value: memspace in bits 16-23,
+/// bank ID in bits 0-15. Used to key cached memory
+using Space = uint32_t;
+
+///The computer as the CPU sees it
+constexpr Space MAIN = 0;
+
+//----------------------------------------------------------------
+///Pack a memspace and bank into a Space
+constexpr Space ToSpace( uint8_t aMemspace, uint16_t aBank )
+{ return (static_cast<uint32_t>(aMemspace) << 16) | aBank; }
+
+//----------------------------------------------------------------
+///Get memspace of a Space
+constexpr uint8_t QMemspace( Space aSpace ) { return static_cast<uint8_t>(aSpace >> 16); }
+
+//----------------------------------------------------------------
+///Get bank ID of a Space
+constexpr uint16_t QBank( Space aSpace ) { return static_cast<uint16_t>(aSpace); }
+
+//----------------------------------------------------------------
+///Return true once the list of banks has arrived
+bool QValid(  );
+
+//----------------------------------------------------------------
+///Get display name of a Space, bank name is the ID if not known
+const char *QName( Space aSpace );
+
+//----------------------------------------------------------------
+///Ask VICE for the available banks if we don't have them
+void Request(  );
+
+//----------------------------------------------------------------
+///Forget the bank list so the next Request asks again
+void Reset(  );
+
+//----------------------------------------------------------------
+///Process a BANKS_AVAIL response
+void FromResponse( const Response &arResponse );
+
+//----------------------------------------------------------------
+///Display memspace and bank combo boxes, return true if arSpace changed
+bool Combo( const char *apID, Space &arSpace );
+
+}	//namespace Banks
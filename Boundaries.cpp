@@ -0,0 +1,226 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Boundaries.cpp
+//----------------------------------------------------------------------
+
+
+#include "Boundaries.h"
+#include "6502.h"
+#include "BreakPoints.h"
+#include "Labels.h"
+#include "Regions.h"
+#include "Shadow.h"
+
+#include <bitset>
+#include <memory>
+#include <unordered_map>
+
+namespace Boundaries
+{
+
+constexpr uint32_t LEAD = 0x20;					//Bytes decoded before a page to fall into step
+constexpr uint32_t ALIGNMENTS = 3;				//Starting offsets tried, one per possible instruction length
+
+//Scores for a decoding
+constexpr int32_t EXECUTED = 8;					//Instruction VICE executed
+constexpr int32_t BREAKPOINT = 4;
+constexpr int32_t LABEL = 2;
+constexpr int32_t SKIPPED = -8;					//Decoding runs over a known entry point
+constexpr int32_t BAD = -4;						//Opcode not in the table
+constexpr int32_t ZERO = -1;					//BRK is more often empty memory
+
+//----------------------------------------------------------------
+///Instruction starts for a page
+struct Page
+{
+	std::bitset<Shadow::PAGESIZE> Starts;
+	uint32_t Stamp = 0;							//Shadow stamp of the bytes decoded
+	uint32_t LabelStamp = 0;					//Labels stamp when built
+	uint32_t EntryStamp = 0;					//Entries stamp when built
+	uint32_t RegionStamp = 0;					//Regions stamp when built
+	bool Built = false;
+};
+
+//----------------------------------------------------------------
+///Index for one memspace and bank
+struct Index
+{
+	Page PageA[Shadow::NUMPAGES];
+};
+
+std::unordered_map<Banks::Space, std::unique_ptr<Index>> Indices;	//Index per memspace/bank
+std::bitset<Shadow::IMAGESIZE> Entries;			//Addresses VICE executed from
+uint32_t EntryStamp = 0;						//Incremented when an entry is added
+
+//----------------------------------------------------------------
+void AddEntry( uint16_t aAddress )
+{
+	if (!Entries[aAddress]) {
+		Entries[aAddress] = true;
+		++EntryStamp;
+	}
+}
+
+//----------------------------------------------------------------
+void Clear(  )
+{
+	Entries.reset();
+	++EntryStamp;								//Pages built with them are rebuilt
+}
+
+//----------------------------------------------------------------
+///Score for an instruction starting at an address. Entry points only
+/// mean something for the computer, which they were seen on
+int32_t Score( uint16_t aAddress, uint8_t aOp, bool abComputer )
+{
+	int32_t score = 0;
+	if (abComputer) {
+		score += Entries[aAddress] ? EXECUTED : 0;
+		score += BreakPoints::QBreakPoint(aAddress) ? BREAKPOINT : 0;
+		score += Labels::Find(aAddress) ? LABEL : 0;
+	}
+	score += (OpCode::Get(aOp) == "BAD") ? BAD : 0;
+	score += aOp ? 0 : ZERO;
+	return score;
+}
+
+//----------------------------------------------------------------
+///Decode the page along each alignment and keep the best
+void Build( Page &arPage, uint32_t aPage, Banks::Space aSpace )
+{
+	const uint8_t *pimage = Shadow::QImage(aSpace);
+	const bool computer = Banks::QMemspace(aSpace) == Banks::COMPUTER;
+	const bool bregions = aSpace == Banks::MAIN;	//Regions only cover the computer's main memory
+	const uint32_t base = aPage * Shadow::PAGESIZE;
+	const uint32_t end = base + Shadow::PAGESIZE;
+	const uint32_t lead = base >= LEAD ? base - LEAD : 0;
+
+	int32_t bestScore = INT32_MIN;
+	for ( uint32_t align = 0; align < ALIGNMENTS; ++align) {
+		std::bitset<Shadow::PAGESIZE> starts;
+		int32_t score = 0;
+		uint32_t addr = lead + align;
+		while (addr < end) {
+			const uint8_t op = pimage[addr];
+			uint32_t next = addr + std::max<uint32_t>(OpCode::Get(op).QSize(), 1);
+
+			//Data lines are set by the regions whatever the alignment,
+			// as are instructions cut short by data
+			if (bregions) {
+				if (const Regions::Span span = Regions::QLine(static_cast<uint16_t>(addr), next - addr); Regions::QData(span.Type)) {
+					if ((span.Start == addr) && (addr >= base)) {
+						starts[addr - base] = true;
+					}
+					addr = span.Start + span.Length;
+					continue;
+				}
+			}
+
+			score += Score(static_cast<uint16_t>(addr), op, computer);
+			if (addr >= base) {
+				starts[addr - base] = true;
+			}
+
+			//Executed addresses are certain, so fall into step with one
+			// this instruction would run over
+			for ( uint32_t inside = addr + 1; computer && (inside < next) && (inside < end); ++inside) {
+				if (Entries[inside]) {
+					score += SKIPPED;
+					next = inside;
+				}
+			}
+			addr = next;
+		}
+		if (score > bestScore) {
+			bestScore = score;
+			arPage.Starts = starts;
+		}
+	}
+}
+
+//----------------------------------------------------------------
+///Get page index, rebuilding it if what it was built from changed
+const Page &Get( uint32_t aPage, Banks::Space aSpace )
+{
+	auto &pindex = Indices[aSpace];
+	if (!pindex) {
+		pindex = std::make_unique<Index>();
+	}
+
+	//Page is decoded from the end of the page before
+	const auto base = static_cast<uint16_t>(aPage * Shadow::PAGESIZE);
+	const auto lead = static_cast<uint16_t>(base >= LEAD ? base - LEAD : 0);
+	const auto last = static_cast<uint16_t>(base + Shadow::PAGESIZE - 1);
+	Shadow::Fetch(lead, last, aSpace);
+	const uint32_t stamp = Shadow::QStamp(lead, last, aSpace);
+
+	const uint32_t regionStamp = (aSpace == Banks::MAIN) ? Regions::QStamp() : 0;
+	Page &page = pindex->PageA[aPage];
+	if (!page.Built || (page.Stamp != stamp) || (page.LabelStamp != Labels::QStamp())
+		|| (page.EntryStamp != EntryStamp) || (page.RegionStamp != regionStamp)) {
+		Build(page, aPage, aSpace);
+		page.Stamp = stamp;
+		page.LabelStamp = Labels::QStamp();
+		page.EntryStamp = EntryStamp;
+		page.RegionStamp = regionStamp;
+		page.Built = true;
+	}
+	return page;
+}
+
+//----------------------------------------------------------------
+///Get start of the instruction before the one at aAddress
+uint16_t Prev( uint16_t aAddress, Banks::Space aSpace )
+{
+	if (aAddress == 0) return 0;
+
+	//Instructions are at most 3 bytes and data lines LINEMAX, so the
+	// previous start is close
+	const uint32_t longest = (aSpace == Banks::MAIN) ? Regions::LINEMAX : 3;
+	const uint32_t first = aAddress >= longest ? aAddress - longest : 0;
+	for ( uint32_t addr = aAddress - 1; addr >= first; --addr) {
+		const Page &page = Get(addr / Shadow::PAGESIZE, aSpace);
+		if (page.Starts[addr % Shadow::PAGESIZE]) {
+			return static_cast<uint16_t>(addr);
+		}
+		if (addr == 0) break;
+	}
+	return static_cast<uint16_t>(aAddress - 1);	//Decodings disagree at a page edge
+}
+
+//----------------------------------------------------------------
+uint16_t QPrev( uint16_t aAddress, uint32_t aCount, Banks::Space aSpace )
+{
+	while (aCount-- && aAddress) {
+		aAddress = Prev(aAddress, aSpace);
+	}
+	return aAddress;
+}
+
+}	//namespace Boundaries
@@ -0,0 +1,62 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Boundaries.h
+//----------------------------------------------------------------------
+
+
+#pragma once
+
+#include "types.h"
+#include "Banks.h"
+
+///Index of instruction start addresses, so the Code view can scroll
+/// backwards onto real instructions. Each 256 byte page is decoded from
+/// a little before its start along a few alignments, and the decoding
+/// that best agrees with known entry points (IPs seen, breakpoints and
+/// labels) and has the fewest bad opcodes is kept as a bitmap of starts.
+/// Data lines of the computer's Regions are placed as the Code view shows
+/// them. Pages are rebuilt when their Shadow bytes, the labels, the entry
+/// points or the regions change.
+namespace Boundaries
+{
+
+//----------------------------------------------------------------
+///Note an address VICE executed from, so it starts an instruction
+void AddEntry( uint16_t aAddress );
+
+//----------------------------------------------------------------
+///Forget the executed addresses, for when a different program or
+/// machine state replaces the one they were seen in
+void Clear(  );
+
+//----------------------------------------------------------------
+///Get start of the instruction aCount instructions before aAddress
+uint16_t QPrev( uint16_t aAddress, uint32_t aCount = 1, Banks::Space aSpace = Banks::MAIN );
+
+}	//namespace Boundaries
@@ -31,6 +31,7 @@
 
 #include "BreakPoints.h"
 #include "Command.h"
+#include "Footprint.h"
 #include "Monitor.h"
 #include "Numbers.h"
 #include "Response.h"
@@ -68,7 +69,9 @@ public:
 	BreakPoint(  ) = delete;
 
 	//----------------------------------------------------------------
-	explicit BreakPoint( uint16_t aAddress ) : Address(aAddress)
+	explicit BreakPoint( uint16_t aAddress, bool abEnabled = true )
+	: Address(aAddress)
+	, Enabled(abEnabled)
 	{
 		//Create a command, don't use an ID so we always process the responses
 		// without having to look for them.
@@ -85,7 +88,9 @@ public:
 
 	//----------------------------------------------------------------
 	///Constructor for memory checkpoint/breakpoint
-	explicit BreakPoint( uint16_t aStartAddress, uint16_t aEndAddress, uint8_t aBreak = 0 ) : Address(aStartAddress)
+	explicit BreakPoint( uint16_t aStartAddress, uint16_t aEndAddress, uint8_t aBreak = 0 )
+	: Address(aStartAddress)
+	, Op(CHECKOP::STORE)
 	{
 		//Create a command, don't use an ID so we always process the responses
 		// without having to look for them.
@@ -94,7 +99,7 @@ public:
 		pCommand->Add(aEndAddress);				//End address
 		pCommand->Add(aBreak);					//Stop when hit?
 		pCommand->Add(Enabled);					//Enabled state
-		pCommand->Add(CHECKOP::STORE);			//Execution operations
+		pCommand->Add(Op);						//Execution operations
 		pCommand->Add(0_u16);					//Not temporary and memspace 0
 
 		Monitor::Send(pCommand);				//Send add command
@@ -146,6 +151,7 @@ public:
 	uint32_t Index = 0xFFFFFFFF;				//Index for breakpoint assigned by VICE
 	uint16_t Address;							//Address of the breakpoint
 	uint8_t Enabled = true;						//Enabled state
+	uint8_t Op = CHECKOP::EXEC;					//Operation checked, EXEC for breakpoints
 };
 
 //----------------------------------------------------------------
@@ -176,6 +182,13 @@ bool CheckHit( uint16_t aAddress )
 	return bres;
 }
 
+//----------------------------------------------------------------
+bool QBreakPoint( uint16_t aAddress )
+{
+	auto entry = BreakPointA.find(aAddress);
+	return (entry != BreakPointA.end()) && (entry->second->Op == CHECKOP::EXEC);
+}
+
 //----------------------------------------------------------------
 void Add( uint16_t aAddress )
 {
@@ -227,6 +240,37 @@ void Toggle( uint16_t aAddress )
 	}
 }
 
+//----------------------------------------------------------------
+void StateToJson( nlohmann::json &arData )
+{
+	auto list = nlohmann::json::array();
+	for ( const auto &entry : BreakPointA ) {
+		//Memory CheckPoints belong to the views that set them
+		if (entry.second->Op == CHECKOP::EXEC) {
+			list.push_back({entry.second->Address, entry.second->QEnabled()});
+		}
+	}
+	arData["BreakPointList"] = list;
+}
+
+//----------------------------------------------------------------
+void StateFromJson( nlohmann::json &arData )
+{
+	auto list = arData["BreakPointList"];
+	if (list.is_array()) {
+		//Remove current breakpoints, leaving memory CheckPoints
+		std::erase_if(BreakPointA, []( const auto &arEntry ) {
+			return arEntry.second->Op == CHECKOP::EXEC;
+		});
+
+		for ( const auto &entry : list ) {
+			uint16_t addr = entry[0];
+			bool enabled = entry[1];
+			BreakPointA[addr] = BreakPointPtr(new BreakPoint(addr, enabled));
+		}
+	}
+}
+
 //----------------------------------------------------------------
 void Close(  )
 {
@@ -264,6 +308,10 @@ void ProcessInfo( const Response &arResponse )
 	if (auto entry = BreakPointA.find(addr); entry != BreakPointA.end()) {
 		entry->second->Index = index;			//Make sure index is set
 		entry->second->Enabled = arResponse.Get8(10);
+		//A store to memory a view watches, which tells us what a step changed
+		if ((entry->second->Op == CHECKOP::STORE) && arResponse.Get8(4)) {
+			Footprint::Hit(addr, arResponse.Get16(7));
+		}
 	}
 	else {
 		//This isn't one of our breakpoints so delete it
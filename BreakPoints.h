@@ -51,6 +51,10 @@ namespace BreakPoints
 	///Returns true if a breakpoint for given address exists and is enabled
 	bool CheckHit( uint16_t aAddress );
 
+	//----------------------------------------------------------------
+	///Returns true if an execution breakpoint exists for given address
+	bool QBreakPoint( uint16_t aAddress );
+
 	//----------------------------------------------------------------
 	///Add a BreakPoint for given address
 	void Add( uint16_t aAddress );
@@ -95,4 +99,12 @@ namespace BreakPoints
 	///Enable display
 	void DisplayOn(  );
 
+	//----------------------------------------------------------------
+	///Save address and enable state of each breakpoint to json
+	void StateToJson( nlohmann::json &arData );
+
+	//----------------------------------------------------------------
+	///Replace breakpoints with those saved by StateToJson
+	void StateFromJson( nlohmann::json &arData );
+
 }	//namespace BreakPoints
@@ -32,18 +32,30 @@
 #include "Code.h"
 #include "6502.h"
 #include "Assembler.h"
+#include "Banks.h"
+#include "Boundaries.h"
 #include "BreakPoints.h"
-#include "DisAssembler.h"
+#include "DisCache.h"
 #include "Command.h"
+#include "Flow.h"
+#include "Footprint.h"
 #include "ImGuiUtils.h"
 #include "Labels.h"
 #include "Monitor.h"
 #include "Numbers.h"
-#include "Response.h"
-
+#include "Regions.h"
+#include "Shadow.h"
+#include "Smc.h"
+#include "Timing.h"
+#include "Xref.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
 #include <imgui.h>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 /*{
 TODO:
@@ -63,32 +75,79 @@ TODO:
 namespace Code
 {
 
-constexpr uint32_t ASSEMBLYLINES = 0x20;					//Number of lines to display at a time
-constexpr uint32_t ASSEMBLYBLOCKSIZE = ASSEMBLYLINES * 3;	//Maximum 3 bytes per op
-constexpr uint16_t LASTADDRESS = 0x10000 - ASSEMBLYBLOCKSIZE;
+constexpr uint32_t MINLINES = 4;				//Fewest lines a view is sized to
+constexpr uint32_t DEFLINES = 0x20;				//Lines before the window is first sized
 constexpr uint32_t CODELINELEN = 0x20;			//Suggested maximum length of view line
-constexpr uint32_t ADDRLINELEN = 5;				//Length of line in AddressView
-constexpr uint32_t CODEVIEWSIZE = ASSEMBLYLINES * CODELINELEN;
-constexpr uint32_t BYTELINELEN = 9;				//Up to 3 bytes taking 3 chars each
-constexpr uint32_t BYTEVIEWSIZE = ASSEMBLYLINES * BYTELINELEN;
 constexpr uint32_t LABELLINELEN = 13;			//12 char maximum label size
-constexpr uint32_t LABELVIEWSIZE = ASSEMBLYLINES * LABELLINELEN;
+
+uint32_t KeyView = 0;							//View handling the function keys
 
 const CommandPtr StepOutCommand(new Command(COMMAND::STEP_OUT, NOID));
 CommandPtr StepCommand(new Command(COMMAND::ADVANCE, NOID));
 
 //----------------------------------------------------------------
+///One line of a view. Text and bytes point into the shared DisCache,
+/// or the view's own text for data, and the label into Labels, all kept
+/// until the memory, labels or regions change, which rebuilds the lines
+struct Line
+{
+	const OpCode *pOpCode = nullptr;			//Instruction decoded at Address, nullptr for data
+	const char *pText = nullptr;				//Disassembly
+	const char *pBytes = nullptr;				//Hex of the instruction bytes
+	const char *pLabel = nullptr;				//Label at Address, nullptr if none
+	uint16_t Address = 0;						//Address of the instruction
+	uint8_t TextLen = 0;						//Length of pText
+	uint8_t BytesLen = 0;						//Length of pBytes
+	uint8_t LabelLen = 0;						//Length of pLabel shown
+	uint8_t Size = 0;							//Bytes in the line
+};
+
+//----------------------------------------------------------------
+///Text of a data line
+struct DataText
+{
+	char Text[DisCache::TEXTLEN];
+	char Bytes[DisCache::BYTESLEN];
+};
+
+//----------------------------------------------------------------
+/// Disassembly sized to the window. View 0 normally follows the IP
+/// while the others stay pinned to an address, all reading the one
+/// DisCache
 class CodeView
 {
 public:
 
 	//----------------------------------------------------------------
-	explicit CodeView(  ) : LabelFilter(32.0f, 10.0f)
+	///Constructor with given ID used to reference the view
+	explicit CodeView( uint8_t aID )
+	: LabelFilter(32.0f, 10.0f)
+	, IDNum(aID)
+	, Enabled(aID == 0)
+	, FollowIP(aID == 0)
 	{
-		Clear();
+		if (aID) {
+			ID[4] = static_cast<char>('0' + aID);	//View 0 keeps the plain name
+		}
+
+		//Command object used to send edits
+		pCommand = CommandPtr(new Command(COMMAND::MEMORY_SET));
+	}
+
+	//----------------------------------------------------------------
+	///Return display enabled state
+	bool QEnabled(  ) const { return Enabled; }
 
-		//Allocate Command object large enough to send updates
-		pCommand = Command::Create(COMMAND::MEMORY_GET, ASSEMBLYBLOCKSIZE + 8);
+	//----------------------------------------------------------------
+	///Enable/Disable display of the view. View 0 can't be closed
+	void SetEnabled( bool abTF )
+	{
+		if (IDNum && (Enabled != abTF)) {
+			Enabled = abTF;
+			if (Enabled) {
+				Show();
+			}
+		}
 	}
 
 	//----------------------------------------------------------------
@@ -104,17 +163,21 @@ public:
 	uint16_t QAddress(  ) const { return Address; }
 
 	//----------------------------------------------------------------
-	///Get bank view is looking at
-	uint16_t QBank(  ) const { return Bank; }
+	///Get memspace and bank view is looking at
+	Banks::Space QSpace(  ) const { return Space; }
 
 	//----------------------------------------------------------------
-	///Clear the view display buffers
-	void Clear(  )
+	///Set memspace and bank to disassemble. The IP is the computer's,
+	/// so stop following it when looking at a drive
+	void SetSpace( Banks::Space aSpace )
 	{
-		AddressView[0] = 0;
-		DisView[0] = 0;
-		ByteView[0] = 0;
-		LabelView[0] = 0;
+		if (aSpace != Space) {
+			Space = aSpace;
+			if (Banks::QMemspace(Space) != Banks::COMPUTER) {
+				FollowIP = false;
+			}
+			Show();
+		}
 	}
 
 	//----------------------------------------------------------------
@@ -128,11 +191,23 @@ public:
 	///Draw this view
 	void Display( bool abInputEnabled )
 	{
+		if (!Enabled) {
+			if (KeyView == IDNum) {
+				KeyView = 0;					//Closed, function keys go back to view 0
+			}
+			return;								//Early out if view not visible
+		}
+
 		InputEnabled = abInputEnabled;
 
-		ImGui::SetNextWindowPos(ImVec2(0, 95), ImGuiCond_FirstUseEver);
+		Update();								//Make sure disassembly is up to date
+
+		//Set start position and size on first run, after that any height
+		const float offset = 24.0f * IDNum;
+		ImGui::SetNextWindowPos(ImVec2(offset, 95.0f + offset), ImGuiCond_FirstUseEver);
 		ImGui::SetNextWindowSize(ImVec2(386, 512), ImGuiCond_FirstUseEver);
-		ImGui::Begin("Code", nullptr, ImGuiWindowFlags_NoResize);
+		ImGui::SetNextWindowSizeConstraints(ImVec2(386.0f, 0.0f), ImVec2(FLT_MAX, FLT_MAX));
+		ImGui::Begin(ID, IDNum ? &Enabled : nullptr);
 
 		uint16_t loc = QAddress();
 
@@ -150,7 +225,6 @@ public:
 			}
 		};
 
-		const float h = ImGui::GetTextLineHeightWithSpacing(); //ImGui::GetFontSize();
 		const float w = ImGui::GetTextLineHeight() - 5.4f;
 
 		ImGui::Text("Label");
@@ -158,6 +232,10 @@ public:
 		ImGui::Text("Address");
 		ImGui::SameLine(0.0f, w * 8.0f);
 		ImGui::Checkbox("FollowIP", &FollowIP);
+		ImGui::SameLine();
+		if (auto space = Space; Banks::Combo("##Space", space)) {
+			SetSpace(space);
+		}
 
 		//Show label search
 		ImGui::PushItemWidth(w * 12.0f);
@@ -184,6 +262,10 @@ public:
 			RequestMemory();
 		}
 
+		//Fit as many lines as the window has room for
+		const float fs = ImGui::GetFontSize();
+		SetLines(static_cast<uint32_t>((ImGui::GetContentRegionAvail().y - 12.0f) / fs));
+
 		//Change border color based on input enable
 		uint32_t frameColor = InputEnabled
 			? IM_COL32(200, 255, 255, 100)
@@ -198,16 +280,19 @@ public:
 		auto currentPos = ImGui::GetCursorPos();	//Get position relative to frame
 		currentPos.x -= 4.0f;
 		currentPos.y -= 3.0f;					//Offset reltive to InputTextMultiline
-		//Set the width for 12 bytes
-		ImGui::SetCursorPos(currentPos);
-		ImGui::Text(LabelView);
-		ImGui::SameLine(0.0f, 1.0f);
-
-		currentPos.x += w * (LABELLINELEN - 1);
-		ImGui::SetCursorPos(currentPos);
-
-		//Add address lines
-		ImGui::Text(AddressView);
+		//Labels take up to 12 chars, followed by the address
+		for ( uint32_t i = 0; i < Lines.size(); ++i) {
+			const Line &rline = Lines[i];
+			const float y = currentPos.y + (fs * i);
+			if (rline.pLabel) {
+				ImGui::SetCursorPos(ImVec2(currentPos.x, y));
+				ImGui::TextUnformatted(rline.pLabel, rline.pLabel + rline.LabelLen);
+			}
+			char addr[8];
+			Numbers::ToHex(addr, rline.Address);
+			ImGui::SetCursorPos(ImVec2(currentPos.x + (w * (LABELLINELEN - 1)), y));
+			ImGui::TextUnformatted(addr, addr + 4);
+		}
 
 		ImGui::EndChild();
 		ImGui::PopStyleColor();					//Border color
@@ -227,14 +312,19 @@ public:
 		currentPos = ImGui::GetCursorPos();		//Get position relative to frame
 		currentPos.x -= 4.0f;
 		currentPos.y -= 3.0f;					//Offset reltive to InputTextMultiline
-		ImGui::SetCursorPos(currentPos);
 		constexpr ImVec4 blue(0.1f, 0.4f, 0.6f, 1.0f);
-		ImGui::TextColored(blue, ByteView, ImVec2(w * 9.0f, (h * ASSEMBLYLINES) + 5));
+		ImGui::PushStyleColor(ImGuiCol_Text, blue);
+		for ( uint32_t i = 0; i < Lines.size(); ++i) {
+			ImGui::SetCursorPos(ImVec2(currentPos.x, currentPos.y + (fs * i)));
+			ImGui::TextUnformatted(Lines[i].pBytes, Lines[i].pBytes + Lines[i].BytesLen);
+		}
+		ImGui::PopStyleColor();
 
 		currentPos.x += w * 9.0f;
-		ImGui::SetCursorPos(currentPos);
-
-		ImGui::Text(DisView);
+		for ( uint32_t i = 0; i < Lines.size(); ++i) {
+			ImGui::SetCursorPos(ImVec2(currentPos.x, currentPos.y + (fs * i)));
+			ImGui::TextUnformatted(Lines[i].pText, Lines[i].pText + Lines[i].TextLen);
+		}
 
 		HandleInputs();
 
@@ -244,7 +334,7 @@ public:
 
 		//Draw cursor
 		float y = currentPos.y;
-		currentPos.y += ImGui::GetFontSize() * Cursor;
+		currentPos.y += fs * Cursor;
 		ImGui::SetCursorPos(currentPos);
 
 		static const ImVec4 reg(0.0f, 0.4f, 0.6f, 0.5f);
@@ -271,7 +361,7 @@ public:
 
 		//Place Instruction Pointer
 		if (IPCursor >= 0.0f) {
-			currentPos.y = y + (ImGui::GetFontSize() * IPCursor);
+			currentPos.y = y + (fs * IPCursor);
 			currentPos.x -= w; //ImGui::GetTextLineHeight();
 			ImGui::SetCursorPos(currentPos);
 			constexpr ImVec4 red(1.0f, 0.0f, 0.0f, 1.0f);
@@ -280,7 +370,12 @@ public:
 			ImGui::SetCursorPos(currentPos);
 		}
 
+		DisplaySmc(savePos);
+		DisplayFlow(savePos);
+		DisplayCycles(savePos);
+		DisplayXrefs(savePos);
 		DisplayBreakPoints(savePos);
+		DisplayRegionMenu();
 
 		ImGui::EndChild();
 		ImGui::PopStyleColor();					//Border color
@@ -291,8 +386,8 @@ public:
 		if (ImGui::IsItemClicked(0)) {
 			auto ul = ImGui::GetItemRectMin();
 			auto mouse = ImGui::GetMousePos();
-			y = (mouse.y - ul.y) / ImGui::GetFontSize();
-			if ((y >= 0.0f) && (y < ASSEMBLYLINES)) {
+			y = (mouse.y - ul.y) / fs;
+			if ((y >= 0.0f) && (y < Lines.size())) {
 				Cursor = floor(y);
 			}
 		}
@@ -307,7 +402,7 @@ public:
 		if (Address != aAddress) {
 			NewAddress = true;
 			Address = aAddress;
-			RequestMemory();
+			Show();
 		}
 	}
 
@@ -315,132 +410,274 @@ public:
 	///Set Instruction Pointer address
 	void SetIP( uint16_t aAddress )
 	{
-		if (QFollowIP()) {
-			constexpr uint16_t IPADJ = 0xa * 3;				//Number of lines * maximum 3 bytes per op
-
-			//If the IPAddress has changed find the new one.
-			if (IPAddress != aAddress) {
-				IPAddress = aAddress;
-				IPCursor = AddressToIndex(aAddress);
-				//If the IPCursor isn't in view, place it close to the middle of the view
-				// and get new data
-				if (IPCursor < 0.0f) {
-					uint16_t newAddress = aAddress > IPADJ ? aAddress - IPADJ : 0_u16;
-					SetAddress(newAddress);
-				}
+		//If the IPAddress has changed find the new one. Pinned views
+		// only mark it when it is in view
+		if (IPAddress != aAddress) {
+			IPAddress = aAddress;
+			IPCursor = AddressToIndex(aAddress);
+			//If the IPCursor isn't in view, place it a third of the way down
+			// and get new data
+			if (QFollowIP() && (IPCursor < 0.0f)) {
+				SetAddress(Boundaries::QPrev(aAddress, NumLines / 3, Space));
 			}
 		}
 	}
 
 	//----------------------------------------------------------------
-	///Update the disassembly view
+	///Update the disassembly view from the decoded instruction cache
 	void UpdateDisView(  )
 	{
-		DisAssembler::Input input{
-			DisView,
-			ByteView,
-			OpCodes,
-			Data,
-			CODEVIEWSIZE,
-			ASSEMBLYBLOCKSIZE,
-			ASSEMBLYLINES,
-			Address
-		};
+		if (Address == 0xFFFF) return;
+
+		Lines.resize(NumLines);
+		DataLines.resize(NumLines);
+		Ordered = NumLines;
+
+		//Use 32 bit math to find where the lines run past the end of memory
+		uint32_t addr = Address;
+		for ( uint32_t i = 0; i < NumLines; ++i) {
+			if ((addr > 0xffff) && (Ordered == NumLines)) {
+				Ordered = i;
+			}
+
+			Line &rline = Lines[i];
+			rline.Address = static_cast<uint16_t>(addr);
+			const auto &rdis = DisCache::Get(rline.Address, Space);
+			if (const Regions::Span span = QSpan(rline.Address, rdis.QSize()); Regions::QData(span.Type)) {
+				rline.pOpCode = nullptr;
+				rline.Size = static_cast<uint8_t>(span.Start + span.Length - rline.Address);
+				FormatData(DataLines[i], rline.Address, rline.Size, span.Type);
+				rline.pText = DataLines[i].Text;
+				rline.pBytes = DataLines[i].Bytes;
+			}
+			else {
+				rline.pOpCode = rdis.pOpCode;
+				rline.Size = rdis.QSize();
+				rline.pText = rdis.Text;
+				rline.pBytes = rdis.Bytes;
+			}
+			rline.TextLen = static_cast<uint8_t>(strnlen(rline.pText, DisCache::TEXTLEN));
+			rline.BytesLen = static_cast<uint8_t>(strnlen(rline.pBytes, DisCache::BYTESLEN));
+			rline.pLabel = Labels::Find(rline.Address);
+			rline.LabelLen = rline.pLabel ? static_cast<uint8_t>(strnlen(rline.pLabel, LABELLINELEN - 1)) : 0;
+			addr += rline.Size;
+		}
+		EndAddr = static_cast<uint16_t>(addr);
+		OrderedEnd = (Ordered == NumLines) ? addr : 0x10000;
 
-		EndAddr = DisAssembler::DisAssemble(input);
-		SetAddressView();						//Now calculate address for each line
 		IPCursor = AddressToIndex(IPAddress);
 	}
 
 	//----------------------------------------------------------------
-	///Process new memory data from response
-	bool FromResponse( const Response &arResponse )
+	///Memory in the range changed, ask for it again if shown
+	void Invalidate( uint16_t aStart, uint16_t aEnd )
 	{
-		bool bres;
-		//Only process responses we specifically asked for
-		if (bres = arResponse.QID() == pCommand->QID(); bres) {
-			uint16_t size = arResponse.Get16(0);
-
-			//TODO: Should this just fail if it's wrong?
-			if (size > ASSEMBLYBLOCKSIZE) { size = ASSEMBLYBLOCKSIZE; }
-
-			//Copy data from response, skipping size
-			memcpy_s(Data, ASSEMBLYBLOCKSIZE, arResponse.QBody() + 2, size);
-
-			UpdateDisView();						//Update Disassembly view
-
-			//If we want continuous updates and VICE is running
-			if ((Continuous) && (Monitor::ViceState() == VICESTATE::RUNNING)) {
-				RequestMemory();
-			}
+		if ((Address != 0xFFFF) && (aStart <= EndAddr) && (aEnd >= Address)) {
+			RequestMemory();
 		}
-		return bres;
 	}
 
 	//----------------------------------------------------------------
-	///Send command for memory refresh
+	///Ask VICE again for the memory shown
 	void RequestMemory(  )
 	{
 		if (Address != 0xFFFF) {
-			pCommand->Reset();
-			pCommand->SetCommand(COMMAND::MEMORY_GET);
-
-			pCommand->Add(0_u8);				//No side effects
-			auto loc = QAddress();
-			pCommand->Add(loc);					//Start Address
-			auto end = loc + ASSEMBLYBLOCKSIZE - 1;
-			pCommand->Add(end);					//End Address
-			pCommand->Add(0_u8);				//Main Memory
-			pCommand->Add(QBank());
-			Monitor::Send(pCommand);			//Send the command
+			Shadow::Invalidate(Address, QEnd(), Space);
+			Show();
 		}
 	}
 
 private:
 	Labels::LabelCombo LabelFilter;				//Filter for the label combo box
-	CommandPtr pCommand;						//Command object used to update this view
-	const OpCode *OpCodes[ASSEMBLYLINES];		//Pointers to the OpCodes for each line
-	uint16_t Addresses[ASSEMBLYLINES];			//Address for each line of disassembly
-	uint8_t Data[ASSEMBLYBLOCKSIZE];			//Memory do disassemble
-	char AddressView[ASSEMBLYLINES * ADDRLINELEN];	//16 bit address plus null terminator
-	char DisView[CODEVIEWSIZE + 1];				//+ 1 for null terminator
-	char LabelView[LABELVIEWSIZE + 1];			//View for labels on addresses
-	char ByteView[BYTEVIEWSIZE + 1];			//View of bytes for opcodes
+	CommandPtr pCommand;						//Command object used to send edits
+	std::vector<Line> Lines;					//Lines shown, NumLines once disassembled
+	std::vector<DataText> DataLines;			//Text of lines shown as data
+	uint32_t NumLines = DEFLINES;				//Number of lines the window fits
+	uint32_t Ordered = 0;						//Lines before any that wrap past $ffff
+	uint32_t OrderedEnd = 0;					//Address following the last ordered line
 	char AssText[CODELINELEN];
-	float Cursor = ASSEMBLYLINES / 2.0f;		//Cursor position for Code edit
+	char ID[8] = "Code";						//View Identifier string, the number is added for views after 0
+	uint8_t IDNum = 0;							//ID value as a number
+	float Cursor = DEFLINES / 2.0f;				//Cursor position for Code edit
 	float IPCursor = 0.0f;						//Cursor for the instruction pointer
-	uint32_t ID = 0;							//Command ID for memory get commands
+	uint32_t Stamp = 0;							//Shadow stamp of the memory shown
+	uint32_t LabelStamp = 0;					//Labels stamp of the disassembly shown
+	uint32_t RegionStamp = 0;					//Regions stamp of the disassembly shown
 	uint16_t IPAddress = 0xffff;				//Address of instruction pointer
 	uint16_t Address = 0xffff;					//c64 memory address
 	uint16_t EndAddr = 0xffff;					//End address for disassembly
-	uint16_t Bank = 0;							//c64 memory bank
+	Banks::Space Space = Banks::MAIN;			//Memspace and bank shown
 	bool NewAddress = true;						//New Address set, need address view refresh
+	bool Enabled = false;						//Display enabled, always for view 0
 	bool Continuous = false;					//When true will continuously ask for new data while Vice is running
-	bool FollowIP = true;						//Follow intruction pointer
+	bool FollowIP = false;						//Follow intruction pointer, view 0 by default
 	bool InputEnabled = false;					//Indicate if can edit memory
 	bool Editing = false;						//Indicate if editing disassembly
 
+	//----------------------------------------------------------------
+	///Get last address the view may need to disassemble. Data lines can
+	/// hold more bytes than an instruction
+	uint16_t QEnd(  ) const
+	{ return static_cast<uint16_t>(std::min<uint32_t>(Address + (NumLines * std::max<uint32_t>(Regions::LINEMAX, 3)) - 1, 0xffff)); }
+
+	//----------------------------------------------------------------
+	///Get the line at an address given the size of the instruction there.
+	/// Regions only cover the computer, so other memory is all code
+	Regions::Span QSpan( uint16_t aAddress, uint32_t aCodeSize ) const
+	{
+		return (Space == Banks::MAIN) ? Regions::QLine(aAddress, aCodeSize)
+			: Regions::Span{ aAddress, aCodeSize, Regions::TYPE::UNKNOWN };
+	}
+
+	//----------------------------------------------------------------
+	///Write the text of a data line of aSize bytes from an address
+	void FormatData( DataText &arData, uint16_t aAddress, uint32_t aSize, Regions::TYPE aeType ) const
+	{
+		const uint8_t *pimage = Shadow::QImage(Space);
+		auto byte = [&]( uint32_t aIndex ) { return pimage[static_cast<uint16_t>(aAddress + aIndex)]; };
+
+		//Show the first bytes like an instruction's
+		char *pbytes = arData.Bytes;
+		for ( uint32_t i = 0; i < std::min<uint32_t>(aSize, 3); ++i) {
+			Numbers::ToHex(pbytes, byte(i));
+			pbytes[2] = ' ';
+			pbytes += 3;
+		}
+		pbytes[-1] = 0;
+
+		char *ptext = arData.Text;
+		constexpr size_t size = sizeof(arData.Text);
+		if ((aeType == Regions::TYPE::WORDS) && (aSize == 2)) {
+			const uint16_t value = byte(0) | (byte(1) << 8);
+			if (const char *plabel = Labels::Find(value); plabel) {
+				snprintf(ptext, size, ".WORD %s", plabel);
+			}
+			else {
+				snprintf(ptext, size, ".WORD $%04X", value);
+			}
+		}
+		else if (aeType == Regions::TYPE::TEXT) {
+			int32_t len = snprintf(ptext, size, ".TEXT \"");
+			for ( uint32_t i = 0; (i < aSize) && ((len + 2u) < size); ++i) {
+				//Shifted letters show as capitals too
+				const uint8_t c = byte(i);
+				ptext[len++] = ((c >= 0x20) && (c <= 0x5f)) ? static_cast<char>(c)
+					: ((c >= 0xc1) && (c <= 0xda)) ? static_cast<char>(c - 0x80) : '.';
+			}
+			ptext[len++] = '"';
+			ptext[len] = 0;
+		}
+		else {
+			int32_t len = snprintf(ptext, size, ".BYTE ");
+			for ( uint32_t i = 0; (i < aSize) && (static_cast<size_t>(len) < size); ++i) {
+				len += snprintf(ptext + len, size - len, i ? ",$%02X" : "$%02X", byte(i));
+			}
+		}
+	}
+
+	//----------------------------------------------------------------
+	///Right click marks from the line clicked to the end of its region
+	/// as code or data
+	void DisplayRegionMenu(  )
+	{
+		if (Space != Banks::MAIN) {
+			return;								//Regions only cover the computer
+		}
+
+		if (ImGui::IsWindowHovered() && ImGui::IsMouseClicked(ImGuiMouseButton_Right)) {
+			const float y = (ImGui::GetMousePos().y - ImGui::GetWindowPos().y) / ImGui::GetFontSize();
+			if ((y >= 0.0f) && (y < Lines.size())) {
+				Cursor = floor(y);
+			}
+		}
+
+		if (ImGui::BeginPopupContextWindow("##Regions")) {
+			const uint16_t addr = IndexToAddress(Cursor);
+			const Regions::Run run = Regions::QMap().QRun(addr);
+			ImGui::Text("%04x-%04x %s", addr, run.End, Regions::QName(run.Type));
+			ImGui::Separator();
+			for ( uint32_t i = static_cast<uint32_t>(Regions::TYPE::CODE); i < static_cast<uint32_t>(Regions::TYPE::COUNT); ++i) {
+				const auto etype = static_cast<Regions::TYPE>(i);
+				if (ImGui::MenuItem(Regions::QName(etype), nullptr, etype == run.Type)) {
+					Regions::Set(addr, run.End, etype);
+				}
+			}
+			ImGui::Separator();
+			if (ImGui::MenuItem("Unmark")) {
+				Regions::Set(run.Start, run.End, Regions::TYPE::UNKNOWN);
+			}
+			ImGui::EndPopup();
+		}
+	}
+
+	//----------------------------------------------------------------
+	///Set number of lines shown
+	void SetLines( uint32_t aLines )
+	{
+		aLines = std::max(aLines, MINLINES);
+		if (aLines != NumLines) {
+			NumLines = aLines;
+			Cursor = std::min(Cursor, NumLines - 1.0f);
+			Show();
+		}
+	}
+
+	//----------------------------------------------------------------
+	///Fetch any memory we don't have for the address shown and
+	/// disassemble what we have
+	void Show(  )
+	{
+		if (Address != 0xFFFF) {
+			Shadow::Fetch(Address, QEnd(), Space);
+			UpdateDisView();
+		}
+	}
+
+	//----------------------------------------------------------------
+	///Redo the disassembly if the memory shown or the labels changed.
+	/// While running and continuous, ask for new memory each time the
+	/// last request completed
+	void Update(  )
+	{
+		if (Address == 0xFFFF) return;
+
+		const uint16_t end = QEnd();
+		if (Continuous && (Monitor::ViceState() == VICESTATE::RUNNING) && Shadow::QValid(Address, end, Space)) {
+			Shadow::Invalidate(Address, end, Space);
+		}
+		Shadow::Fetch(Address, end, Space);
+
+		if (auto stamp = Shadow::QStamp(Address, end, Space); (stamp != Stamp) || (Labels::QStamp() != LabelStamp)
+			|| (Regions::QStamp() != RegionStamp)) {
+			Stamp = stamp;
+			LabelStamp = Labels::QStamp();
+			RegionStamp = Regions::QStamp();
+			UpdateDisView();
+		}
+	}
+
 	//----------------------------------------------------------------
 	///Move the cursor in the given direction and adjust visible address if necessary
 	void MoveCursor( float aDirection )
 	{
-		//Use 32 bit math in this functio to avoid overrun
+		//Scroll by whole instructions so lines stay on instruction boundaries
 		Cursor += aDirection;
 		if (Cursor < 0.0f) {
 			auto adj = static_cast<uint32_t>(-Cursor);
-			uint32_t newAddr = QAddress();
-			newAddr = adj <= newAddr ? newAddr - adj : 0u;
-			SetAddress(static_cast<uint16_t>(newAddr));
+			SetAddress(Boundaries::QPrev(QAddress(), adj, Space));
 			Cursor = 0.0f;
 		}
-		else if (Cursor >= ASSEMBLYLINES) {
-			auto adj = static_cast<uint32_t>(Cursor - (ASSEMBLYLINES - 1.0f));
-			auto newAddr = QAddress() + adj;
-			if (newAddr >= 0x10000) {
-				newAddr = 0xFFFF;
+		else if (Cursor >= NumLines) {
+			auto adj = static_cast<uint32_t>(Cursor - (NumLines - 1.0f));
+			//Use 32 bit math to stop at the end of memory
+			uint32_t newAddr = QAddress();
+			for ( ; adj && (newAddr < 0xffff); --adj) {
+				const auto addr = static_cast<uint16_t>(newAddr);
+				const Regions::Span span = QSpan(addr, DisCache::Get(addr, Space).QSize());
+				newAddr = span.Start + span.Length;
 			}
-			SetAddress(static_cast<uint16_t>(newAddr));
-			Cursor = ASSEMBLYLINES - 1.0f;
+			SetAddress(static_cast<uint16_t>(std::min<uint32_t>(newAddr, 0xffff)));
+			Cursor = NumLines - 1.0f;
 		}
 	}
 
@@ -451,6 +688,7 @@ private:
 		//NOTE: Can't use IsItemFocused because text doesn't get focus, but the frame does
 		if (ImGui::IsWindowFocused())
 		{
+			KeyView = IDNum;					//Function keys go to the last view focused
 			if (!Editing && ImGui::IsKeyPressed(ImGuiKey_Enter)) {
 				StartAssembly();
 			}
@@ -461,10 +699,10 @@ private:
 				MoveCursor(1.0f);
 			}
 			else if (ImGui::IsKeyPressed(ImGuiKey_PageUp)) {
-				MoveCursor(-static_cast<float>(ASSEMBLYLINES));
+				MoveCursor(-static_cast<float>(NumLines));
 			}
 			else if (ImGui::IsKeyPressed(ImGuiKey_PageDown)) {
-				MoveCursor(ASSEMBLYLINES);
+				MoveCursor(static_cast<float>(NumLines));
 			}
 			//Handle mouse wheel scrolling
 			else {
@@ -481,6 +719,8 @@ private:
 			}
 		}
 
+		if (KeyView != IDNum) return;			//Only one view steps and sets breakpoints
+
 		//Run
 		if (ImGui::IsKeyPressed(ImGuiKey_F5)) {
 			Monitor::Resume();
@@ -529,65 +769,153 @@ private:
 	}
 
 	//----------------------------------------------------------------
-	///Start assembly input
-	void StartAssembly(  )
+	///Shade lines holding self modifying code starting at the given position
+	void DisplaySmc( ImVec2 aPos )
 	{
-		if (Cursor >= 0.0f) {
-			uint32_t line = 0;
-			const char *pdis = DisView;
-			auto cursor = static_cast<uint32_t>(Cursor);
-			if (cursor == 0) {
-				Editing = true;
+		const ImVec2 origin = ImGui::GetWindowPos();
+		const float fs = ImGui::GetFontSize();
+		ImDrawList *pdraw = ImGui::GetWindowDrawList();
+		for ( uint32_t i = 0; i < Lines.size(); ++i) {
+			const uint16_t start = Lines[i].Address;
+			const auto end = static_cast<uint16_t>(start + std::max<uint32_t>(Lines[i].Size, 1) - 1);
+			if (Smc::QSite(start, end)) {
+				const ImVec2 ul(origin.x + aPos.x, origin.y + aPos.y + (fs * i));
+				pdraw->AddRectFilled(ul, ImVec2(ul.x + ImGui::GetWindowWidth(), ul.y + fs), IM_COL32(255, 128, 0, 60));
 			}
-			else {
-				for ( uint32_t i = 0; i < sizeof(DisView); ++i) {
-					auto c = *pdis++;
-					if (c == 0) {
-						break;
-					}
-					else if (c == '\n') {
-						if (++line == cursor) {
-							Editing = true;
-							break;
-						}
-					}
-				}
+		}
+	}
+
+	//----------------------------------------------------------------
+	///Draw a rule above lines starting a basic block, stronger for
+	/// subroutines
+	void DisplayFlow( ImVec2 aPos )
+	{
+		if (Space != Banks::MAIN) {
+			return;								//Flow only analyses the computer
+		}
+
+		const ImVec2 origin = ImGui::GetWindowPos();
+		const float fs = ImGui::GetFontSize();
+		ImDrawList *pdraw = ImGui::GetWindowDrawList();
+		for ( uint32_t i = 1; i < Lines.size(); ++i) {
+			const Flow::Block *pblock = Flow::QBlock(Lines[i].Address);
+			if (pblock && (pblock->Start == Lines[i].Address)) {
+				const bool bsub = (pblock->Flags & Flow::SUBROUTINE) != 0;
+				const ImVec2 ul(origin.x + aPos.x, origin.y + aPos.y + (fs * i));
+				pdraw->AddLine(ul, ImVec2(ul.x + ImGui::GetWindowWidth(), ul.y)
+					, bsub ? IM_COL32(255, 200, 0, 160) : IM_COL32(128, 128, 128, 100));
 			}
-			if (Editing) {
-				char c = 1;
-				for ( uint32_t i = 0; (c != 0) && (i < sizeof(AssText)); ++i) {
-					c = pdis[i];
-					if (c == '\n') {
-						c = 0;
-					}
-					AssText[i] = c;
+		}
+	}
+
+	//----------------------------------------------------------------
+	///Right align cycles for each line, branches as not taken/taken and
+	/// reads that may cross a page as a range. Block starts also show the
+	/// block total and loop heads the cycles per iteration
+	void DisplayCycles( ImVec2 aPos )
+	{
+		if (Space != Banks::MAIN) {
+			return;								//Timing only reads the computer
+		}
+
+		const ImVec2 origin = ImGui::GetWindowPos();
+		const float fs = ImGui::GetFontSize();
+		const float right = origin.x + ImGui::GetWindowWidth() - (fs * 0.5f);
+		ImDrawList *pdraw = ImGui::GetWindowDrawList();
+		char text[0x20];
+
+		//Draw text ending at x, return where it starts
+		auto draw = [&]( float aX, float aY, ImU32 aColor ) {
+			aX -= ImGui::CalcTextSize(text).x;
+			pdraw->AddText(ImVec2(aX, aY), aColor, text);
+			return aX - fs;
+		};
+
+		for ( uint32_t i = 0; i < Lines.size(); ++i) {
+			if (!Lines[i].pOpCode) {
+				continue;						//Data
+			}
+			const uint16_t addr = Lines[i].Address;
+			const float y = origin.y + aPos.y + (fs * i);
+			const Timing::Cost cost = Timing::QInstruction(addr);
+			const char *pformat = (cost.Min == cost.Max) ? "%u"
+				: (Lines[i].pOpCode->eMode == ADDRESS_MODE::RELATIVE) ? "%u/%u" : "%u-%u";
+			snprintf(text, sizeof(text), pformat, cost.Min, cost.Max);
+			float x = draw(right, y, IM_COL32(160, 160, 160, 200));
+
+			if (Flow::QBlockStart(addr)) {
+				const Timing::Cost block = Timing::QBlock(addr);
+				snprintf(text, sizeof(text), (block.Min == block.Max) ? "[%u]" : "[%u-%u]", block.Min, block.Max);
+				x = draw(x, y, IM_COL32(100, 160, 220, 220));
+				if (const Timing::Loop *ploop = Timing::QLoop(addr); ploop) {
+					const Timing::Cost &riter = ploop->Iteration;
+					snprintf(text, sizeof(text), (riter.Min == riter.Max) ? "loop %u" : "loop %u-%u", riter.Min, riter.Max);
+					draw(x, y, IM_COL32(255, 200, 0, 220));
 				}
 			}
 		}
 	}
 
+	//----------------------------------------------------------------
+	///List references to the line under the mouse, including the
+	/// callers of a subroutine
+	void DisplayXrefs( ImVec2 aPos )
+	{
+		if ((Space != Banks::MAIN) || !ImGui::IsWindowHovered()) {
+			return;								//Xref only indexes the computer
+		}
+
+		const ImVec2 origin = ImGui::GetWindowPos();
+		const float fs = ImGui::GetFontSize();
+		for ( uint32_t i = 0; i < Lines.size(); ++i) {
+			const ImVec2 ul(origin.x + aPos.x, origin.y + aPos.y + (fs * i));
+			if (ImGui::IsMouseHoveringRect(ul, ImVec2(ul.x + ImGui::GetWindowWidth(), ul.y + fs))) {
+				Xref::Tooltip(Lines[i].Address);
+				break;
+			}
+		}
+	}
+
+	//----------------------------------------------------------------
+	///Start assembly input with the text of the line under the cursor
+	void StartAssembly(  )
+	{
+		if (const auto cursor = static_cast<uint32_t>(Cursor); (Cursor >= 0.0f) && (cursor < Lines.size())) {
+			const Line &rline = Lines[cursor];
+			const uint32_t len = std::min<uint32_t>(rline.TextLen, sizeof(AssText) - 1);
+			memcpy(AssText, rline.pText, len);
+			AssText[len] = 0;
+			Editing = true;
+		}
+	}
+
 	//----------------------------------------------------------------
 	///Assemble the entry
 	void AssembleEntry(  )
 	{
-		Assembler::Assemble as2(AssText, sizeof(AssText), Address);
-		if (as2.QGood()) {
-			auto cursor = static_cast<uint32_t>(Cursor);
-			auto addr = static_cast<uint16_t>(Addresses[cursor] - Address);
-			auto pdata = &Data[addr];
-			//Copy results to the destination
-			pdata[0] = as2.OP;
-			if (as2.Len > 1) {
-				pdata[1] = as2.B0;
-				if (as2.Len > 2) {
-					pdata[2] = as2.B1;
- 				}
-			}
-			//Send memory to VICE
-			//If new size < old size, pad with NOP.
-			//If new size > old size pad next entry with nop
-			ApplyChange(addr);
-//			UpdateDisView();					//Redo DisView
+		const auto cursor = static_cast<uint32_t>(Cursor);
+		if (cursor < Lines.size()) {
+			const uint16_t addr = Lines[cursor].Address;
+			Assembler::Assemble as2(AssText, sizeof(AssText), addr);
+			if (as2.QGood()) {
+				//Start from the bytes there so a shorter op leaves the rest
+				const uint8_t *pimage = Shadow::QImage(Space);
+				uint8_t data[3] = {
+					as2.OP,
+					pimage[static_cast<uint16_t>(addr + 1)],
+					pimage[static_cast<uint16_t>(addr + 2)]
+				};
+				if (as2.Len > 1) {
+					data[1] = as2.B0;
+					if (as2.Len > 2) {
+						data[2] = as2.B1;
+					}
+				}
+				//Send memory to VICE
+				//If new size < old size, pad with NOP.
+				//If new size > old size pad next entry with nop
+				ApplyChange(addr, data);
+			}
 		}
 
 		AssText[0] = 0;
@@ -595,83 +923,51 @@ private:
 
 	//----------------------------------------------------------------
 	///Convert line index into address, 0 if not in range
-	uint16_t IndexToAddress( float aIndex )
+	uint16_t IndexToAddress( float aIndex ) const
 	{
 		auto i = static_cast<int32_t>(aIndex);
-		return ((i >= 0) && (i < ASSEMBLYLINES))
-		? Addresses[i]
+		return ((i >= 0) && (i < static_cast<int32_t>(Lines.size())))
+		? Lines[i].Address
 		: 0;
 	}
 
 	//----------------------------------------------------------------
 	///Convert address into line index, -1.0f if not in range
 	/// Uses float as this value is used to adjust Imgui cursor pos
-	/// which is floating point.
-	float AddressToIndex( uint16_t aAddress )
+	/// which is floating point. Lines are in address order up to any
+	/// that wrap past $ffff, so only those are searched.
+	float AddressToIndex( uint16_t aAddress ) const
 	{
 		int32_t index = -1;
-		//If address is in range of visible memory
-		if (aAddress >= Addresses[0] && (aAddress < Addresses[ASSEMBLYLINES - 1])) {
-			for ( uint32_t i = 1; i < ASSEMBLYLINES; ++i) {
-				if (aAddress < Addresses[i] ) {
-					index = i - 1;
-					break;
-				}
-			}
+		if (Ordered && (aAddress >= Lines[0].Address) && (aAddress < OrderedEnd)) {
+			const auto end = Lines.begin() + Ordered;
+			const auto it = std::upper_bound(Lines.begin(), end, aAddress, []( uint16_t aAddr, const Line &arLine ) {
+				return aAddr < arLine.Address;
+			});
+			index = static_cast<int32_t>(it - Lines.begin()) - 1;
 		}
 		return static_cast<float>(index);
 	}
 
-	//----------------------------------------------------------------
-	///Fill address array with address for each line and print to AddressView
-	/// Also fill the label view if label found
-	void SetAddressView(  )
-	{
-		uint16_t curAddr = Address;
-
-		char *pdest = AddressView;
-		char *plabels = LabelView;
-
-		//Loop for number of lines in disassembly view
-		for ( uint32_t i = 0; i < ASSEMBLYLINES; ++i) {
-			Addresses[i] = curAddr;
-			Numbers::ToHex(pdest, curAddr);
-			pdest[4] = '\n';
-			pdest += 5;
-
-			//Now add a label for the address
-			if (const char *pl = Labels::Find(curAddr); pl) {
-				for ( uint32_t j = 0; j < LABELLINELEN - 1; ++j) {
-					char c = *pl++;
-					if (c == 0) break;			//Null terminator
-					*plabels++ = c;
-				}
-			}
-			*plabels++ = '\n';					//Next line
-			//TODO: Ensure this isn't a nullptr? Shouldn't have to since it should at least be filled with bad.
-			curAddr += OpCodes[i]->QSize();		//Adjust by number of bytes the opcode uses
-		}
-		*(plabels - 1) = 0;						//Last /n is a null terminator
-		*(pdest - 1) = 0;
-	}
-
 	//----------------------------------------------------------------
 	///Send change to memory buffer to VICE
-	void ApplyChange( uint16_t aIndex )
+	void ApplyChange( uint16_t aAddress, const uint8_t *apData )
 	{
 		pCommand->Reset();
 		pCommand->SetCommand(COMMAND::MEMORY_SET);
 
 		pCommand->Add(1_u8);					//Side effects
-		uint16_t loc = Address + aIndex;
-		pCommand->Add(loc);						//Start Address
-		loc += 3;
-		pCommand->Add(loc);						//End Address
-		pCommand->Add(0_u16);					//Main Memory, Bank 0
-		pCommand->Add(Data[aIndex++]);			//Add byte 0
-		pCommand->Add(Data[aIndex++]);			//Add byte 1
-		pCommand->Add(Data[aIndex]);			//Add byte 2
+		const uint16_t start = aAddress;
+		pCommand->Add(start);					//Start Address
+		pCommand->Add(static_cast<uint16_t>(start + 2));	//End Address
+		pCommand->Add(Banks::QMemspace(Space));
+		pCommand->Add(Banks::QBank(Space));
+		pCommand->Add(apData[0]);				//Add byte 0
+		pCommand->Add(apData[1]);				//Add byte 1
+		pCommand->Add(apData[2]);				//Add byte 2
 		Monitor::Send(pCommand);				//Send the command
+
+		Shadow::Store(start, apData, 3, Space);	//Shows in the disassembly straight away
 	}
 
 	//----------------------------------------------------------------
@@ -682,9 +978,11 @@ private:
 	{
 		if (Monitor::ViceState() == VICESTATE::STOPPED) {
 			if (abStepOut) {
+				Footprint::Run();				//Runs the rest of the subroutine
 				Monitor::Send(StepOutCommand);
 			}
 			else {
+				Footprint::Step(abStepOver);
 				StepCommand->Reset();
 				StepCommand->Add(abStepOver ? 1_u8 : 0_u8);
 				StepCommand->Add(01_u16);		//1 instruction
@@ -696,76 +994,127 @@ private:
 
 using CodeViewPtr = std::unique_ptr<CodeView>;
 
-CodeViewPtr pView(new CodeView());
+//----------------------------------------------------------------
+///Array of views
+CodeViewPtr Views[NUMVIEWS] =
+{
+	CodeViewPtr(new CodeView(0)),
+	CodeViewPtr(new CodeView(1)),
+	CodeViewPtr(new CodeView(2)),
+	CodeViewPtr(new CodeView(3))
+};
 
 //----------------------------------------------------------------
 void ToJson( nlohmann::json &arData )
 {
-	if (pView) {
-		arData["Code"] = {
-			{"Address", pView->QAddress()},
-			{"FollowIP", pView->QFollowIP()}
-		};
+	//View 0 keeps the key it always had
+	char key[] = "Code0";
+	for ( uint32_t i = 0; i < NUMVIEWS; ++i) {
+		if (Views[i]) {
+			arData[i ? key : "Code"] = {
+				{"Address", Views[i]->QAddress()},
+				{"Space", Views[i]->QSpace()},
+				{"FollowIP", Views[i]->QFollowIP()},
+				{"On", Views[i]->QEnabled()}
+			};
+		}
+		++key[4];								//Increment number in key
 	}
 }
 
 //----------------------------------------------------------------
 void FromJson( nlohmann::json &arData )
 {
-	if (pView) {
-		auto obj = arData["Code"];
-		if (!obj.is_null()) {
-			pView->SetFollowIP(obj["FollowIP"]);
-			pView->SetAddress(obj["Address"]);
+	char key[] = "Code0";
+	for ( uint32_t i = 0; i < NUMVIEWS; ++i) {
+		if (Views[i]) {
+			auto obj = arData[i ? key : "Code"];
+			if (!obj.is_null()) {
+				if (obj["Space"].is_number()) {
+					Views[i]->SetSpace(obj["Space"]);
+				}
+				Views[i]->SetFollowIP(obj["FollowIP"]);
+				Views[i]->SetAddress(obj["Address"]);
+				if (obj["On"].is_boolean()) {
+					Views[i]->SetEnabled(obj["On"]);
+				}
+			}
 		}
+		++key[4];								//Increment number in key
 	}
 }
 
 //----------------------------------------------------------------
-void FromResponse( const Response &arResponse )
+void Refresh(  )
 {
-	if (pView) {
-		pView->FromResponse(arResponse);
+	for ( const auto &view : Views ) {
+		if (view->QEnabled()) {
+			view->RequestMemory();
+		}
 	}
 }
 
 //----------------------------------------------------------------
-void Refresh(  )
+void UpdateDisView(  )
 {
-	if (pView) {
-		pView->RequestMemory();
+	for ( const auto &view : Views ) {
+		view->UpdateDisView();
 	}
 }
 
 //----------------------------------------------------------------
-void UpdateDisView(  )
+void DisplayOn( uint32_t aView )
 {
-	if (pView) {
-		pView->UpdateDisView();
+	if (aView < NUMVIEWS) {
+		//A new view starts where view 0 is
+		if (Views[aView]->QAddress() == 0xFFFF) {
+			Views[aView]->SetSpace(Views[0]->QSpace());
+			Views[aView]->SetAddress(Views[0]->QAddress());
+		}
+		Views[aView]->SetEnabled(true);
 	}
 }
 
 //----------------------------------------------------------------
 void SetAddress( uint16_t aAddress )
 {
-	if (pView) {
-		pView->SetAddress(aAddress);
+	Views[0]->SetAddress(aAddress);
+}
+
+//----------------------------------------------------------------
+void SetAddress( uint32_t aView, uint16_t aAddress )
+{
+	if (aView < NUMVIEWS) {
+		Views[aView]->SetFollowIP(false);		//Pinned to the address
+		Views[aView]->SetAddress(aAddress);
+		DisplayOn(aView);
+	}
+}
+
+//----------------------------------------------------------------
+void Invalidate( uint16_t aStart, uint16_t aEnd )
+{
+	for ( const auto &view : Views ) {
+		if (view->QEnabled()) {
+			view->Invalidate(aStart, aEnd);
+		}
 	}
 }
 
 //----------------------------------------------------------------
 void NewIP( uint16_t aAddress )
 {
-	if (pView) {
-		pView->SetIP(aAddress);
+	Boundaries::AddEntry(aAddress);
+	for ( const auto &view : Views ) {
+		view->SetIP(aAddress);
 	}
 }
 
 //----------------------------------------------------------------
 void Display( bool abInputEnabled )
 {
-	if (pView) {
-		pView->Display(abInputEnabled);
+	for ( const auto &view : Views ) {
+		view->Display(abInputEnabled);
 	}
 }
 
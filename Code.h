@@ -4,11 +4,11 @@
 #include "types.h"
 #include "json/json.hpp"
 
-class Response;
-
 namespace Code
 {
 
+constexpr uint32_t NUMVIEWS = 4;				//View 0 is always open, the rest on demand
+
 //----------------------------------------------------------------
 ///Save data to Json
 void ToJson( nlohmann::json &arData );
@@ -17,9 +17,6 @@ void ToJson( nlohmann::json &arData );
 ///Load data from Json
 void FromJson( nlohmann::json &arData );
 
-//----------------------------------------------------------------
-void FromResponse( const Response &arResponse );
-
 //----------------------------------------------------------------
 ///Refresh data
 void Refresh(  );
@@ -29,13 +26,21 @@ void Refresh(  );
 void UpdateDisView(  );
 
 //----------------------------------------------------------------
-///Enable window
-void Enable(  );
+///Enable the view indicated by given index
+void DisplayOn( uint32_t aView );
 
 //----------------------------------------------------------------
-///Set new address for window
+///Set new address for view 0
 void SetAddress( uint16_t aAddress );
 
+//----------------------------------------------------------------
+///Enable the view indicated by given index and pin it to the address
+void SetAddress( uint32_t aView, uint16_t aAddress );
+
+//----------------------------------------------------------------
+///Memory in the range changed, disassemble it again where shown
+void Invalidate( uint16_t aStart, uint16_t aEnd );
+
 //----------------------------------------------------------------
 ///Set new address if Following Instruction Pointer
 void NewIP( uint16_t aAddress );
@@ -30,6 +30,7 @@
 //----------------------------------------------------------------------
 
 #include "Command.h"
+#include <algorithm>
 #include <iostream>								// For placement new
 
 // Start ID's after CommandIDs so they can be used as the CommandRegisty key without conflict
@@ -48,7 +49,8 @@ const CommandPtr Command::CheckpointListCommand(new Command(COMMAND::CHECKPOINT_
 //----------------------------------------------------------------
 CommandPtr Command::Create( COMMAND aCmd, uint32_t aSize, uint32_t aID  )
 {
-	uint8_t *pcmd = new uint8_t[sizeof(Command) + aSize - sizeof(MaxSize) - DEFBODYLEN];
+	//Room for the larger of aSize and the default body, as SetMaxSize allows
+	uint8_t *pcmd = new uint8_t[sizeof(Command) - DEFBODYLEN + std::max(aSize, DEFBODYLEN)];
 	CommandPtr pcommand = CommandPtr(new (pcmd) Command(aCmd, aID));
 	pcommand->SetMaxSize(aSize);
 	return pcommand;
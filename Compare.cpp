@@ -0,0 +1,102 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Compare.cpp
+//----------------------------------------------------------------------
+
+#include "Compare.h"
+#include "Simd.h"
+
+namespace Compare
+{
+
+//----------------------------------------------------------------
+uint32_t FindRuns( const uint8_t *apA, const uint8_t *apB, uint32_t aSize
+	, Run *apRuns, uint32_t aMaxRuns, uint32_t &arBytes, uint32_t aGap )
+{
+	uint32_t count = 0;
+	bool open = false;							//apRuns[count] is being built
+	arBytes = 0;
+
+	//Add a differing byte at aPos to the open run or start a new one.
+	// Return false when out of room
+	auto add = [&]( uint32_t aPos ) {
+		if (open) {
+			Run &run = apRuns[count];
+			if (aPos - (run.Start + run.Len) <= aGap) {
+				run.Len = aPos - run.Start + 1;
+				++arBytes;
+				return true;
+			}
+			open = false;
+			++count;
+		}
+		if (count == aMaxRuns) {
+			return false;
+		}
+		apRuns[count] = { aPos, 1 };
+		open = true;
+		++arBytes;
+		return true;
+	};
+
+	uint32_t pos = 0;
+	//Skip equal memory 64 bytes at a time, the common case
+	for ( ; pos + (Simd::LANES * 4) <= aSize; pos += Simd::LANES * 4) {
+		const uint32_t equal = Simd::EqualMask(apA + pos, apB + pos)
+			& Simd::EqualMask(apA + pos + Simd::LANES, apB + pos + Simd::LANES)
+			& Simd::EqualMask(apA + pos + (Simd::LANES * 2), apB + pos + (Simd::LANES * 2))
+			& Simd::EqualMask(apA + pos + (Simd::LANES * 3), apB + pos + (Simd::LANES * 3));
+		if (equal == 0xffff) {
+			continue;
+		}
+
+		//Something differs, find which bytes
+		for ( uint32_t row = 0; row < 4; ++row) {
+			const uint32_t at = pos + (row * Simd::LANES);
+			uint32_t diff = ~Simd::EqualMask(apA + at, apB + at) & 0xffff;
+			while (diff) {
+				if (!add(at + Simd::LowBit(diff))) {
+					return count;
+				}
+				diff &= diff - 1;				//Clear lowest bit
+			}
+		}
+	}
+
+	//Tail that doesn't fill a register
+	for ( ; pos < aSize; ++pos) {
+		if ((apA[pos] != apB[pos]) && !add(pos)) {
+			return count;
+		}
+	}
+
+	return count + open;
+}
+
+}	//namespace Compare
@@ -0,0 +1,56 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Compare.h
+//----------------------------------------------------------------------
+
+#pragma once
+
+#include "types.h"
+
+///Finding where two blocks of memory differ
+namespace Compare
+{
+
+//----------------------------------------------------------------
+///Run of bytes that differ, Start is the offset into the blocks
+struct Run
+{
+	uint32_t Start;
+	uint32_t Len;
+};
+
+//----------------------------------------------------------------
+///Find runs of differing bytes between apA and apB. Runs separated by
+/// no more than aGap equal bytes are merged into one. Fills apRuns with
+/// up to aMaxRuns runs, return number found. arBytes is set to the
+/// number of differing bytes in the runs found
+uint32_t FindRuns( const uint8_t *apA, const uint8_t *apB, uint32_t aSize
+	, Run *apRuns, uint32_t aMaxRuns, uint32_t &arBytes, uint32_t aGap = 0 );
+
+}	//namespace Compare
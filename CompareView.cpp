@@ -0,0 +1,425 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    CompareView.cpp
+//----------------------------------------------------------------------
+
+#include "CompareView.h"
+#include "Banks.h"
+#include "Compare.h"
+#include "Memory.h"
+#include "Monitor.h"
+#include "Numbers.h"
+#include "Shadow.h"
+#include "Snapshots.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <imgui.h>
+
+namespace CompareView
+{
+
+constexpr uint32_t MAXRUNS = 0x1000;			//Maximum differing runs found
+constexpr uint32_t BYTESPERROW = 16;
+constexpr uint32_t CONTEXTROWS = 2;				//Equal rows shown around a run
+constexpr uint32_t MAXROWS = 24;				//Maximum rows shown for a run
+constexpr uint32_t ROWLEN = 6 + (BYTESPERROW * 3);	//"C000: " + "xx " per byte
+constexpr uint32_t IMAGESIZE = 0x10000;
+
+//----------------------------------------------------------------
+enum class SOURCE
+{
+	LIVE,										//Memory in VICE
+	SNAPSHOT,									//Memory in the history ring
+	FILE,										//.prg or raw file on disk
+	COUNT
+};
+
+//----------------------------------------------------------------
+///One side of the compare
+struct Side
+{
+	int32_t Source = 0;							//SOURCE as int for combo box
+	Banks::Space Space = Banks::MAIN;			//Live memspace and bank
+	uint32_t Serial = 0;						//Snapshot serial
+	uint16_t Address = 0;						//c64 address, or offset into raw file
+	char File[256] = "";
+	uint8_t Data[IMAGESIZE];					//Memory compared
+	char Text[(MAXROWS * ROWLEN) + 1];			//Rows of the shown run
+	char Changed[(MAXROWS * ROWLEN) + 1];		//Same rows with only differing bytes
+};
+
+bool Enabled = false;							//Window enabled
+bool Pending = false;							//Waiting for live memory
+uint32_t Length = 0x100;						//Bytes to compare
+uint32_t Gap = 0;								//Runs closer than this are merged
+Side Sides[2];
+Compare::Run Runs[MAXRUNS];
+uint32_t NumRuns = 0;
+uint32_t DiffBytes = 0;
+uint32_t Compared = 0;							//Bytes compared by the last compare
+int32_t Current = -1;							//Run shown
+char Status[128] = "";
+
+//----------------------------------------------------------------
+const char *SourceName( SOURCE aeSource )
+{
+	constexpr const char *names[] = { "Live", "Snapshot", "File" };
+	return aeSource < SOURCE::COUNT ? names[static_cast<uint32_t>(aeSource)] : "?";
+}
+
+//----------------------------------------------------------------
+///Get bytes to compare that fit after the side's address
+uint32_t QLength( const Side &arSide )
+{
+	return std::min<uint32_t>(Length, IMAGESIZE - arSide.Address);
+}
+
+//----------------------------------------------------------------
+///Fill the side's Data from its source. Return number of bytes loaded
+uint32_t Load( Side &arSide )
+{
+	const uint32_t len = QLength(arSide);
+	switch (static_cast<SOURCE>(arSide.Source)) {
+		case SOURCE::LIVE:
+			memcpy_s(arSide.Data, IMAGESIZE, Shadow::QImage(arSide.Space) + arSide.Address, len);
+			return len;
+		case SOURCE::SNAPSHOT:
+			return Snapshots::Get(arSide.Serial, arSide.Address, arSide.Data, len) ? len : 0;
+		case SOURCE::FILE:
+		{
+			std::ifstream strm(arSide.File, std::ios::binary);
+			if (!strm) {
+				return 0;
+			}
+			//A .prg starts with its load address, raw files use Address as an offset
+			uint32_t base = 0;
+			if (std::filesystem::path(arSide.File).extension() == ".prg") {
+				uint8_t load[2] = { 0, 0 };
+				strm.read(reinterpret_cast<char*>(load), 2);
+				base = load[0] | (load[1] << 8);
+				if (arSide.Address < base) {
+					return 0;
+				}
+			}
+			strm.seekg(arSide.Address - base, std::ios::cur);
+			strm.read(reinterpret_cast<char*>(arSide.Data), len);
+			return static_cast<uint32_t>(strm.gcount());
+		}
+		default:
+			return 0;
+	}
+}
+
+//----------------------------------------------------------------
+///Return true if a live side has all its memory
+bool QReady( const Side &arSide )
+{
+	return (static_cast<SOURCE>(arSide.Source) != SOURCE::LIVE)
+		|| Shadow::QValid(arSide.Address, static_cast<uint16_t>(arSide.Address + QLength(arSide) - 1), arSide.Space);
+}
+
+//----------------------------------------------------------------
+///Fill Text and Changed for the rows of the current run
+void BuildRows(  )
+{
+	const auto &run = Runs[Current];
+	const uint32_t first = (run.Start / BYTESPERROW) > CONTEXTROWS ? (run.Start / BYTESPERROW) - CONTEXTROWS : 0;
+	const uint32_t end = std::min<uint32_t>(((run.Start + run.Len - 1) / BYTESPERROW) + CONTEXTROWS + 1
+		, (Compared + BYTESPERROW - 1) / BYTESPERROW);
+	const uint32_t rows = std::min<uint32_t>(end - first, MAXROWS);
+
+	for ( auto &side : Sides ) {
+		char *ptext = side.Text;
+		char *pchanged = side.Changed;
+		const auto &other = (&side == &Sides[0]) ? Sides[1] : Sides[0];
+		for ( uint32_t row = first; row < first + rows; ++row) {
+			const uint32_t offset = row * BYTESPERROW;
+			Numbers::ToHex(ptext, static_cast<uint16_t>(side.Address + offset));
+			ptext[4] = ':';
+			ptext[5] = ' ';
+			memset(pchanged, ' ', 6);
+			const uint32_t count = std::min<uint32_t>(BYTESPERROW, Compared - offset);
+			Numbers::ToHex(ptext + 6, ROWLEN - 5, &side.Data[offset], count);
+			for ( uint32_t i = 0; i < BYTESPERROW; ++i) {
+				char *pt = ptext + 6 + (i * 3);
+				char *pc = pchanged + 6 + (i * 3);
+				if (i >= count) {
+					pt[0] = pt[1] = ' ';
+				}
+				pc[0] = pc[1] = ' ';
+				pc[2] = pt[2] = ' ';
+				if ((i < count) && (side.Data[offset + i] != other.Data[offset + i])) {
+					pc[0] = pt[0];
+					pc[1] = pt[1];
+				}
+			}
+			ptext[ROWLEN - 1] = '\n';
+			pchanged[ROWLEN - 1] = '\n';
+			ptext += ROWLEN;
+			pchanged += ROWLEN;
+		}
+		*ptext = 0;
+		*pchanged = 0;
+	}
+}
+
+//----------------------------------------------------------------
+///Show given run
+void ShowRun( int32_t aRun )
+{
+	if (NumRuns) {
+		Current = std::clamp(aRun, 0, static_cast<int32_t>(NumRuns) - 1);
+		BuildRows();
+	}
+}
+
+//----------------------------------------------------------------
+///Load both sides and find the differences
+void RunCompare(  )
+{
+	Pending = false;
+	const uint32_t lenA = Load(Sides[0]);
+	const uint32_t lenB = Load(Sides[1]);
+	Compared = std::min(lenA, lenB);
+	NumRuns = Compare::FindRuns(Sides[0].Data, Sides[1].Data, Compared, Runs, MAXRUNS, DiffBytes, Gap);
+	Current = -1;
+	if (!Compared) {
+		snprintf(Status, sizeof(Status), "Nothing to compare, A has %u bytes, B has %u", lenA, lenB);
+	}
+	else {
+		snprintf(Status, sizeof(Status), "%u%s runs, %u bytes differ in %u", NumRuns
+			, NumRuns == MAXRUNS ? "+" : "", DiffBytes, Compared);
+		ShowRun(0);
+	}
+}
+
+//----------------------------------------------------------------
+///Request live memory and compare once it's here
+void StartCompare(  )
+{
+	for ( const auto &side : Sides ) {
+		if (static_cast<SOURCE>(side.Source) == SOURCE::LIVE) {
+			const auto end = static_cast<uint16_t>(side.Address + QLength(side) - 1);
+			//While running memory is changing, so take a fresh copy
+			if (Monitor::ViceState() != VICESTATE::STOPPED) {
+				Shadow::Invalidate(side.Address, end, side.Space);
+			}
+			Shadow::Fetch(side.Address, end, side.Space);
+		}
+	}
+	Pending = true;
+	snprintf(Status, sizeof(Status), "Fetching");
+}
+
+//----------------------------------------------------------------
+///Display source inputs for a side
+void DisplaySide( const char *apName, Side &arSide )
+{
+	const float w = ImGui::GetFontSize();
+
+	ImGui::PushID(apName);
+	ImGui::Text(apName);
+	ImGui::SameLine();
+	ImGui::PushItemWidth(w * 5.0f);
+	if (ImGui::BeginCombo("##Source", SourceName(static_cast<SOURCE>(arSide.Source)))) {
+		for ( int32_t i = 0; i < static_cast<int32_t>(SOURCE::COUNT); ++i) {
+			if (ImGui::Selectable(SourceName(static_cast<SOURCE>(i)), i == arSide.Source)) {
+				arSide.Source = i;
+			}
+		}
+		ImGui::EndCombo();
+	}
+	ImGui::PopItemWidth();
+
+	ImGui::SameLine();
+	ImGui::PushItemWidth(w * 3.0f);
+	ImGui::InputScalar("##Addr", ImGuiDataType_U16, &arSide.Address, nullptr, nullptr, "%04x"
+		, ImGuiInputTextFlags_CharsHexadecimal);
+	ImGui::PopItemWidth();
+	ImGui::SameLine();
+
+	switch (static_cast<SOURCE>(arSide.Source)) {
+		case SOURCE::LIVE:
+			Banks::Combo("##Space", arSide.Space);
+			break;
+		case SOURCE::SNAPSHOT:
+		{
+			const uint32_t first = Snapshots::QFirst();
+			const uint32_t last = Snapshots::QEnd() - 1;
+			if (first <= last) {
+				arSide.Serial = std::clamp(arSide.Serial, first, last);
+				ImGui::PushItemWidth(w * 6.0f);
+				ImGui::SliderScalar("##Serial", ImGuiDataType_U32, &arSide.Serial, &first, &last, "%u");
+				ImGui::PopItemWidth();
+			}
+			else {
+				ImGui::Text("No snapshots");
+			}
+			break;
+		}
+		case SOURCE::FILE:
+			ImGui::PushItemWidth(-FLT_MIN);
+			ImGui::InputText("##File", arSide.File, sizeof(arSide.File));
+			ImGui::PopItemWidth();
+			if (ImGui::IsItemHovered()) {
+				ImGui::SetTooltip(".prg files are placed at their load address\nfor others the address is an offset into the file");
+			}
+			break;
+		default:
+			break;
+	}
+	ImGui::PopID();
+}
+
+//----------------------------------------------------------------
+///Draw the rows of one side with differing bytes highlighted
+void DisplayRows( const Side &arSide )
+{
+	auto pos = ImGui::GetCursorPos();
+	ImGui::PushStyleColor(ImGuiCol_Text, IM_COL32(255, 0, 0, 255));
+	ImGui::Text(arSide.Changed);
+	ImGui::PopStyleColor();
+	ImGui::SetCursorPos(pos);					//Draw over in the same position
+	ImGui::PushStyleColor(ImGuiCol_Text, IM_COL32(255, 255, 255, 150));
+	ImGui::Text(arSide.Text);
+	ImGui::PopStyleColor();
+}
+
+//----------------------------------------------------------------
+void ToJson( nlohmann::json &arData )
+{
+	arData["Compare"] = {
+		{"On", Enabled},
+		{"Length", Length},
+		{"Gap", Gap},
+		{"SourceA", Sides[0].Source},
+		{"SpaceA", Sides[0].Space},
+		{"AddressA", Sides[0].Address},
+		{"FileA", Sides[0].File},
+		{"SourceB", Sides[1].Source},
+		{"SpaceB", Sides[1].Space},
+		{"AddressB", Sides[1].Address},
+		{"FileB", Sides[1].File}
+	};
+}
+
+//----------------------------------------------------------------
+void FromJson( nlohmann::json &arData )
+{
+	auto obj = arData["Compare"];
+	if (!obj.is_null()) {
+		Enabled = obj["On"];
+		Length = obj["Length"];
+		Gap = obj["Gap"];
+		for ( uint32_t i = 0; i < 2; ++i) {
+			auto &side = Sides[i];
+			const std::string suffix(1, static_cast<char>('A' + i));
+			side.Source = obj["Source" + suffix];
+			side.Space = obj["Space" + suffix];
+			side.Address = obj["Address" + suffix];
+			std::string file = obj["File" + suffix];
+			snprintf(side.File, sizeof(side.File), "%s", file.c_str());
+		}
+	}
+}
+
+//----------------------------------------------------------------
+void DisplayOn(  )
+{
+	Enabled = true;
+}
+
+//----------------------------------------------------------------
+void Display(  )
+{
+	if (!Enabled) return;						//Early out if view not visible
+
+	if (Pending && QReady(Sides[0]) && QReady(Sides[1])) {
+		RunCompare();
+	}
+
+	ImGui::SetNextWindowSize(ImVec2(780, 500), ImGuiCond_FirstUseEver);
+	ImGui::Begin("Compare", &Enabled);
+
+	const float w = ImGui::GetFontSize();
+
+	DisplaySide("A", Sides[0]);
+	DisplaySide("B", Sides[1]);
+
+	ImGui::Text("Length");
+	ImGui::SameLine();
+	ImGui::PushItemWidth(w * 3.5f);
+	ImGui::InputScalar("##Len", ImGuiDataType_U32, &Length, nullptr, nullptr, "%x", ImGuiInputTextFlags_CharsHexadecimal);
+	Length = std::clamp<uint32_t>(Length, 1, IMAGESIZE);
+	ImGui::SameLine();
+	ImGui::Text("Merge");
+	ImGui::SameLine();
+	ImGui::InputScalar("##Gap", ImGuiDataType_U32, &Gap, nullptr, nullptr, "%u");
+	if (ImGui::IsItemHovered()) {
+		ImGui::SetTooltip("Differences this many equal bytes apart are one run");
+	}
+	ImGui::PopItemWidth();
+	ImGui::SameLine();
+	if (ImGui::Button("Compare")) {
+		StartCompare();
+	}
+	ImGui::SameLine();
+	ImGui::Text(Status);
+
+	//Step through the runs
+	if (Current >= 0) {
+		const auto &run = Runs[Current];
+		if (ImGui::Button("Prev") || (ImGui::IsWindowFocused() && ImGui::IsKeyPressed(ImGuiKey_UpArrow))) {
+			ShowRun(Current - 1);
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Next") || (ImGui::IsWindowFocused() && ImGui::IsKeyPressed(ImGuiKey_DownArrow))) {
+			ShowRun(Current + 1);
+		}
+		ImGui::SameLine();
+		ImGui::Text("Run %d/%u at +%04x, %u bytes", Current + 1, NumRuns, run.Start, run.Len);
+		//Live memory can be looked at in a memory view
+		if (static_cast<SOURCE>(Sides[0].Source) == SOURCE::LIVE) {
+			ImGui::SameLine();
+			if (ImGui::Button("Show A")) {
+				Memory::SetAddress(0, static_cast<uint16_t>(Sides[0].Address + run.Start), Sides[0].Space);
+			}
+		}
+
+		DisplayRows(Sides[0]);
+		ImGui::SameLine(0.0f, w * 2.0f);
+		DisplayRows(Sides[1]);
+	}
+
+	ImGui::End();
+}
+
+}	//namespace CompareView
@@ -29,10 +29,15 @@
 // FILE    DisAssembler.cpp
 //----------------------------------------------------------------------
 
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include "DisAssembler.h"
 #include "Numbers.h"
 #include "Labels.h"
 
+#include "OpCodes.ipp"
+
 namespace DisAssembler
 {
 
@@ -300,15 +305,234 @@ public:
 		}
 
 		//Make sure if we didn't finish to fill out some data
-		const OpCode *pbad = &OpCode::Get(0xff);
+		const OpCode *pbad = &OpCode::Get(OpCode::BADOP);
 		for ( ; i < Lines; ++i) {
 			pOpCodes[i] = pbad;
 		}
 	}
 };
 
+//----------------------------------------------------------------
+///Operand text for an address mode, split around the value
+struct Template
+{
+	const char *pPrefix;						//Text between mnemonic and value
+	const char *pSuffix;						//Text after value
+	uint8_t Size;								//Instruction bytes
+	uint8_t Digits;								//Hex digits of value
+	uint8_t Keep;								//Prefix chars kept when a label replaces the value
+	bool bLabel;								//True if value may be replaced by a label
+};
+
+//----------------------------------------------------------------
+///Indexed by ADDRESS_MODE. Byte values keep the '$' in front of a
+/// label and address values drop it, matching the Parser.
+constexpr Template TemplateA[] =
+{
+	{ "", "", 1, 0, 0, false },					//NONE
+	{ " #$", "", 2, 2, 3, true },				//IMMEDIATE
+	{ " $", "", 2, 2, 2, true },				//ZERO_PAGE
+	{ " $", ",X", 2, 2, 2, true },				//ZERO_PAGE_X
+	{ " $", ",Y", 2, 2, 2, true },				//ZERO_PAGE_Y
+	{ " ($", ",X)", 2, 2, 3, true },			//INDIRECT_X
+	{ " ($", "),Y", 2, 2, 3, true },			//INDIRECT_Y
+	{ " $", "", 2, 4, 2, false },				//RELATIVE
+	{ " $", "", 3, 4, 1, true },				//ABSOLUTE
+	{ " $", ",X", 3, 4, 1, true },				//ABSOLUTE_X
+	{ " $", ",Y", 3, 4, 1, true },				//ABSOLUTE_Y
+	{ " ($", ")", 3, 4, 2, true },				//INDIRECT
+	{ "", "", 1, 0, 0, false },					//ERROR
+};
+
+//----------------------------------------------------------------
+///Everything needed to write one opcode's line, built at compile time
+struct Format
+{
+	char Text[8];								//Mnemonic and operand prefix, eg "LDA ($"
+	char Suffix[4];								//Operand suffix, eg "),Y"
+	uint8_t TextLen;
+	uint8_t SuffixLen;
+	uint8_t Keep;								//Text chars kept when a label replaces the value
+	uint8_t Digits;								//Hex digits of value, 0 if none
+	uint8_t Size;								//Instruction bytes
+	bool bLabel;								//True if value may be replaced by a label
+	bool bRelative;								//True if value is a branch offset
+};
+
+//----------------------------------------------------------------
+constexpr uint8_t Copy( char *apDest, const char *apSource )
+{
+	uint8_t len = 0;
+	while (apSource[len]) {
+		apDest[len] = apSource[len];
+		++len;
+	}
+	return len;
+}
+
+//----------------------------------------------------------------
+constexpr std::array<Format, 0x100> MakeFormats(  )
+{
+	std::array<Format, 0x100> formats{};
+	for ( uint32_t i = 0; i < formats.size(); ++i) {
+		const OpCode &rop = OpCodeA[i];
+		const Template &rtemp = TemplateA[static_cast<uint32_t>(rop.eMode)];
+		Format &rformat = formats[i];
+		rformat.TextLen = Copy(rformat.Text, rop.pName);
+		rformat.TextLen += Copy(rformat.Text + rformat.TextLen, rtemp.pPrefix);
+		rformat.SuffixLen = Copy(rformat.Suffix, rtemp.pSuffix);
+		rformat.Keep = 3 + rtemp.Keep;
+		rformat.Digits = rtemp.Digits;
+		rformat.Size = rtemp.Size;
+		rformat.bLabel = rtemp.bLabel;
+		rformat.bRelative = rop.eMode == ADDRESS_MODE::RELATIVE;
+	}
+	return formats;
+}
+
+constexpr std::array<Format, 0x100> FormatA = MakeFormats();
+
+static_assert(FormatA[0xb1].TextLen == 6 && FormatA[0xb1].Suffix[2] == 'Y');
+static_assert(FormatA[0x6c].Size == 3 && FormatA[0x90].Size == 2 && FormatA[0xea].Size == 1);
+
+constexpr char HexA[] = "0123456789ABCDEF";
+
+//----------------------------------------------------------------
+///Write 2 upper case hex digits without a terminator
+inline char *AddHex( char *apDest, uint8_t aValue )
+{
+	apDest[0] = HexA[aValue >> 4];
+	apDest[1] = HexA[aValue & 0x0f];
+	return apDest + 2;
+}
+
+constexpr uint32_t LABELMAX = 0x70;				//Longest label copied into a line
+
+//----------------------------------------------------------------
+///Append label to line, clipped to LABELMAX
+char *AddLabel( char *apDest, const char *apLabel )
+{
+	const size_t len = std::min<size_t>(strlen(apLabel), LABELMAX);
+	memcpy(apDest, apLabel, len);
+	return apDest + len;
+}
+
+//----------------------------------------------------------------
+///Build one line for the instruction at apSource into apLine
+/// Return the line length including the trailing '\n'
+uint32_t FormatLine( char *apLine, const Format &arFormat, const uint8_t *apSource, uint16_t aAddress )
+{
+	char *pline = apLine;
+	//No operand, copy name and done
+	if (arFormat.Size == 1) {
+		memcpy(pline, arFormat.Text, 4);
+		pline[3] = '\n';
+		return 4;
+	}
+
+	uint16_t value = apSource[1];
+	if (arFormat.Size == 3) {
+		value |= apSource[2] << 8;
+	}
+	else if (arFormat.bRelative) {
+		value = aAddress + 2 + static_cast<int8_t>(value);
+	}
+
+	//Mnemonic and space, then any label on the operand bytes themselves
+	memcpy(pline, arFormat.Text, 4);
+	pline += 4;
+	if (const char *plabel = Labels::Find(aAddress + 1); plabel) {
+		pline = AddLabel(pline, plabel);
+		*pline++ = ':';
+		*pline++ = ' ';
+	}
+
+	//Operand prefix, then the value or its label
+	const char *plabel = arFormat.bLabel ? Labels::Find(value) : nullptr;
+	const uint32_t prefix = (plabel ? arFormat.Keep : arFormat.TextLen) - 4;
+	memcpy(pline, arFormat.Text + 4, 4);
+	pline += prefix;
+	if (plabel) {
+		pline = AddLabel(pline, plabel);
+	}
+	else {
+		if (arFormat.Digits == 4) {
+			pline = AddHex(pline, static_cast<uint8_t>(value >> 8));
+		}
+		pline = AddHex(pline, static_cast<uint8_t>(value));
+	}
+
+	memcpy(pline, arFormat.Suffix, 4);
+	pline += arFormat.SuffixLen;
+	*pline++ = '\n';
+	return static_cast<uint32_t>(pline - apLine);
+}
+
 //----------------------------------------------------------------
 uint16_t DisAssemble( const Input &arInput )
+{
+	char *pdest = arInput.pDest;
+	char *pbytes = arInput.pBytes;
+	const uint8_t *psource = arInput.pSource;
+	uint32_t destLen = arInput.DestLen;
+	uint32_t sourceLen = arInput.SourceLen;
+	uint16_t address = arInput.Address;
+
+	uint32_t i = 0;
+	for ( ; i < arInput.Lines; ++i) {
+		//Stop rather than decode past the end of the source
+		if (!sourceLen) {
+			break;
+		}
+		const uint8_t op = *psource;
+		const Format &rformat = FormatA[op];
+		if (sourceLen < rformat.Size) {
+			break;
+		}
+
+		char line[LINEMAX];
+		uint32_t len = FormatLine(line, rformat, psource, address);
+		if (!destLen) {
+			break;
+		}
+		//Cut a line with long labels short rather than lose it
+		if (len > destLen) {
+			len = destLen;
+			line[len - 1] = '\n';
+		}
+		memcpy(pdest, line, len);
+		pdest += len;
+		destLen -= len;
+
+		//Raw bytes "XX XX XX\n"
+		for ( uint32_t b = 0; b < rformat.Size; ++b) {
+			pbytes = AddHex(pbytes, psource[b]);
+			*pbytes++ = ' ';
+		}
+		pbytes[-1] = '\n';						//This will be used for replacement during editing
+
+		arInput.pOpCodes[i] = &OpCode::Get(op);
+		psource += rformat.Size;
+		sourceLen -= rformat.Size;
+		address += rformat.Size;
+	}
+
+	//Replace final \n of both views with the null terminator
+	if (i) {
+		pdest[-1] = 0;
+		pbytes[-1] = 0;
+	}
+
+	//Make sure if we didn't finish to fill out some data
+	const OpCode *pbad = &OpCode::Get(OpCode::BADOP);
+	for ( ; i < arInput.Lines; ++i) {
+		arInput.pOpCodes[i] = pbad;
+	}
+	return address;
+}
+
+//----------------------------------------------------------------
+uint16_t Reference( const Input &arInput )
 {
 	Parser p(arInput);
 	return p.Address;
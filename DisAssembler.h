@@ -36,6 +36,8 @@
 namespace DisAssembler
 {
 
+constexpr uint32_t LINEMAX = 0x100;				//Longest line including labels
+
 //----------------------------------------------------------------
 struct Input
 {
@@ -50,6 +52,13 @@ struct Input
 };
 
 //----------------------------------------------------------------
+///Disassemble using the per-opcode formats built at compile time
+/// Return the address following the last line
 uint16_t DisAssemble( const Input &arInput );
 
+//----------------------------------------------------------------
+///The original call-chain parser, kept to check and time DisAssemble
+/// against. Stops at INDIRECT mode which it never supported.
+uint16_t Reference( const Input &arInput );
+
 }	//namespace DisAssembler
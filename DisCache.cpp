@@ -0,0 +1,112 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    DisCache.cpp
+//----------------------------------------------------------------------
+
+
+#include "DisCache.h"
+#include "DisAssembler.h"
+#include "Labels.h"
+#include "Shadow.h"
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+
+namespace DisCache
+{
+
+//----------------------------------------------------------------
+///Lines for one memspace and bank
+struct Cache
+{
+	Line LineA[Shadow::IMAGESIZE];
+};
+
+std::unordered_map<Banks::Space, std::unique_ptr<Cache>> Caches;	//Cache per memspace/bank
+
+//----------------------------------------------------------------
+///Decode instruction at an address from the Shadow image
+void Decode( Line &arLine, uint16_t aAddress, Banks::Space aSpace )
+{
+	const uint8_t *pimage = Shadow::QImage(aSpace);
+	uint8_t data[3] = {
+		pimage[aAddress],
+		pimage[static_cast<uint16_t>(aAddress + 1)],
+		pimage[static_cast<uint16_t>(aAddress + 2)]
+	};
+
+	DisAssembler::Input input{
+		arLine.Text,
+		arLine.Bytes,
+		&arLine.pOpCode,
+		data,
+		TEXTLEN,
+		sizeof(data),
+		1,
+		aAddress
+	};
+	DisAssembler::DisAssemble(input);
+}
+
+//----------------------------------------------------------------
+const Line &Get( uint16_t aAddress, Banks::Space aSpace )
+{
+	auto &pcache = Caches[aSpace];
+	if (!pcache) {
+		pcache = std::make_unique<Cache>();
+	}
+
+	//An instruction may run into the next page
+	const auto last = static_cast<uint16_t>(aAddress + 2);
+	const uint32_t stamp = std::max(Shadow::QStamp(aAddress, aAddress, aSpace), Shadow::QStamp(last, last, aSpace));
+	const uint32_t labelStamp = Labels::QStamp();
+
+	Line &line = pcache->LineA[aAddress];
+	if (!line.pOpCode || (line.Stamp != stamp) || (line.LabelStamp != labelStamp)) {
+		Decode(line, aAddress, aSpace);
+		line.Stamp = stamp;
+		line.LabelStamp = labelStamp;
+	}
+	return line;
+}
+
+//----------------------------------------------------------------
+void Clear(  )
+{
+	//Views may still point at the text, so keep the lines and only mark
+	// them undecoded
+	for ( auto &[space, pcache] : Caches ) {
+		for ( auto &rline : pcache->LineA ) {
+			rline.pOpCode = nullptr;
+		}
+	}
+}
+
+}	//namespace DisCache
@@ -0,0 +1,72 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    DisCache.h
+//----------------------------------------------------------------------
+
+
+#pragma once
+
+#include "types.h"
+#include "6502.h"
+#include "Banks.h"
+#include "DisAssembler.h"
+
+///Decoded instruction at every address of the 64K, per memspace and bank.
+/// Lines are decoded from the Shadow image on first use and again only
+/// when the Shadow stamp of their bytes or the labels change, so
+/// scrolling and following the IP are lookups.
+namespace DisCache
+{
+
+constexpr uint32_t TEXTLEN = DisAssembler::LINEMAX;	//Longest disassembly text, labels and all
+constexpr uint32_t BYTESLEN = 10;				//Up to 3 bytes taking 3 chars each
+
+//----------------------------------------------------------------
+struct Line
+{
+	const OpCode *pOpCode = nullptr;			//nullptr until decoded
+	uint32_t Stamp = 0;							//Shadow stamp of the bytes decoded
+	uint32_t LabelStamp = 0;					//Labels stamp when decoded
+	char Text[TEXTLEN];							//Disassembly
+	char Bytes[BYTESLEN];						//Hex of the instruction bytes
+
+	//----------------------------------------------------------------
+	///Number of bytes the instruction takes
+	uint8_t QSize(  ) const { return pOpCode->QSize(); }
+};
+
+//----------------------------------------------------------------
+///Get instruction at an address, decoding it if its bytes changed
+const Line &Get( uint16_t aAddress, Banks::Space aSpace = Banks::MAIN );
+
+//----------------------------------------------------------------
+///Forget all decoded lines, for when the whole machine state is replaced
+void Clear(  );
+
+}	//namespace DisCache
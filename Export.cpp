@@ -0,0 +1,346 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Export.cpp
+//----------------------------------------------------------------------
+
+#include "Export.h"
+#include "Labels.h"
+#include "Numbers.h"
+#include "Source.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace Export
+{
+
+constexpr uint32_t LINEBYTES = 16;				//Bytes per text line
+
+//----------------------------------------------------------------
+const char *FormatName( FORMAT aeFormat )
+{
+	constexpr const char *names[] = { "Binary", "PRG", "Hex dump", "KickAss", "KickAss source" };
+	return aeFormat < FORMAT::COUNT ? names[static_cast<uint32_t>(aeFormat)] : "?";
+}
+
+//----------------------------------------------------------------
+const char *FormatExt( FORMAT aeFormat )
+{
+	constexpr const char *exts[] = { ".bin", ".prg", ".txt", ".asm", ".asm" };
+	return aeFormat < FORMAT::COUNT ? exts[static_cast<uint32_t>(aeFormat)] : "";
+}
+
+//----------------------------------------------------------------
+FORMAT FindFormat( const char *apName )
+{
+	constexpr const char *keys[] = { "bin", "prg", "hex", "kick", "source" };
+	for ( uint32_t i = 0; i < static_cast<uint32_t>(FORMAT::COUNT); ++i) {
+		auto format = static_cast<FORMAT>(i);
+		if (!_stricmp(apName, keys[i]) || !_stricmp(apName, FormatExt(format))) {
+			return format;
+		}
+	}
+	return FORMAT::COUNT;
+}
+
+//----------------------------------------------------------------
+///Parse a value at apText up to a terminator in apEnd. A leading '$'
+/// means hex, otherwise a label is tried before hex. arName is set
+/// if it was a label. Return pointer past the value or nullptr on error
+const char *ParseValue( const char *apText, const char *apEnd, uint32_t &arValue, std::string &arName )
+{
+	const bool hex = (*apText == '$');
+	const char *pstart = apText + hex;
+	const char *pend = pstart;
+	while (*pend && !strchr(apEnd, *pend)) {
+		++pend;
+	}
+	if (pend == pstart) {
+		return nullptr;
+	}
+
+	std::string token(pstart, pend);
+	uint16_t value = 0;
+	if (!hex && Labels::Find(token.c_str(), value)) {
+		arValue = value;
+		arName = token;
+		return pend;
+	}
+
+	if (token.size() > 4) {
+		return nullptr;
+	}
+	arValue = 0;
+	for ( char c : token ) {
+		if (!isxdigit(static_cast<uint8_t>(c))) {
+			return nullptr;
+		}
+		arValue = (arValue << 4) | Numbers::ToNum(c);
+	}
+	return pend;
+}
+
+//----------------------------------------------------------------
+bool ParseRanges( const char *apText, RangeList &arRanges )
+{
+	arRanges.clear();
+	const char *piter = apText;
+	while (*piter) {
+		if (*piter == ',' || *piter == ' ') {
+			++piter;
+			continue;
+		}
+
+		Range range;
+		uint32_t start = 0;
+		uint32_t end = 0;
+		std::string name;
+		if (piter = ParseValue(piter, "-+, ", start, range.Name); !piter) {
+			return false;
+		}
+
+		if (*piter == '-') {
+			if (piter = ParseValue(piter + 1, ", ", end, name); !piter) {
+				return false;
+			}
+		}
+		else if (*piter == '+') {
+			uint32_t len = 0;
+			if (piter = ParseValue(piter + 1, ", ", len, name); !piter || !len) {
+				return false;
+			}
+			end = start + len - 1;
+		}
+		//A label alone runs to the next label
+		else if (!range.Name.empty()) {
+			end = Labels::QNext(static_cast<uint16_t>(start)) - 1;
+		}
+		else {
+			end = start;
+		}
+
+		if ((end < start) || (end > 0xffff)) {
+			return false;
+		}
+		range.Start = static_cast<uint16_t>(start);
+		range.End = static_cast<uint16_t>(end);
+		arRanges.push_back(std::move(range));
+	}
+	return !arRanges.empty();
+}
+
+//----------------------------------------------------------------
+bool SortRanges( RangeList &arRanges )
+{
+	std::sort(arRanges.begin(), arRanges.end(), []( const Range &arA, const Range &arB ) { return arA.Start < arB.Start; });
+	for ( size_t i = 1; i < arRanges.size(); ++i) {
+		if (arRanges[i].Start <= arRanges[i - 1].End) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------------
+bool Writer::Open( const std::filesystem::path &arPath )
+{
+	const bool binary = (Format == FORMAT::BIN) || (Format == FORMAT::PRG);
+	File.open(arPath, binary ? std::ios::binary : std::ios::out);
+	Used = 0;
+	Column = 0;
+	First = true;
+	Backward = false;
+	if (File && (Format == FORMAT::KICK)) {
+		constexpr char header[] = "// Exported by c64debugger\n";
+		Put(header, sizeof(header) - 1);
+	}
+	else if (Format == FORMAT::SOURCE) {
+		pImage = std::make_unique<uint8_t[]>(0x10000);
+		Ranges.clear();
+	}
+	return File.is_open();
+}
+
+//----------------------------------------------------------------
+void Writer::Begin( const Range &arRange )
+{
+	switch (Format) {
+		case FORMAT::PRG:
+			if (First) {
+				const uint8_t load[2] = { static_cast<uint8_t>(arRange.Start), static_cast<uint8_t>(arRange.Start >> 8) };
+				Put(reinterpret_cast<const char*>(load), 2);
+			}
+			else {
+				//Can't go back in a PRG, it would load in the wrong place
+				Backward |= (arRange.Start < Next);
+				//Pad forward gaps so the range loads where it came from
+				const char zero = 0;
+				for ( uint32_t addr = Next; addr < arRange.Start; ++addr) {
+					Put(&zero, 1);
+				}
+			}
+			break;
+		case FORMAT::HEX:
+			EndLine();
+			if (!arRange.Name.empty()) {
+				Put(arRange.Name.c_str(), static_cast<uint32_t>(arRange.Name.size()));
+				Put(":\n", 2);
+			}
+			break;
+		case FORMAT::KICK:
+		{
+			EndLine();
+			if (First || (arRange.Start != Next)) {
+				char org[] = "\n* = $xxxx\n";
+				Numbers::ToHex(&org[6], arRange.Start);
+				org[10] = '\n';					//ToHex null terminated it
+				Put(org, sizeof(org) - 1);
+			}
+			if (!arRange.Name.empty()) {
+				Put(arRange.Name.c_str(), static_cast<uint32_t>(arRange.Name.size()));
+				Put(":\n", 2);
+			}
+			break;
+		}
+		case FORMAT::SOURCE:
+			Ranges.push_back(arRange);
+			break;
+		default:
+			break;
+	}
+	First = false;
+	Next = arRange.Start;
+}
+
+//----------------------------------------------------------------
+void Writer::Write( const uint8_t *apData, uint32_t aSize )
+{
+	switch (Format) {
+		case FORMAT::BIN:
+		case FORMAT::PRG:
+			Put(reinterpret_cast<const char*>(apData), aSize);
+			break;
+		case FORMAT::HEX:
+			for ( uint32_t i = 0; i < aSize; ++i) {
+				char text[8];
+				if (!Column) {
+					Numbers::ToHex(text, static_cast<uint16_t>(Next + i));
+					text[4] = ':';
+					Put(text, 5);
+				}
+				text[0] = ' ';
+				Numbers::ToHex(&text[1], apData[i]);
+				Put(text, 3);
+				if (++Column == LINEBYTES) {
+					EndLine();
+				}
+			}
+			break;
+		case FORMAT::KICK:
+			for ( uint32_t i = 0; i < aSize; ++i) {
+				char text[8] = "\t.byte ";
+				if (!Column) {
+					Put(text, 7);
+				}
+				else {
+					Put(",", 1);
+				}
+				text[0] = '$';
+				Numbers::ToHex(&text[1], apData[i]);
+				Put(text, 3);
+				if (++Column == LINEBYTES) {
+					EndLine();
+				}
+			}
+			break;
+		case FORMAT::SOURCE:
+			memcpy(&pImage[Next], apData, std::min<uint32_t>(aSize, 0x10000 - Next));
+			break;
+		default:
+			break;
+	}
+	Next += aSize;
+}
+
+//----------------------------------------------------------------
+bool Writer::Close(  )
+{
+	if ((Format == FORMAT::SOURCE) && pImage) {
+		Source::Job job;
+		job.pImage = pImage.get();
+		job.Ranges = std::move(Ranges);
+		job.Entries = std::move(Entries);
+		job.pRegions = pRegions.get();
+		job.FindLabel = []( uint16_t aAddress ) { return Labels::Find(aAddress); };
+		Source::Write(job, [&]( const char *apText, uint32_t aSize ) { Put(apText, aSize); });
+		pImage.reset();
+	}
+	EndLine();
+	Flush();
+	bool bres = File.good() && !Backward;
+	File.close();
+	return bres;
+}
+
+//----------------------------------------------------------------
+void Writer::Put( const char *apData, uint32_t aSize )
+{
+	while (aSize) {
+		uint32_t fit = BUFFERSIZE - Used;
+		fit = aSize < fit ? aSize : fit;
+		memcpy_s(&Buffer[Used], BUFFERSIZE - Used, apData, fit);
+		Used += fit;
+		apData += fit;
+		aSize -= fit;
+		if (Used == BUFFERSIZE) {
+			Flush();
+		}
+	}
+}
+
+//----------------------------------------------------------------
+void Writer::EndLine(  )
+{
+	if (Column) {
+		Put("\n", 1);
+		Column = 0;
+	}
+}
+
+//----------------------------------------------------------------
+void Writer::Flush(  )
+{
+	if (Used) {
+		File.write(Buffer, Used);
+		Used = 0;
+	}
+}
+
+}	//namespace Export
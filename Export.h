@@ -0,0 +1,171 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Export.h
+//----------------------------------------------------------------------
+
+#pragma once
+
+#include "types.h"
+#include "Regions.h"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+///Writing c64 memory to files. Data is streamed in as it arrives and
+/// formatted through a fixed size buffer, so a range of any size never
+/// needs to be held in one piece.
+///  BIN  - Raw bytes, ranges are concatenated
+///  PRG  - 2 byte load address of the 1st range then the data. Gaps
+///         between ranges are zero filled so the rest load at
+///         the right address. Ranges are sorted and must not overlap
+///  HEX  - "C000: 01 02 .." lines of 16 bytes
+///  KICK - KickAssembler source, ".byte $01,$02,.." lines with labels
+///         and "* = $C000" where a range does not follow the last
+///  SOURCE - KickAssembler source disassembled by Source, collected
+///         until Close as code can refer anywhere in the ranges
+namespace Export
+{
+
+//----------------------------------------------------------------
+enum class FORMAT : uint8_t
+{
+	BIN,
+	PRG,
+	HEX,
+	KICK,
+	SOURCE,
+	COUNT
+};
+
+//----------------------------------------------------------------
+///Inclusive address range, Name is the label it was given by if any
+struct Range
+{
+	uint16_t Start = 0;
+	uint16_t End = 0;
+	std::string Name;
+
+	uint32_t QSize(  ) const { return static_cast<uint32_t>(End) - Start + 1; }
+};
+
+using RangeList = std::vector<Range>;
+
+//----------------------------------------------------------------
+///Get display name for the given format
+const char *FormatName( FORMAT aeFormat );
+
+//----------------------------------------------------------------
+///Get file extension (with '.') for the given format
+const char *FormatExt( FORMAT aeFormat );
+
+//----------------------------------------------------------------
+///Find format by name or extension, ie "kick" or ".asm". Return
+/// FORMAT::COUNT if not known
+FORMAT FindFormat( const char *apName );
+
+//----------------------------------------------------------------
+///Parse comma separated ranges into arRanges. Each entry is one of:
+///  start-end  Inclusive range
+///  start+len  Length in hex
+///  label      From the label up to the next label
+/// Values are hex with optional '$' or a label name. Return false on error
+bool ParseRanges( const char *apText, RangeList &arRanges );
+
+//----------------------------------------------------------------
+///Put ranges in address order, as a PRG is one block loaded at the
+/// 1st address. Return false if any ranges overlap
+bool SortRanges( RangeList &arRanges );
+
+//----------------------------------------------------------------
+///Formats memory into a file in one of the export formats.
+/// Call Begin for each range, then Write the range data in order.
+/// PRG ranges must be in ascending order, see SortRanges
+class Writer
+{
+public:
+	static constexpr uint32_t BUFFERSIZE = 0x1000;
+
+	//----------------------------------------------------------------
+	explicit Writer( FORMAT aeFormat ) : Format(aeFormat) {  }
+
+	//----------------------------------------------------------------
+	///Create the file, return false on error
+	bool Open( const std::filesystem::path &arPath );
+
+	//----------------------------------------------------------------
+	///Start a new range
+	void Begin( const Range &arRange );
+
+	//----------------------------------------------------------------
+	///Add a known code entry point for SOURCE
+	void AddEntry( uint16_t aAddress ) { Entries.push_back(aAddress); }
+
+	//----------------------------------------------------------------
+	///Set which bytes are code and data for SOURCE
+	void SetRegions( const Regions::Map &arMap ) { pRegions = std::make_unique<Regions::Map>(arMap); }
+
+	//----------------------------------------------------------------
+	///Add data that follows on from the last data written
+	void Write( const uint8_t *apData, uint32_t aSize );
+
+	//----------------------------------------------------------------
+	///Flush and close the file, return false if anything failed
+	bool Close(  );
+
+private:
+	std::ofstream File;
+	FORMAT Format;
+	uint32_t Used = 0;							//Bytes in Buffer
+	uint32_t Column = 0;						//Bytes on the current text line
+	uint32_t Next = 0;							//Address following the last byte written
+	bool First = true;							//No range started yet
+	bool Backward = false;						//A PRG range started before the last ended
+	std::unique_ptr<uint8_t[]> pImage;			//Memory collected for SOURCE
+	RangeList Ranges;							//Ranges collected for SOURCE
+	std::vector<uint16_t> Entries;				//Code entry points for SOURCE
+	std::unique_ptr<Regions::Map> pRegions;		//Code and data for SOURCE, nullptr to classify
+	char Buffer[BUFFERSIZE];
+
+	//----------------------------------------------------------------
+	///Add text or bytes to the buffer, flushing as needed
+	void Put( const char *apData, uint32_t aSize );
+
+	//----------------------------------------------------------------
+	///End the current text line
+	void EndLine(  );
+
+	//----------------------------------------------------------------
+	///Write the buffer to the file
+	void Flush(  );
+};
+
+}	//namespace Export
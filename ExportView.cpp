@@ -0,0 +1,408 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    ExportView.cpp
+//----------------------------------------------------------------------
+
+#include "ExportView.h"
+#include "Banks.h"
+#include "Command.h"
+#include "Export.h"
+#include "Flow.h"
+#include "Labels.h"
+#include "Monitor.h"
+#include "Program.h"
+#include "Regions.h"
+#include "Response.h"
+#include "Shadow.h"
+
+#include <algorithm>
+#include <fstream>
+#include <imgui.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ExportView
+{
+
+constexpr uint32_t PIPELINE = 16;				//Pages requested ahead of the writer
+constexpr uint32_t FILELEN = 0xff;				//Maximum snapshot file name size
+
+//----------------------------------------------------------------
+enum class STATE
+{
+	IDLE,
+	UNDUMP,										//Waiting for VICE to load a snapshot
+	FETCH										//Streaming ranges to the file
+};
+
+bool Enabled = false;							//Window enabled
+int32_t Format = 0;								//Export::FORMAT as int for combo box
+char RangeText[256] = "";						//Ranges to export
+char FileText[256] = "export.bin";				//File to write
+char Status[128] = "";							//Progress or error string
+Banks::Space Space = Banks::MAIN;				//Memspace and bank to export from
+
+STATE State = STATE::IDLE;
+Export::RangeList Ranges;						//Ranges of the export running
+std::unique_ptr<Export::Writer> pWriter;
+std::filesystem::path OutPath;					//File being written
+Banks::Space JobSpace = Banks::MAIN;			//Space of the export running
+size_t RangeIndex = 0;							//Range being written
+uint32_t Cursor = 0;							//Next address to write
+uint32_t Written = 0;							//Bytes written so far
+uint32_t Total = 0;								//Bytes to write
+
+std::vector<std::string> BatchLines;			//Batch exports still to run
+bool BatchActive = false;
+bool BatchDone = false;
+uint32_t BatchFailed = 0;						//Batch exports that failed
+CommandPtr UndumpCommand = Command::Create(COMMAND::UNDUMP, FILELEN);
+
+//----------------------------------------------------------------
+///Report export result, in batch mode on stderr as there's no one watching
+void Finish( bool abGood )
+{
+	if (abGood) {
+		snprintf(Status, sizeof(Status), "Wrote %u bytes to %s", Written, OutPath.filename().string().c_str());
+	}
+	else {
+		snprintf(Status, sizeof(Status), "Failed writing %s", OutPath.filename().string().c_str());
+		BatchFailed += BatchActive;
+	}
+	if (BatchActive) {
+		fprintf(stderr, "%s\n", Status);
+	}
+	pWriter.reset();
+	State = STATE::IDLE;
+}
+
+//----------------------------------------------------------------
+///Give a source export the code entry points. For the computer these
+/// are where Flow found code plus the program start and labels, which
+/// Flow also walks from, along with the Regions map of code and data.
+/// Other memory is walked from each range start
+void AddEntries(  )
+{
+	if (JobSpace != Banks::MAIN) {
+		for ( const auto &range : Ranges ) {
+			pWriter->AddEntry(range.Start);
+		}
+		return;
+	}
+
+	pWriter->SetRegions(Regions::QMap());
+	for ( const auto &rblock : Flow::QBlocks() ) {
+		pWriter->AddEntry(rblock.Start);
+	}
+	if (const uint32_t start = Program::QStart(); start < Flow::NONE) {
+		pWriter->AddEntry(static_cast<uint16_t>(start));
+	}
+	Labels::ForEach([]( uint16_t aValue, const char * ) {
+		if (Flow::QEntryLabel(aValue)) {
+			pWriter->AddEntry(aValue);
+		}
+		return true;
+	});
+}
+
+//----------------------------------------------------------------
+///Open the file and start streaming. If VICE is running the cached
+/// memory is stale so it's discarded first
+bool Start( Export::FORMAT aeFormat, const std::filesystem::path &arPath, Banks::Space aSpace )
+{
+	OutPath = arPath;
+	if (Monitor::ViceState() == VICESTATE::DISCONNECTED) {
+		snprintf(Status, sizeof(Status), "Not connected");
+		return false;
+	}
+
+	if ((aeFormat == Export::FORMAT::PRG) && !Export::SortRanges(Ranges)) {
+		Finish(false);
+		snprintf(Status, sizeof(Status), "Ranges overlap, a PRG can't hold them");
+		return false;
+	}
+
+	pWriter = std::make_unique<Export::Writer>(aeFormat);
+	if (!pWriter->Open(arPath)) {
+		Finish(false);
+		return false;
+	}
+
+	JobSpace = aSpace;
+	if (aeFormat == Export::FORMAT::SOURCE) {
+		AddEntries();
+	}
+	Total = 0;
+	for ( const auto &range : Ranges ) {
+		Total += range.QSize();
+		if (Monitor::ViceState() == VICESTATE::RUNNING) {
+			Shadow::Invalidate(range.Start, range.End, JobSpace);
+		}
+	}
+	Written = 0;
+	RangeIndex = 0;
+	Cursor = Ranges[0].Start;
+	pWriter->Begin(Ranges[0]);
+	State = STATE::FETCH;
+	return true;
+}
+
+//----------------------------------------------------------------
+///Keep PIPELINE pages in flight ahead of the cursor and write out pages
+/// as they arrive
+void Pump(  )
+{
+	while (RangeIndex < Ranges.size()) {
+		const auto &range = Ranges[RangeIndex];
+		const uint32_t ahead = std::min<uint32_t>(Cursor + (PIPELINE * Shadow::PAGESIZE) - 1, range.End);
+		Shadow::Fetch(static_cast<uint16_t>(Cursor), static_cast<uint16_t>(ahead), JobSpace);
+
+		const uint32_t end = std::min<uint32_t>(Cursor | (Shadow::PAGESIZE - 1), range.End);
+		if (!Shadow::QValid(static_cast<uint16_t>(Cursor), static_cast<uint16_t>(end), JobSpace)) {
+			snprintf(Status, sizeof(Status), "Exporting %u/%u", Written, Total);
+			return;								//Wait for the page
+		}
+		pWriter->Write(Shadow::QImage(JobSpace) + Cursor, end - Cursor + 1);
+		Written += end - Cursor + 1;
+		Cursor = end + 1;
+
+		if (Cursor > range.End) {
+			if (++RangeIndex < Ranges.size()) {
+				Cursor = Ranges[RangeIndex].Start;
+				pWriter->Begin(Ranges[RangeIndex]);
+			}
+		}
+	}
+	Finish(pWriter->Close());
+}
+
+//----------------------------------------------------------------
+///Start the next export in the batch
+void NextBatch(  )
+{
+	while (!BatchLines.empty()) {
+		std::istringstream strm(BatchLines.front());
+		BatchLines.erase(BatchLines.begin());
+
+		std::string format, file, ranges, snapshot;
+		strm >> format >> file >> ranges >> snapshot;
+		auto eformat = Export::FindFormat(format.c_str());
+		if ((eformat == Export::FORMAT::COUNT) || !Export::ParseRanges(ranges.c_str(), Ranges)) {
+			fprintf(stderr, "Bad export: %s %s %s\n", format.c_str(), file.c_str(), ranges.c_str());
+			++BatchFailed;
+			continue;
+		}
+
+		OutPath = file;
+		Format = static_cast<int32_t>(eformat);
+		if (snapshot.empty()) {
+			if (Start(eformat, OutPath, Space)) {
+				return;
+			}
+		}
+		else {
+			//VICE may not share our working directory
+			const auto name = std::filesystem::absolute(snapshot).string();
+			const auto len = name.length() + 1;	//+ 1 to include null termination
+			if (len <= FILELEN) {
+				UndumpCommand->Reset();
+				UndumpCommand->Add(static_cast<uint8_t>(len));
+				UndumpCommand->Add(name.c_str());
+				Monitor::Send(UndumpCommand);
+				State = STATE::UNDUMP;
+				return;
+			}
+			++BatchFailed;
+		}
+	}
+	fprintf(stderr, "Batch finished, %u failed\n", BatchFailed);
+	BatchActive = false;
+	BatchDone = true;
+}
+
+//----------------------------------------------------------------
+///Move export along
+void Update(  )
+{
+	switch (State) {
+		case STATE::IDLE:
+			if (BatchActive && (Monitor::ViceState() != VICESTATE::DISCONNECTED)) {
+				NextBatch();
+			}
+			break;
+		case STATE::FETCH:
+			if (Monitor::ViceState() == VICESTATE::DISCONNECTED) {
+				pWriter->Close();
+				Finish(false);
+			}
+			else {
+				Pump();
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+//----------------------------------------------------------------
+void ToJson( nlohmann::json &arData )
+{
+	arData["Export"] = {
+		{"On", Enabled},
+		{"Format", Format},
+		{"Space", Space},
+		{"Ranges", RangeText},
+		{"File", FileText}
+	};
+}
+
+//----------------------------------------------------------------
+void FromJson( nlohmann::json &arData )
+{
+	auto obj = arData["Export"];
+	if (!obj.is_null()) {
+		Enabled = obj["On"];
+		Format = obj["Format"];
+		Space = obj["Space"];
+		std::string ranges = obj["Ranges"];
+		std::string file = obj["File"];
+		snprintf(RangeText, sizeof(RangeText), "%s", ranges.c_str());
+		snprintf(FileText, sizeof(FileText), "%s", file.c_str());
+	}
+}
+
+//----------------------------------------------------------------
+bool Batch( const std::filesystem::path &arList )
+{
+	std::ifstream strm(arList);
+	if (!strm.is_open()) {
+		return false;
+	}
+
+	std::string line;
+	while (std::getline(strm, line)) {
+		if (!line.empty() && (line[0] != '#') && (line.find_first_not_of(" \t\r") != std::string::npos)) {
+			BatchLines.push_back(line);
+		}
+	}
+	BatchActive = true;
+	BatchDone = false;
+	BatchFailed = 0;
+	return true;
+}
+
+//----------------------------------------------------------------
+bool QBatchDone(  )
+{
+	bool bres = BatchDone;
+	BatchDone = false;
+	return bres;
+}
+
+//----------------------------------------------------------------
+void Restored( const Response &arResponse )
+{
+	if ((State == STATE::UNDUMP) && (arResponse.QID() == UndumpCommand->QID())) {
+		State = STATE::IDLE;
+		if (arResponse.QError() != ERRORCODES::EC_OK) {
+			snprintf(Status, sizeof(Status), "Failed loading snapshot for %s", OutPath.filename().string().c_str());
+			fprintf(stderr, "%s\n", Status);
+			++BatchFailed;
+		}
+		else {
+			Start(static_cast<Export::FORMAT>(Format), OutPath, Space);
+		}
+	}
+}
+
+//----------------------------------------------------------------
+void DisplayOn(  )
+{
+	Enabled = true;
+}
+
+//----------------------------------------------------------------
+void Display(  )
+{
+	Update();									//Exports run with the window closed
+
+	if (!Enabled) return;						//Early out if view not visible
+
+	ImGui::SetNextWindowSize(ImVec2(340, 150), ImGuiCond_FirstUseEver);
+	ImGui::Begin("Export", &Enabled);
+
+	const float w = ImGui::GetFontSize();
+
+	ImGui::PushItemWidth(w * 6.0f);
+	if (ImGui::BeginCombo("##Format", Export::FormatName(static_cast<Export::FORMAT>(Format)))) {
+		for ( int32_t i = 0; i < static_cast<int32_t>(Export::FORMAT::COUNT); ++i) {
+			if (ImGui::Selectable(Export::FormatName(static_cast<Export::FORMAT>(i)), i == Format)) {
+				Format = i;
+				//Swap the file extension to match
+				std::filesystem::path path(FileText);
+				path.replace_extension(Export::FormatExt(static_cast<Export::FORMAT>(i)));
+				snprintf(FileText, sizeof(FileText), "%s", path.string().c_str());
+			}
+		}
+		ImGui::EndCombo();
+	}
+	ImGui::PopItemWidth();
+	ImGui::SameLine();
+	Banks::Combo("##Space", Space);
+
+	ImGui::PushItemWidth(-FLT_MIN);
+	ImGui::InputText("##Ranges", RangeText, sizeof(RangeText));
+	if (ImGui::IsItemHovered()) {
+		ImGui::SetTooltip("Comma separated: c000-c7ff, $0801+100, sprites\nA label alone runs to the next label");
+	}
+	ImGui::InputText("##File", FileText, sizeof(FileText));
+	ImGui::PopItemWidth();
+
+	if (State != STATE::IDLE) {
+		ImGui::Text("%s", Status);
+	}
+	else {
+		if (ImGui::Button("Export")) {
+			if (Export::ParseRanges(RangeText, Ranges)) {
+				Start(static_cast<Export::FORMAT>(Format), FileText, Space);
+			}
+			else {
+				snprintf(Status, sizeof(Status), "Bad range");
+			}
+		}
+		ImGui::SameLine();
+		ImGui::Text("%s", Status);
+	}
+
+	ImGui::End();
+}
+
+}	//namespace ExportView
@@ -0,0 +1,78 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    ExportView.h
+//----------------------------------------------------------------------
+
+#pragma once
+
+#include "types.h"
+#include "json/json.hpp"
+
+#include <filesystem>
+
+class Response;
+
+///Window to export memory ranges to files, and the command line batch
+/// mode which runs a list of exports, optionally each from a VICE snapshot
+namespace ExportView
+{
+
+//----------------------------------------------------------------
+///Save data to Json
+void ToJson( nlohmann::json &arData );
+
+//----------------------------------------------------------------
+///Load data from Json
+void FromJson( nlohmann::json &arData );
+
+//----------------------------------------------------------------
+///Run the exports listed in a file, one per line:
+///  format outfile ranges [snapshot.vsf]
+/// Blank lines and lines starting with '#' are skipped. Return false
+/// if the file can't be read
+bool Batch( const std::filesystem::path &arList );
+
+//----------------------------------------------------------------
+///Return true once, the first time asked after a batch has run all
+/// its exports
+bool QBatchDone(  );
+
+//----------------------------------------------------------------
+///Process UNDUMP response, starts the export waiting on the snapshot
+void Restored( const Response &arResponse );
+
+//----------------------------------------------------------------
+///Enable window
+void DisplayOn(  );
+
+//----------------------------------------------------------------
+///Run any export in progress and draw window
+void Display(  );
+
+}	//namespace ExportView
@@ -0,0 +1,619 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Flow.cpp
+//----------------------------------------------------------------------
+
+
+#include "Flow.h"
+#include "6502.h"
+#include "BreakPoints.h"
+#include "Labels.h"
+#include "Program.h"
+#include "Regions.h"
+#include "Shadow.h"
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Flow
+{
+
+constexpr uint32_t FULLPAGES = 0x20;			//Changed pages above which everything is walked again
+constexpr uint16_t LOWEST = 0x0200;				//Labels below this are taken as data
+constexpr uint16_t IOSTART = 0xd000;			//Labels in I/O are registers not code
+constexpr uint16_t IOEND = 0xdfff;
+
+//Vectors holding code addresses, kernal RAM vectors and the CPU vectors
+constexpr uint16_t VectorA[] = { 0x0314, 0x0316, 0x0318, 0xfffa, 0xfffc, 0xfffe };
+
+using UniqueLock = std::unique_lock<std::mutex>;
+using ImageA = std::array<uint8_t, Shadow::IMAGESIZE>;
+using StampA = std::array<uint32_t, Shadow::NUMPAGES>;
+
+//----------------------------------------------------------------
+///Everything a pass reads, copied so the worker never touches live data
+struct Job
+{
+	ImageA Image;
+	StampA Stamps;								//Shadow stamp per page, 0 if never fetched
+	std::vector<uint16_t> Entries;				//Sorted entry points
+};
+
+//----------------------------------------------------------------
+///Results of a pass
+struct Graph
+{
+	std::vector<Block> Blocks;					//Sorted by Start
+	std::vector<Call> Calls;					//Sorted by Target then Site
+};
+
+//----------------------------------------------------------------
+///Find index of block starting at given address in sorted blocks, or size if none
+size_t Find( const std::vector<Block> &arBlocks, uint32_t aAddress )
+{
+	auto it = std::lower_bound(arBlocks.begin(), arBlocks.end(), aAddress
+		, []( const Block &arBlock, uint32_t aValue ) { return arBlock.Start < aValue; });
+	return ((it != arBlocks.end()) && (it->Start == aAddress)) ? it - arBlocks.begin() : arBlocks.size();
+}
+
+//----------------------------------------------------------------
+///Worker side state, kept between passes so only changed pages are redone
+class Analyser
+{
+public:
+	//----------------------------------------------------------------
+	///Bring blocks up to date with the job
+	/// Return the new graph, nullptr if nothing changed
+	std::shared_ptr<Graph> Run( const Job &arJob )
+	{
+		if (!Changes(arJob)) {
+			return nullptr;
+		}
+		Walk();
+		Prune();
+		return MakeGraph();
+	}
+
+private:
+	ImageA Image{};								//Bytes of the last pass
+	StampA Stamps{};							//Stamps of the last pass
+	std::vector<uint16_t> Entries;				//Entry points of the last pass
+	std::map<uint16_t, Block> Blocks;
+	bool First = true;
+
+	//----------------------------------------------------------------
+	///Size of the instruction at an address
+	uint32_t Size( uint32_t aAddress ) const
+	{
+		return OpCode::Get(Image[aAddress]).QSize();
+	}
+
+	//----------------------------------------------------------------
+	uint16_t Word( uint32_t aAddress ) const
+	{
+		return Image[aAddress] | (Image[(aAddress + 1) & 0xffff] << 8);
+	}
+
+	//----------------------------------------------------------------
+	///Take the job's data and drop blocks over pages whose bytes changed
+	/// Return false if nothing changed since the last pass
+	bool Changes( const Job &arJob )
+	{
+		std::bitset<Shadow::NUMPAGES> dirty;
+		for ( uint32_t page = 0; page < Shadow::NUMPAGES; ++page) {
+			if (arJob.Stamps[page] != Stamps[page]) {
+				const uint32_t base = page * Shadow::PAGESIZE;
+				dirty[page] = !arJob.Stamps[page] || !Stamps[page]
+					|| memcmp(&arJob.Image[base], &Image[base], Shadow::PAGESIZE);
+			}
+		}
+
+		const bool removed = !std::includes(arJob.Entries.begin(), arJob.Entries.end()
+			, Entries.begin(), Entries.end());
+		if (!First && dirty.none() && (arJob.Entries == Entries)) {
+			Stamps = arJob.Stamps;
+			return false;
+		}
+
+		//Entries going away can leave anything unreachable, so start over
+		if (First || removed || (dirty.count() > FULLPAGES)) {
+			Blocks.clear();
+		}
+		else if (dirty.any()) {
+			for ( auto it = Blocks.begin(); it != Blocks.end(); ) {
+				const Block &rblock = it->second;
+				bool bdrop = (rblock.Flags & INDIRECT) != 0;	//Pointer could be anywhere
+				for ( uint32_t page = rblock.Start / Shadow::PAGESIZE; !bdrop && (page <= (rblock.End - 1) / Shadow::PAGESIZE); ++page) {
+					bdrop = dirty[page];
+				}
+				it = bdrop ? Blocks.erase(it) : std::next(it);
+			}
+		}
+
+		Image = arJob.Image;
+		Stamps = arJob.Stamps;
+		Entries = arJob.Entries;
+		First = false;
+		return true;
+	}
+
+	//----------------------------------------------------------------
+	///Walk from the entry points and the successors of blocks we kept
+	void Walk(  )
+	{
+		std::vector<uint32_t> work(Entries.begin(), Entries.end());
+		for ( const auto &[start, block] : Blocks ) {
+			work.push_back(block.Next);
+			work.push_back(block.Target);
+		}
+
+		while (!work.empty()) {
+			const uint32_t addr = work.back();
+			work.pop_back();
+			if ((addr >= NONE) || !Stamps[addr / Shadow::PAGESIZE]) {
+				continue;
+			}
+
+			//Already a block, or inside one so split it
+			if (auto it = Blocks.upper_bound(static_cast<uint16_t>(addr)); it != Blocks.begin()) {
+				--it;
+				if (it->first == addr) {
+					continue;
+				}
+				if ((addr < it->second.End) && Split(it->second, static_cast<uint16_t>(addr))) {
+					continue;
+				}
+			}
+			Decode(static_cast<uint16_t>(addr), work);
+		}
+	}
+
+	//----------------------------------------------------------------
+	///Split block at given address if an instruction starts there
+	/// Return false if the address is in the middle of an instruction
+	bool Split( Block &arBlock, uint16_t aAddress )
+	{
+		uint32_t addr = arBlock.Start;
+		uint32_t prev = addr;
+		while (addr < aAddress) {
+			prev = addr;
+			addr += Size(addr);
+		}
+		if (addr != aAddress) {
+			return false;
+		}
+
+		Block tail = arBlock;
+		tail.Start = aAddress;
+		arBlock.Last = static_cast<uint16_t>(prev);
+		arBlock.End = aAddress;
+		arBlock.Next = aAddress;
+		arBlock.Target = NONE;
+		arBlock.Flags = 0;
+		Blocks.emplace(aAddress, tail);
+		return true;
+	}
+
+	//----------------------------------------------------------------
+	///Decode a new block from given address and queue its successors
+	void Decode( uint16_t aStart, std::vector<uint32_t> &arWork )
+	{
+		Block block{ aStart, aStart, aStart, NONE, NONE, aStart, 0 };
+		uint32_t addr = aStart;
+		for ( ;; ) {
+			//Ran into another block
+			if ((addr != aStart) && Blocks.count(static_cast<uint16_t>(addr))) {
+				block.Next = addr;
+				break;
+			}
+			//Ran into memory we don't have, come back when we do
+			if ((addr >= NONE) || !Stamps[addr / Shadow::PAGESIZE]) {
+				block.Next = addr;
+				block.Flags |= STOP;
+				break;
+			}
+
+			const uint8_t op = Image[addr];
+			const OpCode &rop = OpCode::Get(op);
+			const uint32_t next = addr + rop.QSize();
+			if ((rop == "BAD") || (next > NONE)) {
+				block.Flags |= STOP;
+				break;
+			}
+			block.Last = static_cast<uint16_t>(addr);
+			block.End = next;
+
+			if (op == 0x4c) {							//JMP $xxxx
+				block.Target = Word(addr + 1);
+				block.Flags |= JUMP;
+			}
+			else if (op == 0x6c) {						//JMP ($xxxx)
+				block.Flags |= JUMP | INDIRECT;
+				const uint16_t pointer = Word(addr + 1);
+				if (Stamps[pointer / Shadow::PAGESIZE]) {
+					//The 6502 doesn't carry into the high byte of the pointer
+					block.Target = Image[pointer] | (Image[(pointer & 0xff00) | ((pointer + 1) & 0xff)] << 8);
+				}
+			}
+			else if (op == 0x20) {						//JSR $xxxx
+				block.Target = Word(addr + 1);
+				block.Next = next;
+				block.Flags |= CALL;
+			}
+			else if ((op == 0x40) || (op == 0x60)) {	//RTI, RTS
+				block.Flags |= RETURN;
+			}
+			else if (op == 0x00) {						//BRK
+				block.Flags |= STOP;
+			}
+			else if (rop.eMode == ADDRESS_MODE::RELATIVE) {
+				block.Target = (next + static_cast<int8_t>(Image[addr + 1])) & 0xffff;
+				block.Next = next;
+				block.Flags |= BRANCH;
+			}
+			else {
+				addr = next;
+				continue;
+			}
+			break;
+		}
+
+		//Nothing decoded if the first byte was bad
+		if (block.End != aStart) {
+			Blocks.emplace(aStart, block);
+			arWork.push_back(block.Next);
+			arWork.push_back(block.Target);
+		}
+	}
+
+	//----------------------------------------------------------------
+	///Drop blocks no entry point reaches any more
+	void Prune(  )
+	{
+		std::vector<bool> seen(NONE, false);
+		std::vector<uint32_t> work(Entries.begin(), Entries.end());
+		while (!work.empty()) {
+			const uint32_t addr = work.back();
+			work.pop_back();
+			if ((addr < NONE) && !seen[addr]) {
+				seen[addr] = true;
+				if (auto it = Blocks.find(static_cast<uint16_t>(addr)); it != Blocks.end()) {
+					work.push_back(it->second.Next);
+					work.push_back(it->second.Target);
+				}
+			}
+		}
+		std::erase_if(Blocks, [&]( const auto &arEntry ) { return !seen[arEntry.first]; });
+	}
+
+	//----------------------------------------------------------------
+	///Flatten blocks and work out subroutines and calls
+	std::shared_ptr<Graph> MakeGraph(  )
+	{
+		auto pgraph = std::make_shared<Graph>();
+		auto &rblocks = pgraph->Blocks;
+		rblocks.reserve(Blocks.size());
+		std::vector<uint16_t> roots;
+		for ( const auto &[start, block] : Blocks ) {
+			rblocks.push_back(block);
+			if ((block.Flags & CALL) && (block.Target < NONE)) {
+				roots.push_back(static_cast<uint16_t>(block.Target));
+			}
+		}
+		std::sort(roots.begin(), roots.end());
+		roots.erase(std::unique(roots.begin(), roots.end()), roots.end());
+		for ( auto root : roots ) {
+			if (size_t i = Find(rblocks, root); i < rblocks.size()) {
+				rblocks[i].Flags |= SUBROUTINE;
+			}
+		}
+
+		//Each subroutine owns what it reaches without calling, then entry
+		// points own what is left
+		roots.insert(roots.end(), Entries.begin(), Entries.end());
+		std::vector<bool> owned(rblocks.size(), false);
+		std::vector<uint32_t> work;
+		for ( auto root : roots ) {
+			work.push_back(root);
+			while (!work.empty()) {
+				const size_t i = Find(rblocks, work.back());
+				work.pop_back();
+				if ((i == rblocks.size()) || owned[i]) {
+					continue;
+				}
+				Block &rblock = rblocks[i];
+				if ((rblock.Flags & SUBROUTINE) && (rblock.Start != root)) {
+					continue;
+				}
+				owned[i] = true;
+				rblock.Owner = root;
+				work.push_back(rblock.Next);
+				if (!(rblock.Flags & CALL)) {
+					work.push_back(rblock.Target);
+				}
+			}
+		}
+
+		for ( const auto &rblock : rblocks ) {
+			if ((rblock.Flags & CALL) && (rblock.Target < NONE)) {
+				pgraph->Calls.push_back({ static_cast<uint16_t>(rblock.Target), rblock.Last, rblock.Owner });
+			}
+		}
+		std::sort(pgraph->Calls.begin(), pgraph->Calls.end(), []( const Call &arA, const Call &arB ) {
+			return (arA.Target != arB.Target) ? arA.Target < arB.Target : arA.Site < arB.Site;
+		});
+		return pgraph;
+	}
+};
+
+//----------------------------------------------------------------
+///Runs the Analyser on the latest job in a thread of its own
+class Worker
+{
+public:
+	//----------------------------------------------------------------
+	Worker(  ) : MyThread(&Worker::Runner, this) { }
+
+	//----------------------------------------------------------------
+	~Worker(  )
+	{
+		{
+			UniqueLock lock(Guard);
+			StopRequest = true;
+		}
+		Trigger.notify_one();
+		MyThread.join();
+	}
+
+	//----------------------------------------------------------------
+	///Queue a job, replacing any the worker hasn't started
+	void Post( std::unique_ptr<Job> apJob )
+	{
+		{
+			UniqueLock lock(Guard);
+			pPending = std::move(apJob);
+		}
+		Trigger.notify_one();
+	}
+
+	//----------------------------------------------------------------
+	///Get the latest results, nullptr if none since the last call
+	std::shared_ptr<Graph> Take(  )
+	{
+		UniqueLock lock(Guard);
+		return std::move(pResult);
+	}
+
+private:
+	Analyser MyAnalyser;
+	std::mutex Guard;
+	std::condition_variable Trigger;
+	std::unique_ptr<Job> pPending;
+	std::shared_ptr<Graph> pResult;
+	bool StopRequest = false;
+	std::thread MyThread;						//Last so everything above exists when it starts
+
+	//----------------------------------------------------------------
+	void Runner(  )
+	{
+		for ( ;; ) {
+			std::unique_ptr<Job> pjob;
+			{
+				UniqueLock lock(Guard);
+				Trigger.wait(lock, [&] { return StopRequest || pPending; });
+				if (StopRequest) {
+					return;
+				}
+				pjob = std::move(pPending);
+			}
+
+			if (auto pgraph = MyAnalyser.Run(*pjob); pgraph) {
+				UniqueLock lock(Guard);
+				pResult = pgraph;
+			}
+		}
+	}
+};
+
+std::unique_ptr<Worker> pWorker;
+std::shared_ptr<Graph> pGraph = std::make_shared<Graph>();	//Results in use
+uint32_t Stamp = 0;								//Incremented when results are picked up
+uint32_t ShadowStamp = 0;						//Sources of the last job
+uint32_t LabelStamp = 0;
+uint32_t MarkStamp = 0;
+uint32_t ProgramStart = NONE;
+std::vector<uint16_t> BreakA;
+
+//----------------------------------------------------------------
+///Copy the Shadow image and gather the entry points
+std::unique_ptr<Job> MakeJob(  )
+{
+	auto pjob = std::make_unique<Job>();
+	memcpy(pjob->Image.data(), Shadow::QImage(), Shadow::IMAGESIZE);
+	for ( uint32_t page = 0; page < Shadow::NUMPAGES; ++page) {
+		const uint32_t base = page * Shadow::PAGESIZE;
+		pjob->Stamps[page] = Shadow::QStamp(static_cast<uint16_t>(base), static_cast<uint16_t>(base + Shadow::PAGESIZE - 1));
+	}
+
+	auto &rentries = pjob->Entries;
+	rentries = BreakA;
+	if (ProgramStart < NONE) {
+		rentries.push_back(static_cast<uint16_t>(ProgramStart));
+	}
+	Labels::ForEach([&]( uint16_t aValue, const char * ) {
+		if (QEntryLabel(aValue)) {
+			rentries.push_back(aValue);
+		}
+		return true;
+	});
+	for ( auto mark : Regions::QCodeMarks() ) {
+		rentries.push_back(mark);
+	}
+	for ( auto vector : VectorA ) {
+		if (pjob->Stamps[vector / Shadow::PAGESIZE]) {
+			rentries.push_back(pjob->Image[vector] | (pjob->Image[vector + 1] << 8));
+		}
+	}
+	std::sort(rentries.begin(), rentries.end());
+	rentries.erase(std::unique(rentries.begin(), rentries.end()), rentries.end());
+	return pjob;
+}
+
+//----------------------------------------------------------------
+void Update(  )
+{
+	if (!pWorker) {
+		pWorker = std::make_unique<Worker>();
+	}
+
+	if (auto pgraph = pWorker->Take(); pgraph) {
+		pGraph = pgraph;
+		++Stamp;
+	}
+
+	std::vector<uint16_t> breaks;
+	BreakPoints::ForEach([&]( uint16_t aAddress, bool ) {
+		if (BreakPoints::QBreakPoint(aAddress)) {
+			breaks.push_back(aAddress);
+		}
+		return true;
+	});
+	std::sort(breaks.begin(), breaks.end());
+
+	const uint32_t shadow = Shadow::QStamp(0, 0xffff);
+	const uint32_t labels = Labels::QStamp();
+	const uint32_t marks = Regions::QMarkStamp();
+	const uint32_t start = Program::QStart();
+	if ((shadow != ShadowStamp) || (labels != LabelStamp) || (marks != MarkStamp) || (start != ProgramStart)
+		|| (breaks != BreakA)) {
+		ShadowStamp = shadow;
+		LabelStamp = labels;
+		MarkStamp = marks;
+		ProgramStart = start;
+		BreakA = std::move(breaks);
+		pWorker->Post(MakeJob());
+	}
+}
+
+//----------------------------------------------------------------
+uint32_t QStamp(  )
+{
+	return Stamp;
+}
+
+//----------------------------------------------------------------
+const std::vector<Block> &QBlocks(  )
+{
+	return pGraph->Blocks;
+}
+
+//----------------------------------------------------------------
+const Block *QBlock( uint16_t aAddress )
+{
+	const auto &rblocks = pGraph->Blocks;
+	auto it = std::upper_bound(rblocks.begin(), rblocks.end(), aAddress
+		, []( uint16_t aValue, const Block &arBlock ) { return aValue < arBlock.Start; });
+	if (it != rblocks.begin()) {
+		--it;
+		if (aAddress < it->End) {
+			return &*it;
+		}
+	}
+	return nullptr;
+}
+
+//----------------------------------------------------------------
+bool QBlockStart( uint16_t aAddress )
+{
+	return Find(pGraph->Blocks, aAddress) < pGraph->Blocks.size();
+}
+
+//----------------------------------------------------------------
+std::vector<uint16_t> QCallers( uint16_t aTarget )
+{
+	std::vector<uint16_t> sites;
+	const auto &rcalls = pGraph->Calls;
+	auto it = std::lower_bound(rcalls.begin(), rcalls.end(), aTarget
+		, []( const Call &arCall, uint16_t aValue ) { return arCall.Target < aValue; });
+	for ( ; (it != rcalls.end()) && (it->Target == aTarget); ++it) {
+		sites.push_back(it->Site);
+	}
+	return sites;
+}
+
+//----------------------------------------------------------------
+std::vector<uint16_t> QCallees( uint16_t aOwner )
+{
+	std::vector<uint16_t> targets;
+	for ( const auto &rcall : pGraph->Calls ) {
+		//Calls are sorted by target so each is only added once
+		if ((rcall.Owner == aOwner) && (targets.empty() || (targets.back() != rcall.Target))) {
+			targets.push_back(rcall.Target);
+		}
+	}
+	return targets;
+}
+
+//----------------------------------------------------------------
+bool QEntryLabel( uint16_t aAddress )
+{
+	return (aAddress >= LOWEST) && ((aAddress < IOSTART) || (aAddress > IOEND));
+}
+
+//----------------------------------------------------------------
+std::vector<Block> Analyse( const uint8_t *apImage, const PageSet &arPages, std::vector<uint16_t> aEntries )
+{
+	auto pjob = std::make_unique<Job>();
+	memcpy(pjob->Image.data(), apImage, Shadow::IMAGESIZE);
+	for ( uint32_t page = 0; page < Shadow::NUMPAGES; ++page) {
+		pjob->Stamps[page] = arPages[page];		//Any non zero stamp means we have the page
+	}
+	std::sort(aEntries.begin(), aEntries.end());
+	aEntries.erase(std::unique(aEntries.begin(), aEntries.end()), aEntries.end());
+	pjob->Entries = std::move(aEntries);
+
+	auto panalyser = std::make_unique<Analyser>();	//Holds a copy of the image, too big for the stack
+	auto pgraph = panalyser->Run(*pjob);
+	return pgraph ? std::move(pgraph->Blocks) : std::vector<Block>();
+}
+
+//----------------------------------------------------------------
+void ShutDown(  )
+{
+	pWorker = nullptr;
+}
+
+}	//namespace Flow
@@ -0,0 +1,132 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Flow.h
+//----------------------------------------------------------------------
+
+
+#pragma once
+
+#include "types.h"
+
+#include <bitset>
+#include <vector>
+
+///Static control flow analysis of the computer's main memory. Code is
+/// walked from entry points (program start, labels, code marked in
+/// Regions, the IRQ/BRK/NMI vectors at $0314 and $FFFA and execution
+/// breakpoints) following jumps, calls and branches into basic blocks.
+/// JSR targets are subroutines and each block belongs to the subroutine
+/// that reaches it first, which gives the call graph.
+/// The walk runs on a background thread over a copy of the Shadow image
+/// and only redoes pages whose bytes changed since the last pass.
+/// Results are swapped in by Update, so pointers returned here stay
+/// good until the next call to Update.
+namespace Flow
+{
+
+constexpr uint32_t NONE = 0x10000;				//No successor
+
+using PageSet = std::bitset<0x100>;				//Bit per page of memory
+
+//Block flags
+constexpr uint8_t BRANCH = 0x01;				//Ends in a conditional branch
+constexpr uint8_t JUMP = 0x02;					//Ends in JMP
+constexpr uint8_t CALL = 0x04;					//Ends in JSR
+constexpr uint8_t RETURN = 0x08;				//Ends in RTS or RTI
+constexpr uint8_t INDIRECT = 0x10;				//Target read through a pointer
+constexpr uint8_t STOP = 0x20;					//BRK, bad opcode or memory we don't have
+constexpr uint8_t SUBROUTINE = 0x40;			//Start is a JSR target
+
+//----------------------------------------------------------------
+///Straight line run of instructions with one way in
+struct Block
+{
+	uint16_t Start;								//First instruction
+	uint16_t Last;								//Last instruction
+	uint32_t End;								//Address after the last instruction
+	uint32_t Next;								//Fall through successor or NONE
+	uint32_t Target;							//Branch, jump or call target or NONE
+	uint16_t Owner;								//Start of the subroutine holding the block
+	uint8_t Flags;
+};
+
+//----------------------------------------------------------------
+///JSR from Site in the subroutine Owner to Target
+struct Call
+{
+	uint16_t Target;
+	uint16_t Site;
+	uint16_t Owner;
+};
+
+//----------------------------------------------------------------
+///Hand the analyser new memory or entry points and pick up its results.
+/// Call once a frame
+void Update(  );
+
+//----------------------------------------------------------------
+///Return a stamp that changes whenever new results are picked up
+uint32_t QStamp(  );
+
+//----------------------------------------------------------------
+///Get all blocks sorted by start address
+const std::vector<Block> &QBlocks(  );
+
+//----------------------------------------------------------------
+///Get block holding the given address, nullptr if none
+const Block *QBlock( uint16_t aAddress );
+
+//----------------------------------------------------------------
+///Return true if a block starts at the given address
+bool QBlockStart( uint16_t aAddress );
+
+//----------------------------------------------------------------
+///Get addresses of the JSRs that call the given address
+std::vector<uint16_t> QCallers( uint16_t aTarget );
+
+//----------------------------------------------------------------
+///Get the subroutines called from the given subroutine
+std::vector<uint16_t> QCallees( uint16_t aOwner );
+
+//----------------------------------------------------------------
+///Return true if a label at the given address is taken as a code
+/// entry point rather than data or an I/O register
+bool QEntryLabel( uint16_t aAddress );
+
+//----------------------------------------------------------------
+///Walk an image that isn't the live memory, such as a .prg file, on the
+/// calling thread. Only pages in arPages are read. May run on several
+/// threads at once. Return blocks sorted by start address
+std::vector<Block> Analyse( const uint8_t *apImage, const PageSet &arPages, std::vector<uint16_t> aEntries );
+
+//----------------------------------------------------------------
+///Stop the analyser thread
+void ShutDown(  );
+
+}	//namespace Flow
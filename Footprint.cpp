@@ -0,0 +1,234 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Footprint.cpp
+//----------------------------------------------------------------------
+
+
+#include "Footprint.h"
+#include "6502.h"
+#include "Banks.h"
+#include "Registers.h"
+#include "Shadow.h"
+
+namespace Footprint
+{
+
+constexpr uint32_t MAXRANGES = 8;
+constexpr uint16_t STACK = 0x0100;
+constexpr uint16_t IOSTART = 0xd000;			//VIC, SID, colour RAM and CIAs change by themselves
+constexpr uint16_t IOEND = 0xdfff;
+constexpr uint16_t PORTEND = 0x0001;			//CPU port
+
+//----------------------------------------------------------------
+///Inclusive address range
+struct Range
+{
+	uint16_t Start;
+	uint16_t End;
+
+	bool Overlaps( const Range &arRange ) const
+	{ return (arRange.Start <= End) && (arRange.End >= Start); }
+};
+
+Range WriteA[MAXRANGES];						//Memory the pending step may write
+uint32_t Writes = 0;
+Range HitA[MAXRANGES];							//Store CheckPoints hit by the step
+uint32_t Hits = 0;
+uint32_t Steps = 0;								//Steps sent since last execution
+bool Known = false;								//True if WriteA covers all changes
+bool Banking = false;							//The step may store to the CPU port and switch ROM/IO
+
+//----------------------------------------------------------------
+void Add( Range *apRanges, uint32_t &arCount, uint16_t aStart, uint16_t aEnd )
+{
+	if (arCount < MAXRANGES) {
+		apRanges[arCount++] = { aStart, aEnd };
+	}
+	else {
+		Known = false;							//Lost track, refetch everything
+	}
+}
+
+//----------------------------------------------------------------
+///Get a zero page pointer from the Shadow, false if we don't have it
+bool Pointer( const uint8_t *apImage, uint8_t aZeroPage, uint16_t &arPointer )
+{
+	if (!Shadow::QValid(0, 0xff)) return false;
+	arPointer = static_cast<uint16_t>(apImage[aZeroPage] | (apImage[static_cast<uint8_t>(aZeroPage + 1)] << 8));
+	return true;
+}
+
+//----------------------------------------------------------------
+///Work out the address an instruction stores to. Return false if it
+/// can't be known, true with arStores false if it doesn't store
+bool Target( const uint8_t *apImage, const Registers::CPU &arCPU, bool &arStores, uint16_t &arAddress )
+{
+	const uint16_t ip = arCPU.IP;
+	const auto &op = OpCode::Get(apImage[ip]);
+	const uint8_t lo = apImage[static_cast<uint16_t>(ip + 1)];
+	const uint16_t operand = static_cast<uint16_t>(lo | (apImage[static_cast<uint16_t>(ip + 2)] << 8));
+
+	//Unstable opcodes aren't in the table so their writes are unknown
+	if (op == "BAD") return false;
+
+	arStores = (op.eMode != ADDRESS_MODE::NONE)
+		&& ((op == "STA") || (op == "STX") || (op == "STY") || (op == "SAX")
+		|| (op == "INC") || (op == "DEC")
+		|| (op == "ASL") || (op == "LSR") || (op == "ROL") || (op == "ROR")
+		|| (op == "SLO") || (op == "RLA") || (op == "SRE") || (op == "RRA")
+		|| (op == "DCP") || (op == "ISC"));
+	if (!arStores) return true;
+
+	uint16_t pointer = 0;
+	switch (op.eMode) {
+		case ADDRESS_MODE::ZERO_PAGE:
+			arAddress = lo;
+			break;
+		case ADDRESS_MODE::ZERO_PAGE_X:
+			arAddress = static_cast<uint8_t>(lo + arCPU.XR);
+			break;
+		case ADDRESS_MODE::ZERO_PAGE_Y:
+			arAddress = static_cast<uint8_t>(lo + arCPU.YR);
+			break;
+		case ADDRESS_MODE::ABSOLUTE:
+			arAddress = operand;
+			break;
+		case ADDRESS_MODE::ABSOLUTE_X:
+			arAddress = static_cast<uint16_t>(operand + arCPU.XR);
+			break;
+		case ADDRESS_MODE::ABSOLUTE_Y:
+			arAddress = static_cast<uint16_t>(operand + arCPU.YR);
+			break;
+		case ADDRESS_MODE::INDIRECT_X:
+			if (!Pointer(apImage, static_cast<uint8_t>(lo + arCPU.XR), pointer)) return false;
+			arAddress = pointer;
+			break;
+		case ADDRESS_MODE::INDIRECT_Y:
+			if (!Pointer(apImage, lo, pointer)) return false;
+			arAddress = static_cast<uint16_t>(pointer + arCPU.YR);
+			break;
+		default:
+			return false;
+	}
+	return true;
+}
+
+//----------------------------------------------------------------
+void Step( bool abOver )
+{
+	Known = false;
+	Banking = false;
+	Writes = 0;
+	if (++Steps > 1) return;					//Registers are out of date until the last step stops
+
+	const auto cpu = Registers::QCPU();
+	const auto last = static_cast<uint16_t>(cpu.IP + 2);
+	if (!Shadow::QValid(cpu.IP, cpu.IP) || !Shadow::QValid(last, last)) return;
+
+	const uint8_t *pimage = Shadow::QImage();
+	if (abOver && (OpCode::Get(pimage[cpu.IP]) == "JSR")) return;	//Runs the whole subroutine
+
+	bool stores = false;
+	uint16_t address = 0;
+	if (!Target(pimage, cpu, stores, address)) return;
+
+	Known = true;
+	if (stores) {
+		Add(WriteA, Writes, address, address);
+		Banking = address <= PORTEND;
+	}
+	//Pushes by the instruction or an interrupt taken during it, the
+	// whole stack page if they wrap
+	if (cpu.SP >= 2) {
+		Add(WriteA, Writes, static_cast<uint16_t>(STACK + cpu.SP - 2), static_cast<uint16_t>(STACK + cpu.SP));
+	}
+	else {
+		Add(WriteA, Writes, STACK, STACK + 0xff);
+	}
+	Add(WriteA, Writes, 0, PORTEND);
+	Add(WriteA, Writes, IOSTART, IOEND);
+}
+
+//----------------------------------------------------------------
+void Hit( uint16_t aStart, uint16_t aEnd )
+{
+	Add(HitA, Hits, aStart, aEnd);
+}
+
+//----------------------------------------------------------------
+void Run(  )
+{
+	Known = false;
+	Steps = 0;
+	Hits = 0;
+}
+
+//----------------------------------------------------------------
+void Executed(  )
+{
+	//Step predicted what it wrote unless a store hit a range it didn't
+	// expect to write
+	for ( uint32_t i = 0; Known && (i < Hits); ++i) {
+		bool expected = false;
+		for ( uint32_t w = 0; w < Writes; ++w) {
+			expected |= WriteA[w].Overlaps(HitA[i]);
+		}
+		Known = expected;
+	}
+
+	if (Known) {
+		for ( auto space : Shadow::QSpaces() ) {
+			//New banking changes what the CPU sees at $a000-$bfff and $d000-$ffff
+			if (Banking && (space == Banks::MAIN)) {
+				Shadow::Invalidate(0, 0xffff, space);
+			}
+			//The CPU writes through to every bank of the computer
+			else if (Banks::QMemspace(space) == Banks::COMPUTER) {
+				for ( uint32_t w = 0; w < Writes; ++w) {
+					Shadow::Refetch(WriteA[w].Start, WriteA[w].End, space);
+				}
+			}
+			else {
+				//Drives run alongside the computer
+				Shadow::Invalidate(0, 0xffff, space);
+			}
+		}
+	}
+	else {
+		Shadow::Invalidate();
+	}
+
+	Known = false;
+	Banking = false;
+	Steps = 0;
+	Hits = 0;
+	Writes = 0;
+}
+
+}	//namespace Footprint
@@ -0,0 +1,61 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Footprint.h
+//----------------------------------------------------------------------
+
+
+#pragma once
+
+#include "types.h"
+
+///Track the memory execution may have changed so the Shadow can be
+/// brought up to date without asking for everything again. A single
+/// step only writes the bytes of its store target, the stack and I/O,
+/// so only those are refetched. Anything else invalidates the Shadow.
+namespace Footprint
+{
+
+//----------------------------------------------------------------
+///VICE is about to execute one instruction from the current registers.
+/// abOver is true if stepping over a JSR
+void Step( bool abOver );
+
+//----------------------------------------------------------------
+///A store CheckPoint over the given range was hit
+void Hit( uint16_t aStart, uint16_t aEnd );
+
+//----------------------------------------------------------------
+///VICE is running freely, so anything may change
+void Run(  );
+
+//----------------------------------------------------------------
+///VICE executed code and stopped, bring the Shadow up to date
+void Executed(  );
+
+}	//namespace Footprint
@@ -0,0 +1,415 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Heatmap.cpp
+//----------------------------------------------------------------------
+
+#include "Heatmap.h"
+#include "Command.h"
+#include "ImGuiUtils.h"
+#include "Labels.h"
+#include "Memory.h"
+#include "Monitor.h"
+#include "Response.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <imgui.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Heatmap
+{
+
+constexpr uint32_t MAPSIZE = 0x100;				//Map is MAPSIZE x MAPSIZE, one square per address
+constexpr uint32_t MAXCELLS = 0x100;			//Most checkpoints we will place
+constexpr uint32_t CELLBUDGET = 0x40;			//Hits per second before a cell is disabled
+constexpr uint32_t TOTALBUDGET = 0x200;			//Hits per second for all cells before the hottest is disabled
+constexpr auto WINDOW = std::chrono::seconds(1);	//Period hit rates are measured over
+constexpr auto COOLDOWN = std::chrono::seconds(3);	//Time a cell stays disabled before sampling again
+constexpr uint8_t STORE = 1_bit;				//Checkpoint operation
+
+using Clock = std::chrono::steady_clock;
+
+//CHECKPOINT_INFO body offsets
+constexpr uint32_t INFO_INDEX = 0;
+constexpr uint32_t INFO_HITCOUNT = 13;
+
+//----------------------------------------------------------------
+///A write checkpoint over a range of addresses
+struct Cell
+{
+	CommandPtr pCommand;						//Command used to control the checkpoint
+	uint32_t Index = 0xffffffff;				//VICE checkpoint number
+	uint32_t HitCount = 0;						//Last hit count reported by VICE
+	uint32_t WindowHits = 0;					//Hits during the current rate window
+	Clock::time_point DisabledAt;				//When the cell was disabled for going over budget
+	uint16_t Start = 0;
+	uint16_t End = 0;
+	bool Enabled = true;
+
+	bool Legit(  ) const { return Index != 0xffffffff; }
+
+	//----------------------------------------------------------------
+	///Send VICE command to set enable state
+	void Enable( bool abTF )
+	{
+		if (Legit() && (Enabled != abTF)) {
+			Enabled = abTF;
+			pCommand->SetCommand(COMMAND::CHECKPOINT_TGL);
+			pCommand->Reset();
+			pCommand->Add(Index);
+			pCommand->Add(static_cast<uint8_t>(Enabled));
+			Monitor::Send(pCommand);
+		}
+	}
+};
+
+std::vector<Cell> Cells;
+std::unordered_map<uint32_t, uint32_t> CellIDs;	//Command ID or VICE index to cell
+std::vector<uint32_t> Counts;					//Writes seen per cell, kept when disarmed
+uint16_t CountStart = 0;						//Region Counts cover
+uint16_t CountEnd = 0;
+uint32_t CountShift = 0;						//Cell size of Counts is 1 << CountShift
+uint32_t MaxCount = 0;							//Highest value in Counts
+uint32_t WindowHits = 0;						//Hits from all cells during rate window
+uint32_t Throttled = 0;							//Number of cells disabled for going over budget
+Clock::time_point WindowStart = Clock::now();
+bool Enabled = false;							//Window enabled
+uint16_t RegionStart = 0x0400;
+uint16_t RegionEnd = 0x07ff;
+int32_t CellShift = 4;							//Cell size is 1 << CellShift
+
+//----------------------------------------------------------------
+///Place checkpoints over the region. The cell size is raised if
+/// needed so we use no more than MAXCELLS checkpoints
+void Arm(  )
+{
+	Disarm();
+
+	const uint32_t len = RegionEnd - RegionStart + 1;
+	while ((len >> CellShift) >= MAXCELLS) {
+		++CellShift;
+	}
+	const uint32_t cellSize = bit(CellShift);
+
+	//Counts of other cells can't be carried over
+	Counts.assign(((len - 1) >> CellShift) + 1, 0);
+	CountStart = RegionStart;
+	CountEnd = RegionEnd;
+	CountShift = CellShift;
+	MaxCount = 0;
+
+	for ( uint32_t addr = RegionStart; addr <= RegionEnd; addr += cellSize) {
+		Cell cell;
+		cell.Start = static_cast<uint16_t>(addr);
+		cell.End = static_cast<uint16_t>(std::min<uint32_t>(addr + cellSize - 1, RegionEnd));
+		cell.pCommand = CommandPtr(new Command(COMMAND::CHECKPOINT_SET));
+		cell.pCommand->Add(cell.Start);			//Start address
+		cell.pCommand->Add(cell.End);			//End address
+		cell.pCommand->Add(0_u8);				//Don't stop when hit
+		cell.pCommand->Add(1_u8);				//Enabled
+		cell.pCommand->Add(STORE);				//Writes only
+		cell.pCommand->Add(0_u16);				//Not temporary and memspace 0
+		CellIDs[cell.pCommand->QID()] = static_cast<uint32_t>(Cells.size());
+		Monitor::Send(cell.pCommand);
+		Cells.push_back(std::move(cell));
+	}
+	WindowStart = Clock::now();
+	WindowHits = 0;
+	Throttled = 0;
+}
+
+//----------------------------------------------------------------
+void Disarm(  )
+{
+	for ( auto &cell : Cells ) {
+		if (cell.Legit()) {
+			cell.pCommand->SetCommand(COMMAND::CHECKPOINT_DEL);
+			cell.pCommand->Reset();
+			cell.pCommand->Add(cell.Index);
+			Monitor::Send(cell.pCommand);
+		}
+	}
+	Cells.clear();
+	CellIDs.clear();
+	Throttled = 0;
+}
+
+//----------------------------------------------------------------
+///Zero the counters
+void Clear(  )
+{
+	std::fill(Counts.begin(), Counts.end(), 0);
+	MaxCount = 0;
+}
+
+//----------------------------------------------------------------
+///Check hit rates at the end of each window. Cells over budget are
+/// disabled and those that have cooled down are enabled to sample again
+void Throttle(  )
+{
+	const auto now = Clock::now();
+	if (now - WindowStart < WINDOW) return;
+
+	//If all cells together are over budget, disable the hottest
+	if (WindowHits > TOTALBUDGET) {
+		auto hottest = std::max_element(Cells.begin(), Cells.end(), []( const Cell &arA, const Cell &arB ) {
+			return arA.WindowHits < arB.WindowHits;
+		});
+		hottest->WindowHits = std::max(hottest->WindowHits, CELLBUDGET + 1);
+	}
+
+	Throttled = 0;
+	for ( auto &cell : Cells ) {
+		if (cell.Enabled) {
+			if (cell.WindowHits > CELLBUDGET) {
+				cell.Enable(false);
+				cell.DisabledAt = now;
+			}
+		}
+		else if (now - cell.DisabledAt >= COOLDOWN) {
+			cell.Enable(true);
+		}
+		Throttled += !cell.Enabled;
+		cell.WindowHits = 0;
+	}
+	WindowStart = now;
+	WindowHits = 0;
+}
+
+//----------------------------------------------------------------
+bool ProcessInfo( const Response &arResponse )
+{
+	const uint32_t index = arResponse.Get<uint32_t>(INFO_INDEX);
+
+	//Responses to our set command carry its ID, later ones only the VICE index
+	auto entry = CellIDs.find(arResponse.QID());
+	if (entry == CellIDs.end()) {
+		entry = CellIDs.find(index | 0x80000000);
+	}
+	if (entry == CellIDs.end()) return false;
+
+	Cell &cell = Cells[entry->second];
+	if (!cell.Legit()) {
+		cell.Index = index;
+		CellIDs[index | 0x80000000] = entry->second;	//Keep VICE indices apart from command IDs
+	}
+
+	const uint32_t hitCount = arResponse.Get<uint32_t>(INFO_HITCOUNT);
+	if (hitCount > cell.HitCount) {
+		const uint32_t hits = hitCount - cell.HitCount;
+		uint32_t &rcount = Counts[entry->second];
+		rcount += hits;
+		MaxCount = std::max(MaxCount, rcount);
+		cell.WindowHits += hits;
+		WindowHits += hits;
+	}
+	cell.HitCount = hitCount;
+	return true;
+}
+
+//----------------------------------------------------------------
+///Get index in Counts of the cell holding an address, Counts.size() if
+/// there is none
+size_t CellIndex( uint16_t aAddress )
+{
+	if ((aAddress < CountStart) || (aAddress > CountEnd)) {
+		return Counts.size();
+	}
+	return std::min(static_cast<size_t>(aAddress - CountStart) >> CountShift, Counts.size());
+}
+
+//----------------------------------------------------------------
+///Get number of writes seen in the cell holding an address
+uint32_t QCount( uint16_t aAddress )
+{
+	const size_t index = CellIndex(aAddress);
+	return (index < Counts.size()) ? Counts[index] : 0;
+}
+
+//----------------------------------------------------------------
+///Get color for a count, log scale from dark red to yellow
+ImU32 HeatColor( uint32_t aCount )
+{
+	const float t = std::log2(static_cast<float>(aCount) + 1.0f)
+		/ std::log2(static_cast<float>(MaxCount) + 1.0f);
+	const auto r = static_cast<uint32_t>(64.0f + (191.0f * std::min(t * 2.0f, 1.0f)));
+	const auto g = static_cast<uint32_t>(255.0f * std::max((t * 2.0f) - 1.0f, 0.0f));
+	return IM_COL32(r, g, 0, 255);
+}
+
+//----------------------------------------------------------------
+///Draw the 256x256 map, one row per page. Runs of equal counts on
+/// a row are drawn as a single rectangle
+void DrawMap(  )
+{
+	const ImVec2 avail = ImGui::GetContentRegionAvail();
+	const float scale = std::max(std::min(avail.x, avail.y) / MAPSIZE, 1.0f);
+	const ImVec2 origin = ImGui::GetCursorScreenPos();
+	ImDrawList *pdraw = ImGui::GetWindowDrawList();
+
+	pdraw->AddRectFilled(origin, ImVec2(origin.x + (MAPSIZE * scale), origin.y + (MAPSIZE * scale))
+		, IM_COL32(0, 0, 0, 255));
+
+	if (MaxCount) {
+		for ( uint32_t row = 0; row < MAPSIZE; ++row) {
+			const uint32_t base = row * MAPSIZE;
+			const float y = origin.y + (row * scale);
+			for ( uint32_t col = 0; col < MAPSIZE; ) {
+				const uint32_t count = QCount(static_cast<uint16_t>(base + col));
+				uint32_t run = col + 1;
+				while ((run < MAPSIZE) && (QCount(static_cast<uint16_t>(base + run)) == count)) {
+					++run;
+				}
+				if (count) {
+					pdraw->AddRectFilled(ImVec2(origin.x + (col * scale), y)
+						, ImVec2(origin.x + (run * scale), y + scale), HeatColor(count));
+				}
+				col = run;
+			}
+		}
+	}
+
+	//Outline cells that are disabled for going over budget
+	for ( const auto &cell : Cells ) {
+		if (!cell.Enabled) {
+			for ( uint32_t addr = cell.Start; addr <= cell.End; ++addr) {
+				const float x = origin.x + ((addr % MAPSIZE) * scale);
+				const float y = origin.y + ((addr / MAPSIZE) * scale);
+				pdraw->AddRect(ImVec2(x, y), ImVec2(x + scale, y + scale), IM_COL32(0, 128, 255, 255));
+			}
+		}
+	}
+
+	//Hover shows address and the count of its cell, click shows address in Memory view 0, Ctrl+click view 1
+	ImGui::InvisibleButton("##Map", ImVec2(MAPSIZE * scale, MAPSIZE * scale));
+	if (ImGui::IsItemHovered()) {
+		const ImVec2 mouse = ImGui::GetMousePos();
+		const auto col = std::min(static_cast<uint32_t>((mouse.x - origin.x) / scale), MAPSIZE - 1);
+		const auto row = std::min(static_cast<uint32_t>((mouse.y - origin.y) / scale), MAPSIZE - 1);
+		const auto addr = static_cast<uint16_t>((row * MAPSIZE) + col);
+		const char *plabel = Labels::Find(addr);
+		if (const size_t index = CellIndex(addr); index < Counts.size()) {
+			const uint32_t start = CountStart + (static_cast<uint32_t>(index) << CountShift);
+			const uint32_t end = std::min<uint32_t>(start + bit(CountShift) - 1, CountEnd);
+			ImGui::SetTooltip("$%04x %s\n$%04x-$%04x %u writes", addr, plabel ? plabel : "", start, end, Counts[index]);
+		}
+		else {
+			ImGui::SetTooltip("$%04x %s", addr, plabel ? plabel : "");
+		}
+		if (ImGui::IsItemClicked()) {
+			Memory::SetAddress(CtrlDown() ? 1 : 0, addr);
+		}
+	}
+}
+
+//----------------------------------------------------------------
+void ToJson( nlohmann::json &arData )
+{
+	arData["Heatmap"] = {
+		{"On", Enabled},
+		{"Start", RegionStart},
+		{"End", RegionEnd},
+		{"CellShift", CellShift}
+	};
+}
+
+//----------------------------------------------------------------
+void FromJson( nlohmann::json &arData )
+{
+	auto obj = arData["Heatmap"];
+	if (!obj.is_null()) {
+		Enabled = obj["On"];
+		RegionStart = obj["Start"];
+		RegionEnd = obj["End"];
+		CellShift = obj["CellShift"];
+	}
+}
+
+//----------------------------------------------------------------
+void DisplayOn(  )
+{
+	Enabled = true;
+}
+
+//----------------------------------------------------------------
+void Display(  )
+{
+	if (!Cells.empty()) {
+		Throttle();								//Keep checking rates while hidden
+	}
+
+	if (!Enabled) return;						//Early out if view not visible
+
+	ImGui::SetNextWindowSize(ImVec2(290, 380), ImGuiCond_FirstUseEver);
+	ImGui::Begin("Heatmap", &Enabled);
+
+	const float w = ImGui::GetFontSize();
+	const auto hexFlags = ImGuiInputTextFlags_CharsHexadecimal | ImGuiInputTextFlags_AlwaysOverwrite;
+
+	ImGui::PushItemWidth(w * 3.0f);
+	ImGui::InputScalar("##Start", ImGuiDataType_U16, &RegionStart, nullptr, nullptr, "%04x", hexFlags);
+	ImGui::SameLine();
+	ImGui::Text("-");
+	ImGui::SameLine();
+	ImGui::InputScalar("##End", ImGuiDataType_U16, &RegionEnd, nullptr, nullptr, "%04x", hexFlags);
+	ImGui::PopItemWidth();
+	RegionEnd = std::max(RegionEnd, RegionStart);
+
+	//Cell size as power of 2
+	ImGui::SameLine();
+	ImGui::PushItemWidth(w * 4.0f);
+	ImGui::SliderInt("##Cell", &CellShift, 0, 8, "");
+	ImGui::PopItemWidth();
+	if (ImGui::IsItemHovered()) {
+		ImGui::SetTooltip("Bytes per checkpoint: %u\nWrites are counted per checkpoint", bit(CellShift));
+	}
+
+	if (ImGui::Button(Cells.empty() ? "Arm" : "Re-Arm")) {
+		Arm();
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Disarm")) {
+		Disarm();
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Clear")) {
+		Clear();
+	}
+
+	ImGui::Text("%u checkpoints, %u throttled", static_cast<uint32_t>(Cells.size()), Throttled);
+
+	DrawMap();
+
+	ImGui::End();
+}
+
+}	//namespace Heatmap
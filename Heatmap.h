@@ -0,0 +1,72 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Heatmap.h
+//----------------------------------------------------------------------
+
+#pragma once
+
+#include "types.h"
+#include "json/json.hpp"
+
+class Response;
+
+///Memory write heatmap. Non halting STORE checkpoints are placed over a
+/// region in cells, and each hit adds to the counter of its cell. VICE
+/// can't tell which address in a cell was written, so the 256x256 map
+/// shows every address in a cell with the cell's count. Use a cell size
+/// of 1 for per address counts. Cells hit faster than a budget are disabled
+/// for a while to keep VICE from being swamped by checkpoint responses.
+namespace Heatmap
+{
+
+//----------------------------------------------------------------
+///Save data to Json
+void ToJson( nlohmann::json &arData );
+
+//----------------------------------------------------------------
+///Load data from Json
+void FromJson( nlohmann::json &arData );
+
+//----------------------------------------------------------------
+///Process checkpoint response, return true if it was one of ours
+bool ProcessInfo( const Response &arResponse );
+
+//----------------------------------------------------------------
+///Remove all heatmap checkpoints
+void Disarm(  );
+
+//----------------------------------------------------------------
+///Enable window
+void DisplayOn(  );
+
+//----------------------------------------------------------------
+///Draw window
+void Display(  );
+
+}	//namespace Heatmap
@@ -35,6 +35,7 @@
 #include "Code.h"								//For SetAddress
 #include "ImGuiUtils.h"
 #include "Numbers.h"
+#include "Xref.h"
 
 #include <imgui.h>
 #include <unordered_map>
@@ -53,8 +54,6 @@ namespace Labels
 
 constexpr float LABELLINES = 25.0f;
 
-using LabelMap = std::unordered_map<uint16_t, std::string>;
-
 //----------------------------------------------------------------
 ///Check if apSource starts with apCmp (case-insensitive)
 ///Return apSource adjusted to skip apString or nullptr if no match
@@ -75,6 +74,34 @@ const char *StartsWith( const char *apSource, const char *apCmp )
 	return pres;
 }
 
+//----------------------------------------------------------------
+///Parse up to 4 hex digits followed by a space into arAddress
+///Return apSource adjusted past the space or nullptr on error
+const char *ParseAddress( const char *apSource, uint16_t &arAddress )
+{
+	//Loop for up to 4 chars for address + space "???? "
+	// If no space hit within 5 chars, it's an error
+	for (uint32_t i = 0 ; i < 5; ++i) {
+		char c = *apSource++;
+		//If we ran out of data, error
+		if (!c) {
+			return nullptr;
+		}
+
+		//We are done when we hit a space
+		if (c == ' ') {
+			return apSource;
+		}
+
+		arAddress <<= 4;
+		arAddress += static_cast<uint16_t>(Numbers::ToNum(c));
+	}
+
+	//If we hit here we didn't hit a space within 5 characters, so error
+	arAddress = 0;
+	return nullptr;
+}
+
 //----------------------------------------------------------------
 ///Manage label map.
 /// Load labels from a .vs file.
@@ -166,32 +193,6 @@ private:
 	LabelCombo Filter;							//Filtered list of labels
 	bool Enabled = false;						//Window enabled
 
-	//----------------------------------------------------------------
-	const char *ParseAddress( const char *apSource, uint16_t &arAddress )
-	{
-		//Loop for up to 4 chars for address + space "???? "
-		// If no space hit within 5 chars, it's an error
-		for (uint32_t i = 0 ; i < 5; ++i) {
-			char c = *apSource++;
-			//If we ran out of data, error
-			if (!c) {
-				return nullptr;
-			}
-
-			//We are done when we hit a space
-			if (c == ' ') {
-				return apSource;
-			}
-
-			arAddress <<= 4;
-			arAddress += static_cast<uint16_t>(Numbers::ToNum(c));
-		}
-
-		//If we hit here we didn't hit a space within 5 characters, so error
-		arAddress = 0;
-		return nullptr;
-	}
-
 	//----------------------------------------------------------------
 	///Parse string for label/breakpoint and add to map
 	bool Parse( const char *apSource )
@@ -225,6 +226,8 @@ private:
 using LabelViewPtr = std::unique_ptr<LabelView>;
 
 LabelViewPtr pView(new LabelView());
+std::filesystem::path LabelFile;				//File labels were loaded from
+uint32_t Stamp = 0;								//Incremented on each load
 
 //----------------------------------------------------------------
 ///LabelCombo methods
@@ -331,6 +334,10 @@ uint32_t LabelCombo::Display(  )
 						//Copy selected string to Filter TextInput
 //						strncpy_s(Filter, apLabel, sizeof(Filter));
 					}
+					//The dropdown is a tooltip already
+					if (AlwaysOn && ImGui::IsItemHovered()) {
+						Xref::Tooltip(aKey);
+					}
 					++index;
 				}
 				return true;					//Always do next label
@@ -401,7 +408,41 @@ void FromJson( nlohmann::json &arData )
 //----------------------------------------------------------------
 bool Load( std::filesystem::path aPath )
 {
-	return pView ? pView->Load(aPath.string().c_str()) : false;
+	bool bres = pView ? pView->Load(aPath.string().c_str()) : false;
+	LabelFile = bres ? aPath : std::filesystem::path();
+	++Stamp;									//Labels were cleared even if the load failed
+	return bres;
+}
+
+//----------------------------------------------------------------
+bool Read( const std::filesystem::path &arPath, LabelMap &arMap )
+{
+	std::ifstream labelFile(arPath);
+	if (!labelFile.is_open()) {
+		return false;
+	}
+
+	char inputStream[128];
+	while (labelFile.getline(inputStream, sizeof(inputStream))) {
+		uint16_t address = 0;
+		const char *piter = StartsWith(inputStream, "al C:");
+		if (piter && (piter = ParseAddress(piter, address)) && (*piter == '.')) {
+			arMap[address] = piter + 1;
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------------
+uint32_t QStamp(  )
+{
+	return Stamp;
+}
+
+//----------------------------------------------------------------
+const std::filesystem::path &QFile(  )
+{
+	return LabelFile;
 }
 
 //----------------------------------------------------------------
@@ -422,4 +463,43 @@ const char *Find( uint16_t aValue )
 	return pView ? pView->Find(aValue) : nullptr;
 }
 
+//----------------------------------------------------------------
+bool Find( const char *apName, uint16_t &arValue )
+{
+	bool bres = false;
+	if (pView) {
+		pView->ForEachLabel([&]( uint16_t aKey, const char *apLabel ) {
+			if (!strcmp(apName, apLabel)) {
+				arValue = aKey;
+				bres = true;
+			}
+			return !bres;
+		});
+	}
+	return bres;
+}
+
+//----------------------------------------------------------------
+void ForEach( LABELFN aFunction )
+{
+	if (pView) {
+		pView->ForEachLabel(aFunction);
+	}
+}
+
+//----------------------------------------------------------------
+uint32_t QNext( uint16_t aValue )
+{
+	uint32_t next = 0x10000;
+	if (pView) {
+		pView->ForEachLabel([&]( uint16_t aKey, const char * ) {
+			if ((aKey > aValue) && (aKey < next)) {
+				next = aKey;
+			}
+			return true;
+		});
+	}
+	return next;
+}
+
 }	//namespace Labels
@@ -35,9 +35,15 @@
 #include "json/json.hpp"
 
 #include <filesystem>
+#include <functional>
+#include <string>
+#include <unordered_map>
 
 namespace Labels
 {
+//Return true to continue processing, false to stop
+using LABELFN = std::function<bool(uint16_t aValue, const char *apLabel)>;
+using LabelMap = std::unordered_map<uint16_t, std::string>;
 
 //----------------------------------------------------------------
 ///Displays a combo box with a text filter.
@@ -74,6 +80,19 @@ void FromJson( nlohmann::json &arData );
 ///Load labels from given file
 bool Load( std::filesystem::path aPath );
 
+//----------------------------------------------------------------
+///Read labels from a .vs file into arMap leaving the loaded labels and
+/// breakpoints alone. Safe to call from any thread
+bool Read( const std::filesystem::path &arPath, LabelMap &arMap );
+
+//----------------------------------------------------------------
+///Return a stamp that changes whenever labels are loaded
+uint32_t QStamp(  );
+
+//----------------------------------------------------------------
+///Get file labels were loaded from, empty if none
+const std::filesystem::path &QFile(  );
+
 //----------------------------------------------------------------
 ///Enable window
 void DisplayOn(  );
@@ -86,4 +105,16 @@ void Display(  );
 ///Look up label name for given value, return nullptr if not found
 const char *Find( uint16_t aValue );
 
+//----------------------------------------------------------------
+///Find value of label with given name, return false if not found
+bool Find( const char *apName, uint16_t &arValue );
+
+//----------------------------------------------------------------
+///Call given function for each label in no particular order
+void ForEach( LABELFN aFunction );
+
+//----------------------------------------------------------------
+///Return address of the first label after aValue, or 0x10000 if none
+uint32_t QNext( uint16_t aValue );
+
 }	//namespace Labels
@@ -0,0 +1,174 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Lz.cpp
+//----------------------------------------------------------------------
+
+#include "Lz.h"
+
+#include <string.h>
+
+namespace Lz
+{
+
+constexpr uint32_t MINMATCH = 4;
+constexpr uint32_t MAXOFFSET = 0xff;
+constexpr uint32_t NIBBLE = 0xf;				//Nibble value indicating more length bytes
+constexpr uint32_t HASHBITS = 8;
+
+//----------------------------------------------------------------
+///Hash 4 bytes at apSource
+inline uint32_t Hash( const uint8_t *apSource )
+{
+	uint32_t v;
+	memcpy(&v, apSource, sizeof(v));
+	return (v * 2654435761u) >> (32 - HASHBITS);
+}
+
+//----------------------------------------------------------------
+///Write extra length bytes for a length that didn't fit in a nibble.
+/// Return false if out of room
+bool WriteLength( uint8_t *&arpDest, const uint8_t *apEnd, uint32_t aLen )
+{
+	for ( ; aLen >= 0xff; aLen -= 0xff) {
+		if (arpDest >= apEnd) return false;
+		*arpDest++ = 0xff;
+	}
+	if (arpDest >= apEnd) return false;
+	*arpDest++ = static_cast<uint8_t>(aLen);
+	return true;
+}
+
+//----------------------------------------------------------------
+///Read extra length bytes and add to arLen. Return false if ran out of data
+bool ReadLength( const uint8_t *&arpSource, const uint8_t *apEnd, uint32_t &arLen )
+{
+	uint8_t b;
+	do {
+		if (arpSource >= apEnd) return false;
+		b = *arpSource++;
+		arLen += b;
+	} while (b == 0xff);
+	return true;
+}
+
+//----------------------------------------------------------------
+///Write a sequence of aLits literals followed by a match. aMatch of 0
+/// writes the final literal only sequence. Return false if out of room
+bool WriteSequence( uint8_t *&arpDest, const uint8_t *apEnd, const uint8_t *apLits, uint32_t aLits
+	, uint32_t aOffset, uint32_t aMatch )
+{
+	if (arpDest >= apEnd) return false;
+
+	uint32_t matchLen = aMatch ? aMatch - MINMATCH : 0;
+	uint8_t *ptoken = arpDest++;
+	*ptoken = static_cast<uint8_t>(((aLits < NIBBLE ? aLits : NIBBLE) << 4)
+		| (matchLen < NIBBLE ? matchLen : NIBBLE));
+
+	if ((aLits >= NIBBLE) && !WriteLength(arpDest, apEnd, aLits - NIBBLE)) return false;
+	if (arpDest + aLits > apEnd) return false;
+	memcpy(arpDest, apLits, aLits);
+	arpDest += aLits;
+
+	if (aMatch) {
+		if (arpDest >= apEnd) return false;
+		*arpDest++ = static_cast<uint8_t>(aOffset);
+		if ((matchLen >= NIBBLE) && !WriteLength(arpDest, apEnd, matchLen - NIBBLE)) return false;
+	}
+	return true;
+}
+
+//----------------------------------------------------------------
+uint32_t Compress( const uint8_t *apSource, uint32_t aLen, uint8_t *apDest, uint32_t aDestLen )
+{
+	if (aLen > MAXBLOCK) return 0;
+
+	uint16_t table[bit(HASHBITS)] = { 0 };		//Position + 1 of last 4 bytes with each hash
+	uint8_t *pdest = apDest;
+	const uint8_t *pend = apDest + aDestLen;
+	uint32_t anchor = 0;						//Start of pending literals
+	uint32_t pos = 0;
+
+	while (pos + MINMATCH <= aLen) {
+		uint32_t h = Hash(&apSource[pos]);
+		uint32_t cand = table[h];
+		table[h] = static_cast<uint16_t>(pos + 1);
+
+		//Check candidate is in range and really matches
+		if (cand-- && (pos - cand <= MAXOFFSET) && !memcmp(&apSource[cand], &apSource[pos], MINMATCH)) {
+			uint32_t len = MINMATCH;
+			while ((pos + len < aLen) && (apSource[cand + len] == apSource[pos + len])) {
+				++len;
+			}
+			if (!WriteSequence(pdest, pend, &apSource[anchor], pos - anchor, pos - cand, len)) return 0;
+			pos += len;
+			anchor = pos;
+		}
+		else {
+			++pos;
+		}
+	}
+
+	if (!WriteSequence(pdest, pend, &apSource[anchor], aLen - anchor, 0, 0)) return 0;
+	return static_cast<uint32_t>(pdest - apDest);
+}
+
+//----------------------------------------------------------------
+uint32_t Decompress( const uint8_t *apSource, uint32_t aLen, uint8_t *apDest, uint32_t aDestLen )
+{
+	const uint8_t *psrc = apSource;
+	const uint8_t *psrcEnd = apSource + aLen;
+	uint32_t written = 0;
+
+	while (psrc < psrcEnd) {
+		uint8_t token = *psrc++;
+
+		//Copy literals
+		uint32_t lits = token >> 4;
+		if ((lits == NIBBLE) && !ReadLength(psrc, psrcEnd, lits)) return 0;
+		if ((psrc + lits > psrcEnd) || (written + lits > aDestLen)) return 0;
+		memcpy(&apDest[written], psrc, lits);
+		psrc += lits;
+		written += lits;
+
+		if (psrc == psrcEnd) break;				//Last sequence has no match
+
+		//Copy match, byte at a time as it may overlap itself
+		uint32_t offset = *psrc++;
+		uint32_t len = token & NIBBLE;
+		if ((len == NIBBLE) && !ReadLength(psrc, psrcEnd, len)) return 0;
+		len += MINMATCH;
+		if ((offset == 0) || (offset > written) || (written + len > aDestLen)) return 0;
+		for ( uint32_t i = 0; i < len; ++i, ++written) {
+			apDest[written] = apDest[written - offset];
+		}
+	}
+	return written;
+}
+
+}	//namespace Lz
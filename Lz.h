@@ -0,0 +1,56 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Lz.h
+//----------------------------------------------------------------------
+
+#pragma once
+
+#include "types.h"
+
+///Small LZ4 style compressor for blocks of up to 256 bytes.
+/// Sequences are a token byte (literal count in the high nibble, match
+/// length - 4 in the low nibble, 15 meaning more length bytes follow),
+/// the literals, then a 1 byte match offset. The last sequence has
+/// literals only. Offsets fit in a byte as blocks are at most 256 bytes.
+namespace Lz
+{
+
+constexpr uint32_t MAXBLOCK = 0x100;
+
+//----------------------------------------------------------------
+///Compress aLen bytes from apSource into apDest. Return compressed
+/// size or 0 if it didn't fit in aDestLen bytes
+uint32_t Compress( const uint8_t *apSource, uint32_t aLen, uint8_t *apDest, uint32_t aDestLen );
+
+//----------------------------------------------------------------
+///Decompress aLen bytes from apSource into apDest. Return number of bytes
+/// written or 0 if the data is bad or would overflow aDestLen
+uint32_t Decompress( const uint8_t *apSource, uint32_t aLen, uint8_t *apDest, uint32_t aDestLen );
+
+}	//namespace Lz
@@ -30,13 +30,18 @@
 //----------------------------------------------------------------------
 
 #include "Memory.h"
+#include "Banks.h"
 #include "BreakPoints.h"
 #include "Command.h"
 #include "Labels.h"
 #include "Monitor.h"
 #include "Numbers.h"
-#include "Response.h"
+#include "Shadow.h"
+#include "Simd.h"
+#include "Snapshots.h"
+#include "Xref.h"
 
+#include <algorithm>
 #include <imgui.h>
 #include <memory>
 
@@ -49,7 +54,7 @@
 
 /*{
 todo:
-[ ] Handle views looking at the same memory.
+[x] Handle views looking at the same memory.
   Have all memory views process all memory responses. If
   memory falls in range, then do the update of that memory
 [x] Test allowing edit of both Hex and Ascii. Not worth doing ascii
@@ -62,19 +67,29 @@ namespace Memory
 {
 
 constexpr uint32_t BYTESPERLINE = 0x10;
-constexpr uint32_t MEMLINES = 0x14;
+constexpr uint32_t MINLINES = 0x4;
+constexpr uint32_t MAXLINES = 0x40;				//Most lines a view can be sized to, row masks are 64 bit
+constexpr uint32_t DEFLINES = 0x14;
 constexpr uint32_t HEXLINELEN = BYTESPERLINE * 3;
-constexpr uint32_t HEXVIEWSIZE = MEMLINES * HEXLINELEN;
+constexpr uint32_t HEXVIEWSIZE = MAXLINES * HEXLINELEN;
 constexpr uint32_t ADDRLINELEN = 5;
 constexpr uint32_t ASCIILINELEN = BYTESPERLINE + 1;
-constexpr uint32_t ASCIIVIEWSIZE = MEMLINES * ASCIILINELEN;
-constexpr uint32_t MEMBLOCKSIZE = BYTESPERLINE * MEMLINES;
-constexpr uint16_t LASTADDRESS = 0x10000 - MEMBLOCKSIZE;
+constexpr uint32_t ASCIIVIEWSIZE = MAXLINES * ASCIILINELEN;
+constexpr uint32_t MEMBLOCKSIZE = BYTESPERLINE * MAXLINES;
+constexpr uint32_t PREFETCH = 0x400;			//Bytes fetched ahead of the view in the scroll direction
+constexpr uint32_t WHEELLINES = 3;				//Lines scrolled per mouse wheel notch
 constexpr uint32_t NUMVIEWS = 2;
-constexpr uint32_t WAITCOUNT = 60;
+constexpr float WIDTH = 630.0f;					//Window width, only the height can be changed
+constexpr uint32_t LIVE = 0xffffffff;			//History value when showing live memory
 
 //----------------------------------------------------------------
-/// View into 16x20 bytes of memory. Edit and update.
+///Bit for given row in a row mask
+constexpr uint64_t RowBit( uint32_t aRow ) { return 1ull << aRow; }
+
+//----------------------------------------------------------------
+/// View of memory sized to the window which scrolls over the whole
+/// 64K. Data is read from the Shadow image, with pages ahead of the
+/// scroll direction fetched before they are needed. Edit and update.
 class MemoryView
 {
 public:
@@ -87,8 +102,8 @@ public:
 		ID[6] += aID;							//Set ID number in ImGui view name
 		Clear();
 
-		//Allocate Command object large enough to send updates
-		pCommand = Command::Create(COMMAND::MEMORY_GET, MEMBLOCKSIZE + 8);
+		//Command object used to send edits
+		pCommand = CommandPtr(new Command(COMMAND::MEMORY_SET));
 	}
 
 	//----------------------------------------------------------------
@@ -104,18 +119,56 @@ public:
 	uint16_t QAddress(  ) const { return Address; }
 
 	//----------------------------------------------------------------
-	///Get bank view is looking at
-	uint16_t QBank(  ) const { return Bank; }
+	///Get memspace and bank view is looking at
+	Banks::Space QSpace(  ) const { return Space; }
+
+	//----------------------------------------------------------------
+	///Set memspace and bank to show. Anything already fetched for it
+	/// is shown straight away
+	void SetSpace( Banks::Space aSpace )
+	{
+		if (aSpace != Space) {
+			Space = aSpace;
+			if (Space != Banks::MAIN) {
+				History = LIVE;					//Snapshots only hold the computer
+			}
+			Load();
+			SetCheckPoint(Enabled && (Monitor::ViceState() == VICESTATE::STOPPED));
+			Refresh();
+		}
+	}
+
+	//----------------------------------------------------------------
+	///Get number of bytes shown
+	uint32_t QBlockSize(  ) const { return Lines * BYTESPERLINE; }
+
+	//----------------------------------------------------------------
+	///Get last address shown
+	uint16_t QEnd(  ) const { return static_cast<uint16_t>(Address + QBlockSize() - 1); }
+
+	//----------------------------------------------------------------
+	///Get highest address the view may start at
+	uint16_t QLastAddress(  ) const { return static_cast<uint16_t>(0x10000 - QBlockSize()); }
+
+	//----------------------------------------------------------------
+	///Get row mask with a bit set for every line shown
+	uint64_t QAllRows(  ) const { return Lines < MAXLINES ? RowBit(Lines) - 1 : ~0ull; }
 
 	//----------------------------------------------------------------
 	///Clear the view display buffers
 	void Clear(  )
 	{
 		HexView[0] = 0;
+		HexChangeView[0] = 0;
+		HexEditView[0] = 0;
 		AddressView[0] = 0;
 		AsciiView[0] = 0;
 	}
 
+	//----------------------------------------------------------------
+	///Return true if showing a snapshot rather than live memory
+	bool QHistory(  ) const { return History != LIVE; }
+
 	//----------------------------------------------------------------
 	///Returned enabled (visible) state
 	bool QEnabled(  ) const { return Enabled; }
@@ -147,15 +200,16 @@ public:
 	{
 		if (!Enabled) return;					//Early out if view not visible
 
-		InputEnabled = abInputEnabled;
+		InputEnabled = abInputEnabled && !QHistory();	//Can't edit the past
 
 		Refresh();								//Make sure data is up to date
 
-		//Set start position and size on first run
+		//Set start position and size on first run. Only the height may change
 		ImGui::SetNextWindowPos(ImVec2(384.0f, 95.0f + (290.0f * IDNum)), ImGuiCond_FirstUseEver);
-		ImGui::SetNextWindowSize(ImVec2(610.0f, 350.0f), ImGuiCond_FirstUseEver);
+		ImGui::SetNextWindowSize(ImVec2(WIDTH, 350.0f), ImGuiCond_FirstUseEver);
+		ImGui::SetNextWindowSizeConstraints(ImVec2(WIDTH, 0.0f), ImVec2(WIDTH, FLT_MAX));
 
-		ImGui::Begin(ID, &Enabled, ImGuiWindowFlags_NoResize);
+		ImGui::Begin(ID, &Enabled);
 
 		const float w = ImGui::GetFontSize();
 
@@ -167,9 +221,13 @@ public:
 		ImGui::Text("Addr");
 		ImGui::SameLine(0.0f, w * 5.0f);
 		ImGui::Text("Labels");
+		ImGui::SameLine(0.0f, w * 10.0f);
+		if (auto space = Space; Banks::Combo("##Space", space)) {
+			SetSpace(space);
+		}
 
 		ImGui::PushItemWidth(((w - 3) * 4.0f) - 2.0f);
-		uint16_t loc = NewAddress;
+		uint16_t loc = Address;
 		if (ImGui::InputScalar("##A", ImGuiDataType_U16, &loc,
 			nullptr, nullptr, "%04x",
 			ImGuiInputTextFlags_CharsHexadecimal
@@ -200,15 +258,20 @@ public:
 			Refresh(true);
 		}
 
+		DisplayHistory();
+
+		//Fit as many lines as the window has room for
+		SetLines(static_cast<uint32_t>((ImGui::GetContentRegionAvail().y - 16.0f) / w));
+
 		//Add address lines
 		currentPos = ImGui::GetCursorPos();
 		currentPos.x += 4.0f;					//Align with Address input
 		ImGui::SetCursorPos(currentPos);
-		ImGui::Text(AddressView, ImVec2(w * 2.75f, MEMLINES * ImGui::GetTextLineHeightWithSpacing() + 5));
+		ImGui::Text(AddressView, ImVec2(w * 2.75f, Lines * ImGui::GetTextLineHeightWithSpacing() + 5));
 
 		ImGui::SameLine();
 
-		uint32_t sz = sizeof(HexView) - 1;
+		uint32_t sz = Lines * HEXLINELEN;
 		currentPos = ImGui::GetCursorPos();
 
 		//Display frame around HexView
@@ -219,7 +282,7 @@ public:
 		const uint32_t enabledColor = IM_COL32(200, 255, 255, 255);
 		const uint32_t disabledColor = IM_COL32(80, 135, 135, 255);
 		ImGui::PushStyleColor(ImGuiCol_Border, InputEnabled ? enabledColor : disabledColor);
-		ImGui::BeginChild("##MemViewFrame", ImVec2(w * 26.0f + 4, (w * MEMLINES) + 16), true);
+		ImGui::BeginChild("##MemViewFrame", ImVec2(w * 26.0f + 4, (w * Lines) + 16), true);
 
 		//Display data changed since last update
 		currentPos = ImGui::GetCursorPos();		//Get position relative to frame
@@ -245,45 +308,31 @@ public:
 		ImGui::PushStyleColor(ImGuiCol_Text, IM_COL32(255, 255, 255, 150));
 		ImGui::PushStyleColor(ImGuiCol_FrameBg, 0);
 		ImGui::InputTextMultiline("##MemL", HexView, sz
-				, ImVec2(w * 26.0f, (MEMLINES * ImGui::GetFontSize()) + 6)
+				, ImVec2(w * 26.0f, (Lines * ImGui::GetFontSize()) + 6)
 				, ImGuiInputTextFlags_CharsHexadecimal | ImGuiInputTextFlags_CharsNoBlank
 				| ImGuiInputTextFlags_AlwaysOverwrite
 				| ImGuiInputTextFlags_NoUndoRedo
 				| ImGuiInputTextFlags_CallbackAlways | ImGuiInputTextFlags_CallbackCharFilter
 				, HexViewCallback, this);
+		DisplayXrefs();
 
 		//If HexView has focus then process arrow and page up/down keys
 		if (ImGui::IsItemFocused()) {
 			if (ImGui::IsKeyPressed(ImGuiKey_UpArrow)) {
 				if (cursorPos <= HEXLINELEN) {
-					if (QAddress() >= BYTESPERLINE) {
-						SetAddress(QAddress() - BYTESPERLINE);
-					}
+					Scroll(-1);
 				}
 			}
 			else if (ImGui::IsKeyPressed(ImGuiKey_DownArrow)) {
-				if (PrevPos >= HEXVIEWSIZE - HEXLINELEN) {
-					if (QAddress() < LASTADDRESS) {
-						SetAddress(QAddress() + BYTESPERLINE);
-					}
+				if (PrevPos >= static_cast<int32_t>((Lines - 1) * HEXLINELEN)) {
+					Scroll(1);
 				}
 			}
 			else if (ImGui::IsKeyPressed(ImGuiKey_PageUp)) {
-				auto newAddr = QAddress();
-				if (newAddr > 0) {
-					newAddr = newAddr >= MEMBLOCKSIZE ? newAddr - MEMBLOCKSIZE : 0;
-					SetAddress(newAddr);
-				}
+				Scroll(-static_cast<int32_t>(Lines));
 			}
 			else if (ImGui::IsKeyPressed(ImGuiKey_PageDown)) {
-				auto newAddr = QAddress();
-				if (newAddr < LASTADDRESS) {
-					newAddr += MEMBLOCKSIZE;
-					if (newAddr > LASTADDRESS) {
-						newAddr = LASTADDRESS;
-					}
-					SetAddress(newAddr);
-				}
+				Scroll(static_cast<int32_t>(Lines));
 			}
 		}
 
@@ -297,7 +346,7 @@ public:
 		ImGui::SameLine();
 		currentPos = ImGui::GetCursorPos();
 		ImGui::PushFont(Monitor::C64Font());
-		ImGui::Text(AsciiView, ImVec2(w * 17.0f, MEMLINES * ImGui::GetTextLineHeightWithSpacing() + 5));
+		ImGui::Text(AsciiView, ImVec2(w * 17.0f, Lines * ImGui::GetTextLineHeightWithSpacing() + 5));
 
 		//Calculate cursor position
 		currentPos.x += ((CursorPos % HEXLINELEN) / 3) * w;
@@ -311,91 +360,102 @@ public:
 		ImGui::PopStyleColor();					//Border color
 
 		ImGui::PopFont();
+
+		//Scroll bar over the whole address space, top is address 0
+		ImGui::SameLine();
+		const uint16_t top = 0;
+		const uint16_t last = QLastAddress();
+		loc = Address;
+		if (ImGui::VSliderScalar("##Scroll", ImVec2(w, Lines * ImGui::GetTextLineHeightWithSpacing())
+			, ImGuiDataType_U16, &loc, &last, &top, "")) {
+			SetAddress(loc);
+		}
+
+		//Mouse wheel scrolls anywhere in the window
+		if (ImGui::IsWindowHovered(ImGuiHoveredFlags_ChildWindows)) {
+			constexpr float mscale = 0.5f;
+			float move = ImGui::GetIO().MouseWheel;
+			if (move < -mscale) {
+				Scroll(WHEELLINES);
+			}
+			else if (move > mscale) {
+				Scroll(-static_cast<int32_t>(WHEELLINES));
+			}
+		}
+
 		ImGui::End();
 	}
 
 	//----------------------------------------------------------------
-	/// Send command for new data or process pending data
+	///Request any memory the view needs and update from the Shadow image.
+	/// abForce discards what we have of the shown memory and asks again
 	void Refresh( bool abForce = false )
 	{
-		//Decrement wait count if not 0.
-		if (Waiting) {
-			--Waiting;
+		if (!QHistory()) {
+			Update();
+		}
+
+		//While running ask for new data each time the last request completes
+		const uint16_t end = QEnd();
+		abForce |= Continuous && (Monitor::ViceState() == VICESTATE::RUNNING) && Shadow::QValid(Address, end, Space);
+		if (abForce) {
+			Shadow::Invalidate(Address, end, Space);
+		}
+
+		//Shown memory first, then the memory we'll scroll into next
+		Shadow::Fetch(Address, end, Space);
+		if (ScrollDir < 0) {
+			Shadow::Fetch(static_cast<uint16_t>(Address > PREFETCH ? Address - PREFETCH : 0), Address, Space);
 		}
 		else {
-			//If we want continuous updates and VICE is running, send a new command
-			// But not if we are waiting for a response
-			abForce |= NewAddress != Address;	//If new address then force send
-			if (abForce || (Continuous && Monitor::ViceState() == VICESTATE::RUNNING)) {
-				RequestMemory();
-			}
+			Shadow::Fetch(end, static_cast<uint16_t>(std::min<uint32_t>(end + PREFETCH, 0xffff)), Space);
 		}
 	}
 
-	//----------------------------------------------------------------
-	///Return NewAddress != Address
-	bool QNewAddress(  ) const { return NewAddress != Address; }
-
 	//----------------------------------------------------------------
 	/// Set memory Address/bank for memory to show in view
 	void SetAddress( uint16_t aLoc )
 	{
-		NewAddress = aLoc & 0xfff0;		//Align downward to 16 bytes
+		uint16_t addr = aLoc & 0xfff0;			//Align downward to 16 bytes
 		//Keep from > than value that would allow us to display full set of data
-		if (NewAddress > LASTADDRESS) {
-			NewAddress = LASTADDRESS;
+		if (addr > QLastAddress()) {
+			addr = QLastAddress();
 		}
 
-		if (QNewAddress()) {
+		if (addr != Address) {
+			ScrollDir = (addr < Address) ? -1 : 1;
+			Address = addr;
+			UpdateAddressView();
+			Load();
+			SetCheckPoint(Enabled && (Monitor::ViceState() == VICESTATE::STOPPED));
 			Refresh();
 		}
 	}
 
 	//----------------------------------------------------------------
-	///Process new memory data from response
-	bool FromResponse( const Response &arResponse )
+	///Move view by given number of lines
+	void Scroll( int32_t aLines )
 	{
-		bool bres;
-
-		//Only process responses to our requests
-		if (bres = arResponse.QID() == pCommand->QID(); bres) {
-			uint16_t size = arResponse.Get16(0);
-			//TODO: This assumes we are reading in all the data
-			// We need to add support for reading just portions into Data and calculate
-			// the correct address.  We'll only need that though if we are going to support
-			// writing out portions of data rather than just the whole block each change
-
-			//TODO: Should this just fail if it's wrong?
-			if (size > MEMBLOCKSIZE) { size = MEMBLOCKSIZE; }
-
-			//Copy Data into PrevData
-			auto setPrevData = [&](  ) {
-				memcpy_s(PrevData, MEMBLOCKSIZE, Data, MEMBLOCKSIZE);
-			};
-
-			//If a new Address we'll reset prevdata to data later, so don't bother
-			// to copy here
-			if (!QNewAddress()) {
-				setPrevData();						//Copy current buffer into previous for diff view
-			}
-
-			//Copy data from response, skipping size
-			memcpy_s(Data, MEMBLOCKSIZE, arResponse.QBody() + 2, size);
+		int32_t addr = static_cast<int32_t>(Address) + (aLines * static_cast<int32_t>(BYTESPERLINE));
+		addr = std::clamp(addr, 0, static_cast<int32_t>(QLastAddress()));
+		SetAddress(static_cast<uint16_t>(addr));
+	}
 
-			//If we also got a new Address, update the address view
-			//Need to set previous data before UpdateHexView() or differences will be displayed
-			if (NewAddress != Address) {
-				Address = NewAddress;
-				setPrevData();
-				UpdateAddressView();
-				SetCheckPoint(Monitor::ViceState() == VICESTATE::STOPPED);
+	//----------------------------------------------------------------
+	///Set number of lines shown
+	void SetLines( uint32_t aLines )
+	{
+		aLines = std::clamp(aLines, MINLINES, MAXLINES);
+		if (aLines != Lines) {
+			Lines = aLines;
+			if (Address > QLastAddress()) {
+				Address = QLastAddress();
 			}
-
-			UpdateHexView();						//Update hex view from data
-			UpdateAsciiView();						//Update ASCII view from data
-			Waiting = 0;
+			UpdateAddressView();
+			Load();
+			SetCheckPoint(Enabled && (Monitor::ViceState() == VICESTATE::STOPPED));
+			Refresh();
 		}
-		return bres;
 	}
 
 	//----------------------------------------------------------------
@@ -404,7 +464,7 @@ public:
 	{
 		SetCheckPoint(!abTF);
 		if (!abTF) {
-			Refresh(true);
+			Refresh();							//Shadow already knows what execution changed
 		}
 	}
 
@@ -412,36 +472,44 @@ public:
 	///Enable/Disable CheckPoint and update address
 	void SetCheckPoint( bool abTF )
 	{
-		//Make sure CheckPoint is set to address
-		if (CheckPoint != Address) {
+		//Make sure CheckPoint covers the memory shown
+		if ((CheckPoint != Address) || (CheckPointEnd != QEnd())) {
 			if (CheckPoint != 0xffff) {
 				BreakPoints::Remove(CheckPoint);
 			}
 			CheckPoint = Address;
+			CheckPointEnd = QEnd();
 			//Add a breakpoint that does not break on hit
-			BreakPoints::Add(CheckPoint, CheckPoint + MEMBLOCKSIZE - 1, false);
+			BreakPoints::Add(CheckPoint, CheckPointEnd, false);
 		}
 
-		//If CheckPoint set then set enable state
+		//If CheckPoint set then set enable state. It watches the computer, so
+		// is of no use when showing a drive
 		if (CheckPoint != 0xffff) {
-			BreakPoints::Enable(CheckPoint, abTF);
+			BreakPoints::Enable(CheckPoint, abTF && (Banks::QMemspace(Space) == Banks::COMPUTER));
 		}
 	}
 
 private:
 	Labels::LabelCombo LabelFilter;				//Filter for the label combo box
-	CommandPtr pCommand;						//Command object used to update this view
+	CommandPtr pCommand;						//Command object used to send edits
 	int32_t PrevPos = -1;						//Previous position for Memory edit cursor
-	uint32_t Waiting = 0;						//Waiting for response
+	uint64_t ChangedRows = 0;					//Bit per line highlighted in HexChangeView
+	uint64_t EditedRows = 0;					//Bit per line with highlights in HexEditView
 	int32_t CursorPos = 0;						//Current cursor position
+	uint32_t Lines = DEFLINES;					//Number of lines shown
+	uint32_t Stamp = 0;							//Shadow stamp of the data we have
+	int32_t ScrollDir = 1;						//Direction of last scroll, used to prefetch
 	uint16_t Address = 0xffff;					//c64 memory address
-	uint16_t NewAddress = 0xffff;				//New Address set if != Address, need address view refresh
 	uint16_t CheckPoint = 0xffff;				//Address of CheckPoint, 0xFFFF if not set
-	uint16_t Bank = 0;							//c64 memory bank
+	uint16_t CheckPointEnd = 0xffff;			//Last address covered by CheckPoint
+	Banks::Space Space = Banks::MAIN;			//Memspace and bank shown
+	uint32_t History = LIVE;					//Serial of snapshot shown or LIVE
+	uint32_t HistoryBase = LIVE;				//Serial of snapshot History is compared to
 	//Memory and display buffers.
 	uint8_t PrevData[MEMBLOCKSIZE];				//Previous data used for change detection
 	uint8_t Data[MEMBLOCKSIZE];
-	char AddressView[MEMLINES * ADDRLINELEN];	//16 bit address plus null terminator
+	char AddressView[MAXLINES * ADDRLINELEN];	//16 bit address plus null terminator
 	char HexView[HEXVIEWSIZE + 1];				//+ 1 for null terminator
 	char HexChangeView[HEXVIEWSIZE + 1];		//Used to display highlights on changed values
 	char HexEditView[HEXVIEWSIZE + 1];			//Used to display highlights on edited values
@@ -451,6 +519,7 @@ private:
 	bool Enabled = false;						//Display enabled
 	bool Continuous = false;					//When true will continuously ask for new data while Vice is running
 	bool InputEnabled = false;					//Indicate if can edit memory
+	bool Loaded = false;						//Data holds memory for the current Address
 
 	//----------------------------------------------------------------
 	///Callback for HexView input
@@ -489,6 +558,7 @@ private:
 					}
 					HexEditView[PrevPos] = static_cast<char>(c);
 					HexChangeView[PrevPos] = ' ';
+					EditedRows |= RowBit(PrevPos / HEXLINELEN);
 					//If edited the 2nd nibble of a byte, send the byte
 					if (PrevPos % 3) {
 						ApplyChange(PrevPos);
@@ -516,21 +586,132 @@ private:
 	}
 
 	//----------------------------------------------------------------
-	///Send command for memory refresh
-	void RequestMemory(  )
+	///List references to the byte under the mouse in the hex view
+	void DisplayXrefs(  )
 	{
-		pCommand->Reset();
-		pCommand->SetCommand(COMMAND::MEMORY_GET);
+		if ((Space != Banks::MAIN) || !ImGui::IsItemHovered()) {
+			return;								//Xref only indexes the computer
+		}
 
-		pCommand->Add(0_u8);					//No side effects
-		auto loc = NewAddress;					//Set new address
-		pCommand->Add(loc);						//Start Address
-		auto end = loc + MEMBLOCKSIZE - 1;
-		pCommand->Add(end);						//End Address
-		pCommand->Add(0_u8);					//Main Memory
-		pCommand->Add(QBank());
-		Monitor::Send(pCommand);				//Send the command
-		Waiting = WAITCOUNT;					//Set counter indicating waiting for response
+		const ImVec2 padding = ImGui::GetStyle().FramePadding;
+		const ImVec2 ul = ImGui::GetItemRectMin();
+		const ImVec2 mouse = ImGui::GetMousePos();
+		const float column = (mouse.x - ul.x - padding.x) / ImGui::CalcTextSize("00 ").x;
+		const float row = (mouse.y - ul.y - padding.y) / ImGui::GetFontSize();
+		if ((column >= 0.0f) && (column < BYTESPERLINE) && (row >= 0.0f) && (row < Lines)) {
+			Xref::Tooltip(static_cast<uint16_t>(Address + (static_cast<uint32_t>(row) * BYTESPERLINE) + static_cast<uint32_t>(column)));
+		}
+	}
+
+	//----------------------------------------------------------------
+	///Display sliders to pick a snapshot to show and one to compare it with
+	void DisplayHistory(  )
+	{
+		const uint32_t first = Snapshots::QFirst();
+		const uint32_t end = Snapshots::QEnd();
+		if ((first == end) || (Space != Banks::MAIN)) {
+			History = LIVE;
+			return;
+		}
+
+		const float w = ImGui::GetFontSize();
+
+		//Slider end value is live memory
+		uint32_t shown = QHistory() ? std::max(History, first) : end;
+		ImGui::SameLine();
+		ImGui::PushItemWidth(w * 4.0f);
+		if (ImGui::SliderScalar("##Hist", ImGuiDataType_U32, &shown, &first, &end
+			, shown == end ? "Live" : "%u")) {
+			if (shown == end) {
+				History = LIVE;
+				Load();
+			}
+			else {
+				History = shown;
+				HistoryBase = shown > first ? shown - 1 : shown;
+				ShowHistory();
+			}
+		}
+		if (ImGui::IsItemHovered()) {
+			ImGui::SetTooltip("Snapshot to show, changes are highlighted against the 2nd slider");
+		}
+
+		//Snapshot to compare with
+		if (QHistory()) {
+			const uint32_t last = end - 1;
+			ImGui::SameLine();
+			if (ImGui::SliderScalar("##Base", ImGuiDataType_U32, &HistoryBase, &first, &last, "%u")) {
+				ShowHistory();
+			}
+		}
+		ImGui::PopItemWidth();
+	}
+
+	//----------------------------------------------------------------
+	///Fill the view from the History snapshot, highlighting changes
+	/// from HistoryBase. Return to live if the snapshot is gone
+	void ShowHistory(  )
+	{
+		if (!Snapshots::Get(History, Address, Data, QBlockSize())) {
+			History = LIVE;
+			Load();
+			return;
+		}
+		if (!Snapshots::Get(HistoryBase, Address, PrevData, QBlockSize())) {
+			memcpy_s(PrevData, MEMBLOCKSIZE, Data, QBlockSize());
+		}
+		ChangedRows = Simd::DiffRows(Data, PrevData, Lines);
+		UpdateRows(QAllRows());
+	}
+
+	//----------------------------------------------------------------
+	///Fill view from the Shadow image after a change of address or size.
+	/// Until the memory is up to date the image may hold old values, so
+	/// the first update after it arrives is not highlighted
+	void Load(  )
+	{
+		Loaded = false;
+		memcpy_s(Data, MEMBLOCKSIZE, Shadow::QImage(Space) + Address, QBlockSize());
+		memcpy_s(PrevData, MEMBLOCKSIZE, Data, QBlockSize());
+		ChangedRows = 0;
+		UpdateRows(QAllRows());
+		if (QHistory()) {
+			ShowHistory();
+		}
+	}
+
+	//----------------------------------------------------------------
+	///Update view with any new data in the Shadow image
+	void Update(  )
+	{
+		const uint16_t end = QEnd();
+		if (!Shadow::QValid(Address, end, Space)) return;	//Wait for all the data
+
+		const uint8_t *pnew = Shadow::QImage(Space) + Address;
+		const uint32_t stamp = Shadow::QStamp(Address, end, Space);
+		if (!Loaded) {
+			memcpy_s(Data, MEMBLOCKSIZE, pnew, QBlockSize());
+			memcpy_s(PrevData, MEMBLOCKSIZE, Data, QBlockSize());
+			ChangedRows = 0;
+			UpdateRows(QAllRows());
+			Loaded = true;
+		}
+		else if (stamp != Stamp) {
+			//Find the lines that differ from what we are displaying. Only
+			// those, lines highlighted as changed last time (to clear the
+			// highlight) and lines with pending edits need rebuilding
+			uint64_t changed = Simd::DiffRows(Data, pnew, Lines);
+			uint64_t dirty = changed | ChangedRows | EditedRows;
+
+			//If the view is clean there is nothing to do
+			if (dirty) {
+				memcpy_s(PrevData, MEMBLOCKSIZE, Data, QBlockSize());	//Current buffer becomes previous for diff view
+				memcpy_s(Data, MEMBLOCKSIZE, pnew, QBlockSize());
+				ChangedRows = changed;
+				UpdateRows(dirty);
+			}
+		}
+		Stamp = stamp;
 	}
 
 	//----------------------------------------------------------------
@@ -550,20 +731,21 @@ private:
 
 		auto b = Numbers::HexToUInt8(&HexEditView[aPos]);
 		Data[dataPos] = b;
+		uint16_t loc = dataPos + QAddress();
+		Shadow::Store(loc, &b, 1, Space);				//Keep shadow image in step with the edit
 
 		pCommand->Reset();
 		pCommand->SetCommand(COMMAND::MEMORY_SET);
 
 		pCommand->Add(1_u8);					//Side effects
-		uint16_t loc = dataPos + QAddress();
 		pCommand->Add(loc);						//Start Address
 		pCommand->Add(loc);						//End Address
-		pCommand->Add(0_u8);					//Main Memory
-		pCommand->Add(QBank());
+		pCommand->Add(Banks::QMemspace(Space));
+		pCommand->Add(Banks::QBank(Space));
 		pCommand->Add(b);						//Add the byte
 		Monitor::Send(pCommand);				//Send the command
 
-		UpdateAsciiView();
+		UpdateAsciiRow(dataPos / BYTESPERLINE);
 	}
 
 	//----------------------------------------------------------------
@@ -572,7 +754,7 @@ private:
 	{
 		uint16_t loc = QAddress();
 		char *pdest = AddressView;
-		for ( uint32_t i = 0; i < MEMLINES; ++i) {
+		for ( uint32_t i = 0; i < Lines; ++i) {
 			Numbers::ToHex(pdest, loc);
 			pdest += 4;
 			*pdest++ = '\n';
@@ -582,67 +764,90 @@ private:
 	}
 
 	//----------------------------------------------------------------
-	///Update the HexChange view by examining differences between
-	/// Data and PrevData
-	/// NOTE: This assumes HexView is up to date
-	void UpdateHexChangeView(  )
+	///Rebuild the display lines for each bit set in aRows.
+	/// HexView must be updated before HexChangeView as it is copied from
+	void UpdateRows( uint64_t aRows )
 	{
-		char *pdest = HexChangeView;
-		char *psrc = HexView;
-		uint32_t written = 0;
-
-		//Loop through the memory.
-		for ( uint32_t i = 0; i < MEMBLOCKSIZE; ++i) {
-			uint8_t v = Data[i];
-			//If the data has changed, copy the ascii values from HexView to HexChangeView
-			if (v !=  PrevData[i]) {
-				pdest[written] = psrc[written];
-				++written;
-				pdest[written] = psrc[written];
-				++written;
+		for ( uint32_t i = 0; aRows; ++i, aRows >>= 1) {
+			if (aRows & 1) {
+				UpdateHexRow(i);
+				UpdateHexChangeRow(i);
+				UpdateHexEditRow(i);
+				UpdateAsciiRow(i);
 			}
-			else {
-				pdest[written++] = ' ';			//Set values to spaces
-				pdest[written++] = ' ';
-			}
-			pdest[written] = psrc[written];		//Copy char in between entries
-			written++;
 		}
 	}
 
 	//----------------------------------------------------------------
-	///Set HexView from Data
-	void UpdateHexView(  )
-	{
-		Numbers::ToHex(HexView, sizeof(HexView), Data, MEMBLOCKSIZE);
-		HexView[sizeof(HexView) - 2] = 0;		//Kill final cr
+	///Return line terminator for given line, the last line is null terminated
+	char LineEnd( uint32_t aRow ) const { return (aRow == Lines - 1) ? 0 : '\n'; }
 
-		UpdateHexChangeView();					//Now update changes
+	//----------------------------------------------------------------
+	///Set line of HexView from Data
+	void UpdateHexRow( uint32_t aRow )
+	{
+		char *pdest = &HexView[aRow * HEXLINELEN];
+		const uint8_t *psrc = &Data[aRow * BYTESPERLINE];
+		for ( uint32_t i = 0; i < BYTESPERLINE; ++i) {
+			Numbers::ToHex(pdest, psrc[i]);
+			pdest[2] = ' ';						//Replace null terminator with space
+			pdest += 3;
+		}
+		*(pdest - 1) = LineEnd(aRow);
+	}
 
-		//Clear the HexEdit view to spaces with lines separated by cr
-		char *pdest = HexEditView;
-		for ( uint32_t i = 0; i < MEMLINES; ++i) {
+	//----------------------------------------------------------------
+	///Update line of the HexChange view by examining differences between
+	/// Data and PrevData
+	/// NOTE: This assumes HexView line is up to date
+	void UpdateHexChangeRow( uint32_t aRow )
+	{
+		const uint32_t start = aRow * HEXLINELEN;
+		char *pdest = &HexChangeView[start];
+		const char *psrc = &HexView[start];
+		const uint8_t *pdata = &Data[aRow * BYTESPERLINE];
+		const uint8_t *pprev = &PrevData[aRow * BYTESPERLINE];
+
+		//If nothing on the line changed it's all spaces
+		if (!(ChangedRows & RowBit(aRow))) {
 			memset(pdest, ' ', HEXLINELEN - 1);
-			pdest[HEXLINELEN - 1] = '\n';
-			pdest += HEXLINELEN;
 		}
-		pdest[HEXLINELEN - 1] = 0;				//Null terminate
+		else {
+			uint32_t written = 0;
+			for ( uint32_t i = 0; i < BYTESPERLINE; ++i) {
+				//If the data has changed, copy the ascii values from HexView to HexChangeView
+				if (pdata[i] != pprev[i]) {
+					pdest[written] = psrc[written];
+					pdest[written + 1] = psrc[written + 1];
+				}
+				else {
+					pdest[written] = ' ';		//Set values to spaces
+					pdest[written + 1] = ' ';
+				}
+				pdest[written + 2] = ' ';		//Space in between entries
+				written += 3;
+			}
+		}
+		pdest[HEXLINELEN - 1] = LineEnd(aRow);
 	}
 
 	//----------------------------------------------------------------
-	///Update AsciiView from the Data
-	void UpdateAsciiView(  )
+	///Clear line of the HexEdit view to spaces
+	void UpdateHexEditRow( uint32_t aRow )
 	{
-		uint8_t *pdata = Data;
-		char *pdest = AsciiView;
-		//Loop for all lines
-		for ( uint32_t i = 0; i < MEMLINES; ++i) {
-			pdest += Numbers::ToAscii(pdest, ASCIILINELEN, pdata, BYTESPERLINE);
-			*pdest++ = '\n';					//Add cr
-			pdata += BYTESPERLINE;
-		}
+		char *pdest = &HexEditView[aRow * HEXLINELEN];
+		memset(pdest, ' ', HEXLINELEN - 1);
+		pdest[HEXLINELEN - 1] = LineEnd(aRow);
+		EditedRows &= ~RowBit(aRow);
+	}
 
-		*(pdest - 1) = 0;						//Null terminate by overwriting last cr
+	//----------------------------------------------------------------
+	///Update line of AsciiView from the Data
+	void UpdateAsciiRow( uint32_t aRow )
+	{
+		char *pdest = &AsciiView[aRow * ASCIILINELEN];
+		Numbers::ToAscii(pdest, ASCIILINELEN, &Data[aRow * BYTESPERLINE], BYTESPERLINE);
+		pdest[BYTESPERLINE] = LineEnd(aRow);
 	}
 };
 
@@ -664,6 +869,7 @@ void ToJson( nlohmann::json &arData )
 		if (Views[i]) {
 			arData[key] = {
 				{"Address", Views[i]->QAddress()},
+				{"Space", Views[i]->QSpace()},
 				{"On", Views[i]->QEnabled()}
 			};
 		}
@@ -680,6 +886,9 @@ void FromJson( nlohmann::json &arData )
 			auto obj = arData[key];
 			if (!obj.is_null()) {
 				Views[i]->SetAddress(obj["Address"]);
+				if (obj["Space"].is_number()) {
+					Views[i]->SetSpace(obj["Space"]);
+				}
 				Views[i]->SetEnabled(obj["On"]);
 			}
 			else {
@@ -711,24 +920,20 @@ void ViceRunning( bool abTF )
 }
 
 //----------------------------------------------------------------
-bool FromResponse( const Response &arResponse )
+void DisplayOn( uint32_t aView )
 {
-	for ( const auto &view : Views ) {
-		//Right now we process only responses for specific requests
-		// but we may want to change this and attept to process
-		// responses that change memory we are viewing
-		if (view->FromResponse(arResponse)) {
-			return true;
-		}
+	if (aView < NUMVIEWS) {
+		Views[aView]->SetEnabled(true);
 	}
-	return false;
 }
 
 //----------------------------------------------------------------
-void DisplayOn( uint32_t aView )
+void SetAddress( uint32_t aView, uint16_t aAddress, Banks::Space aSpace )
 {
 	if (aView < NUMVIEWS) {
 		Views[aView]->SetEnabled(true);
+		Views[aView]->SetSpace(aSpace);
+		Views[aView]->SetAddress(aAddress);
 	}
 }
 
@@ -32,10 +32,9 @@
 #pragma once
 
 #include "types.h"
+#include "Banks.h"
 #include "json/json.hpp"
 
-class Response;
-
 namespace Memory
 {
 
@@ -59,12 +58,13 @@ void Refresh(  );
 /// Handle vice state
 void ViceRunning( bool abTF );
 
-//----------------------------------------------------------------
-///Update views from a response
-bool FromResponse( const Response &arResponse );
-
 //----------------------------------------------------------------
 /// Enable the view indicated by given index
 void DisplayOn( uint32_t aView );
 
+//----------------------------------------------------------------
+/// Enable the view indicated by given index and show given address
+/// in the given memspace and bank
+void SetAddress( uint32_t aView, uint16_t aAddress, Banks::Space aSpace = Banks::MAIN );
+
 }	//namespace Memory
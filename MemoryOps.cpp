@@ -0,0 +1,289 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    MemoryOps.cpp
+//----------------------------------------------------------------------
+
+#include "MemoryOps.h"
+#include "Command.h"
+#include "Monitor.h"
+#include "Search.h"
+#include "Shadow.h"
+
+#include <algorithm>
+#include <imgui.h>
+#include <vector>
+
+namespace MemoryOps
+{
+
+constexpr uint32_t HEADERSIZE = 8;				//MEMORY_SET body before the data
+
+//----------------------------------------------------------------
+///Copy waiting on source memory
+struct PendingCopy
+{
+	uint16_t Start;
+	uint16_t End;
+	uint16_t Dest;
+	OP Op;
+	Banks::Space Space;
+};
+
+bool Enabled = false;							//Window enabled
+bool Waiting = false;							//Copy waiting on memory
+PendingCopy Pending;
+int32_t Op = 0;									//OP as int for combo box
+int32_t Mode = 0;								//Search::MODE of fill pattern as int
+uint16_t Start = 0x0400;
+uint16_t End = 0x07e7;
+uint16_t Dest = 0x0000;
+char PatternText[64] = "20";
+char Status[64] = "";
+Banks::Space Space = Banks::MAIN;
+
+//----------------------------------------------------------------
+///Get display name for the given op
+const char *OpName( OP aeOp )
+{
+	constexpr const char *names[] = { "Fill", "Copy", "Move" };
+	return aeOp < OP::COUNT ? names[static_cast<uint32_t>(aeOp)] : "?";
+}
+
+//----------------------------------------------------------------
+///Write aSize bytes at aStart in one MEMORY_SET and into the Shadow image
+void Send( uint16_t aStart, uint8_t *apData, uint32_t aSize, Banks::Space aSpace )
+{
+	auto pcommand = Command::Create(COMMAND::MEMORY_SET, HEADERSIZE + aSize);
+	pcommand->Add(1_u8);						//Side effects, same as editing
+	pcommand->Add(aStart);						//Start Address
+	pcommand->Add(static_cast<uint16_t>(aStart + aSize - 1));	//End Address
+	pcommand->Add(Banks::QMemspace(aSpace));
+	pcommand->Add(Banks::QBank(aSpace));
+	pcommand->Add(apData, aSize);
+	Monitor::Send(pcommand);
+
+	Shadow::Store(aStart, apData, aSize, aSpace);
+}
+
+//----------------------------------------------------------------
+bool Fill( uint16_t aStart, uint16_t aEnd, const uint8_t *apPattern, uint32_t aPatternLen, Banks::Space aSpace )
+{
+	if ((Monitor::ViceState() == VICESTATE::DISCONNECTED) || !aPatternLen || (aEnd < aStart)) {
+		return false;
+	}
+
+	const uint32_t size = static_cast<uint32_t>(aEnd) - aStart + 1;
+	std::vector<uint8_t> data(size);
+	for ( uint32_t i = 0; i < size; ++i) {
+		data[i] = apPattern[i % aPatternLen];
+	}
+	Send(aStart, data.data(), size, aSpace);
+	return true;
+}
+
+//----------------------------------------------------------------
+///Build the destination data from the source in the Shadow image and send it
+void Run( const PendingCopy &arCopy )
+{
+	const uint8_t *pimage = Shadow::QImage(arCopy.Space);
+	const uint32_t size = std::min<uint32_t>(static_cast<uint32_t>(arCopy.End) - arCopy.Start + 1, 0x10000 - arCopy.Dest);
+	std::vector<uint8_t> data(size);
+	if (arCopy.Op == OP::MOVE) {
+		memcpy_s(data.data(), size, pimage + arCopy.Start, size);
+	}
+	else {
+		//A forward copy reads bytes it has already written when the
+		// source runs into the destination
+		for ( uint32_t i = 0; i < size; ++i) {
+			const uint32_t src = arCopy.Start + i;
+			data[i] = ((src >= arCopy.Dest) && (src < arCopy.Dest + i)) ? data[src - arCopy.Dest] : pimage[src];
+		}
+	}
+	Send(arCopy.Dest, data.data(), size, arCopy.Space);
+	snprintf(Status, sizeof(Status), "%s %u bytes", OpName(arCopy.Op), size);
+}
+
+//----------------------------------------------------------------
+bool Copy( uint16_t aStart, uint16_t aEnd, uint16_t aDest, OP aeOp, Banks::Space aSpace )
+{
+	if ((Monitor::ViceState() == VICESTATE::DISCONNECTED) || Waiting || (aEnd < aStart)) {
+		return false;
+	}
+
+	//If running the memory we have may be old
+	if (Monitor::ViceState() == VICESTATE::RUNNING) {
+		Shadow::Invalidate(aStart, aEnd, aSpace);
+	}
+	Shadow::Fetch(aStart, aEnd, aSpace);
+	Pending = { aStart, aEnd, aDest, aeOp, aSpace };
+	Waiting = true;
+	return true;
+}
+
+//----------------------------------------------------------------
+///Send waiting copy once its source is here
+void Update(  )
+{
+	if (Waiting) {
+		if (Monitor::ViceState() == VICESTATE::DISCONNECTED) {
+			Waiting = false;
+		}
+		else if (Shadow::QValid(Pending.Start, Pending.End, Pending.Space)) {
+			Waiting = false;
+			Run(Pending);
+		}
+	}
+}
+
+//----------------------------------------------------------------
+void ToJson( nlohmann::json &arData )
+{
+	arData["MemoryOps"] = {
+		{"On", Enabled},
+		{"Op", Op},
+		{"Mode", Mode},
+		{"Space", Space},
+		{"Pattern", PatternText}
+	};
+}
+
+//----------------------------------------------------------------
+void FromJson( nlohmann::json &arData )
+{
+	auto obj = arData["MemoryOps"];
+	if (!obj.is_null()) {
+		Enabled = obj["On"];
+		Op = obj["Op"];
+		Mode = obj["Mode"];
+		Space = obj["Space"];
+		std::string pattern = obj["Pattern"];
+		snprintf(PatternText, sizeof(PatternText), "%s", pattern.c_str());
+	}
+}
+
+//----------------------------------------------------------------
+void DisplayOn(  )
+{
+	Enabled = true;
+}
+
+//----------------------------------------------------------------
+void Display(  )
+{
+	Update();									//Copies complete with the window closed
+
+	if (!Enabled) return;						//Early out if view not visible
+
+	ImGui::SetNextWindowSize(ImVec2(330, 110), ImGuiCond_FirstUseEver);
+	ImGui::Begin("Fill/Copy", &Enabled);
+
+	const float w = ImGui::GetFontSize();
+
+	//Lambda to add hex address input
+	auto address = [&]( const char *apLabel, uint16_t &arValue ) {
+		ImGui::Text(apLabel);
+		ImGui::SameLine();
+		ImGui::PushID(apLabel);
+		ImGui::PushItemWidth(w * 3.0f);
+		ImGui::InputScalar("##Addr", ImGuiDataType_U16, &arValue, nullptr, nullptr, "%04x"
+			, ImGuiInputTextFlags_CharsHexadecimal);
+		ImGui::PopItemWidth();
+		ImGui::PopID();
+	};
+
+	ImGui::PushItemWidth(w * 4.0f);
+	if (ImGui::BeginCombo("##Op", OpName(static_cast<OP>(Op)))) {
+		for ( int32_t i = 0; i < static_cast<int32_t>(OP::COUNT); ++i) {
+			if (ImGui::Selectable(OpName(static_cast<OP>(i)), i == Op)) {
+				Op = i;
+			}
+		}
+		ImGui::EndCombo();
+	}
+	ImGui::PopItemWidth();
+	ImGui::SameLine();
+	Banks::Combo("##Space", Space);
+
+	address("From", Start);
+	ImGui::SameLine();
+	address("To", End);
+	ImGui::SameLine();
+
+	const auto op = static_cast<OP>(Op);
+	if (op == OP::FILL) {
+		ImGui::PushItemWidth(w * 5.0f);
+		if (ImGui::BeginCombo("##Mode", Search::ModeName(static_cast<Search::MODE>(Mode)))) {
+			for ( int32_t i = 0; i < static_cast<int32_t>(Search::MODE::COUNT); ++i) {
+				if (ImGui::Selectable(Search::ModeName(static_cast<Search::MODE>(i)), i == Mode)) {
+					Mode = i;
+				}
+			}
+			ImGui::EndCombo();
+		}
+		ImGui::PopItemWidth();
+		ImGui::PushItemWidth(-FLT_MIN);
+		ImGui::InputText("##Pattern", PatternText, sizeof(PatternText));
+		ImGui::PopItemWidth();
+		if (ImGui::IsItemHovered()) {
+			ImGui::SetTooltip("Pattern repeated over the range, ie: 20 or 01 02 or text");
+		}
+	}
+	else {
+		address("Dest", Dest);
+	}
+
+	if (ImGui::Button("Go")) {
+		if (op == OP::FILL) {
+			//Fill patterns use the search syntax, but can't have wildcards
+			Search::Pattern pattern;
+			bool good = pattern.Parse(PatternText, static_cast<Search::MODE>(Mode));
+			for ( uint32_t i = 0; good && (i < pattern.Len); ++i) {
+				good = (pattern.Masks[i] == 0xff);
+			}
+			if (!good) {
+				snprintf(Status, sizeof(Status), "Bad pattern");
+			}
+			else if (Fill(Start, End, pattern.Values, pattern.Len, Space)) {
+				snprintf(Status, sizeof(Status), "Filled %u bytes", static_cast<uint32_t>(End) - Start + 1);
+			}
+			else {
+				snprintf(Status, sizeof(Status), "Fill failed");
+			}
+		}
+		else if (!Copy(Start, End, Dest, op, Space)) {
+			snprintf(Status, sizeof(Status), "%s failed", OpName(op));
+		}
+	}
+	ImGui::SameLine();
+	ImGui::Text(Waiting ? "Fetching" : Status);
+
+	ImGui::End();
+}
+
+}	//namespace MemoryOps
@@ -0,0 +1,86 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    MemoryOps.h
+//----------------------------------------------------------------------
+
+#pragma once
+
+#include "types.h"
+#include "Banks.h"
+#include "json/json.hpp"
+
+///Bulk memory operations. Each is sent to VICE as a single MEMORY_SET
+/// and stored straight into the Shadow image so views update without
+/// asking for the memory again.
+///  FILL - Repeat a pattern over a range
+///  COPY - Forward byte by byte copy, like a 6502 loop. A destination
+///         just above the source repeats the start of the source
+///  MOVE - Overlap safe copy, the destination ends up holding the source
+///         as it was before the move
+namespace MemoryOps
+{
+
+//----------------------------------------------------------------
+enum class OP : uint8_t
+{
+	FILL,
+	COPY,
+	MOVE,
+	COUNT
+};
+
+//----------------------------------------------------------------
+///Fill inclusive range with a repeating pattern. Return false if not
+/// connected or the pattern is empty
+bool Fill( uint16_t aStart, uint16_t aEnd, const uint8_t *apPattern, uint32_t aPatternLen
+	, Banks::Space aSpace = Banks::MAIN );
+
+//----------------------------------------------------------------
+///Copy or move inclusive range to aDest. The source is read from the
+/// Shadow image, so this is sent once any missing source memory arrives.
+/// Return false if not connected or another copy is waiting
+bool Copy( uint16_t aStart, uint16_t aEnd, uint16_t aDest, OP aeOp, Banks::Space aSpace = Banks::MAIN );
+
+//----------------------------------------------------------------
+///Save data to Json
+void ToJson( nlohmann::json &arData );
+
+//----------------------------------------------------------------
+///Load data from Json
+void FromJson( nlohmann::json &arData );
+
+//----------------------------------------------------------------
+///Enable window
+void DisplayOn(  );
+
+//----------------------------------------------------------------
+///Send any waiting copy and draw window
+void Display(  );
+
+}	//namespace MemoryOps
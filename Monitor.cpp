@@ -30,15 +30,33 @@
 //----------------------------------------------------------------------
 
 #include "monitor.h"
+#include "Banks.h"
+#include "Boundaries.h"
 #include "BreakPoints.h"
 #include "Code.h"
+#include "CompareView.h"
 #include "Diagnostics.h"
+#include "DisCache.h"
+#include "ExportView.h"
+#include "Flow.h"
+#include "Footprint.h"
+#include "Heatmap.h"
 #include "imfilebrowser.h"
 #include "Labels.h"
 #include "Memory.h"
+#include "MemoryOps.h"
 #include "Program.h"
+#include "QuickSave.h"
+#include "Regions.h"
 #include "Registers.h"
 #include "Response.h"
+#include "ScannerView.h"
+#include "Snapshots.h"
+#include "SearchView.h"
+#include "Shadow.h"
+#include "Smc.h"
+#include "StructView.h"
+#include "Xref.h"
 
 #include <algorithm>
 #include <assert.h>
@@ -101,6 +119,7 @@ VICESTATE eState = VICESTATE::DISCONNECTED;		//Current known state of VICE
 
 bool bAutoStartVice = false;					//True to autostart VICE on startup if not running
 bool Stopped = false;							//Flag to indicate we want VICE stopped
+uint32_t StopIP = 0x10000;						//IP of last stop, used to detect execution
 
 //----------------------------------------------------------------
 const char HelpText[] =
@@ -110,7 +129,9 @@ const char HelpText[] =
 "Ctrl+F9 = Toggle BreakPoint\n"
 "F10 = Step over\n"
 "F11 = Step into\n"
-"Shift+F11 = Step out\n";
+"Shift+F11 = Step out\n"
+"Ctrl+1-4 = Quick load slot\n"
+"Ctrl+Shift+1-4 = Quick save slot\n";
 
 //----------------------------------------------------------------
 const char *StateString[] =
@@ -158,6 +179,7 @@ void OpenAFile( const std::filesystem::path aPath )
 	auto ext = aPath.extension();
 	if (ext == ".vs") {
 		Labels::Load(aPath);
+		Regions::SetProject(aPath);
 	}
 	else if (ext == ".prg") {
 		Program::Load(aPath);
@@ -187,6 +209,17 @@ void SaveSettings(  )
 		Code::ToJson(data);
 		Memory::ToJson(data);
 		Labels::ToJson(data);
+		SearchView::ToJson(data);
+		ScannerView::ToJson(data);
+		Snapshots::ToJson(data);
+		Heatmap::ToJson(data);
+		Smc::ToJson(data);
+		Xref::ToJson(data);
+		Regions::ToJson(data);
+		ExportView::ToJson(data);
+		CompareView::ToJson(data);
+		MemoryOps::ToJson(data);
+		StructView::ToJson(data);
 		BreakPoints::ToJson(data);
 		Diagnostics::ToJson(data);
 
@@ -232,6 +265,17 @@ void LoadSettings(  )
 		Code::FromJson(data);
 		Memory::FromJson(data);
 		Labels::FromJson(data);
+		SearchView::FromJson(data);
+		ScannerView::FromJson(data);
+		Snapshots::FromJson(data);
+		Heatmap::FromJson(data);
+		Smc::FromJson(data);
+		Xref::FromJson(data);
+		Regions::FromJson(data);
+		ExportView::FromJson(data);
+		CompareView::FromJson(data);
+		MemoryOps::FromJson(data);
+		StructView::FromJson(data);
 		BreakPoints::FromJson(data);
 		Diagnostics::FromJson(data);
 	}
@@ -245,6 +289,10 @@ void UpdateStatus(  )
 		auto oldState = eState;
 		eState = Stopped ? VICESTATE::STOPPED : VICESTATE::RUNNING;
 		if (oldState == VICESTATE::DISCONNECTED) {
+			Shadow::Invalidate();				//Anything cached is from another session
+			DisCache::Clear();
+			Banks::Reset();						//Machine may have changed
+			Banks::Request();
 			Memory::Refresh();
 			Code::Refresh();
 		}
@@ -297,6 +345,7 @@ VICESTATE ViceState(  )
 void Resume(  )
 {
 	Stopped = false;
+	Footprint::Run();
 	if (ViceState() == VICESTATE::STOPPED) {
 		Send(Command::ExitCommand);
 	}
@@ -317,6 +366,9 @@ void Display(  )
 	if (!Thread::QInitialized()) return;
 
 	MainMenu();
+	QuickSave::Keys();
+	Snapshots::Update();
+	Flow::Update();
 
 	Registers::Display(Stopped);
 	Code::Display(Stopped);
@@ -324,6 +376,16 @@ void Display(  )
 	Diagnostics::Display();
 	Labels::Display();
 	BreakPoints::Display();
+	SearchView::Display();
+	ScannerView::Display();
+	Heatmap::Display();
+	Smc::Display();
+	Xref::Display();
+	Regions::Display();
+	ExportView::Display();
+	CompareView::Display();
+	MemoryOps::Display();
+	StructView::Display();
 
 	ImGui::SetNextWindowPos(ImVec2(268, 18), ImGuiCond_FirstUseEver);
 	ImGui::SetNextWindowSize(ImVec2(247, 78), ImGuiCond_FirstUseEver);
@@ -382,18 +444,23 @@ void ProcessResponses(  )
 	Thread::QInstance().ProcessResponses([&]( const Response &arResponse ) {
 		++processed;
 		switch (arResponse.QCommand()) {
-			//Memory responses go to either Memory View or Code View
+			//Memory responses go to the Shadow image, which Memory and Code
+			// Views read from, or Struct View
 			case COMMAND::MEMORY_GET:
-				//NOTE: If we decide to have all views process responses
-				// that fall within it's memory range, the if statement should
-				// be removed.
-				if (!Memory::FromResponse(arResponse)) {
-					Code::FromResponse(arResponse);
+				if (!Shadow::FromResponse(arResponse)) {
+					StructView::FromResponse(arResponse);
 				}
 				break;
-			//Checkpoints all go to BreakPoint module
+			//Checkpoints go to the Heatmap or SMC watches if they are their own,
+			// otherwise BreakPoints
 			case COMMAND::CHECKPOINT_INFO:
-				BreakPoints::ProcessInfo(arResponse);
+				if (!Heatmap::ProcessInfo(arResponse) && !Smc::ProcessInfo(arResponse)) {
+					BreakPoints::ProcessInfo(arResponse);
+				}
+				break;
+			//Memory banks the machine has
+			case COMMAND::BANKS_AVAIL:
+				Banks::FromResponse(arResponse);
 				break;
 			//Registers all go to Register View
 			case COMMAND::REGISTERS_GET:
@@ -415,6 +482,13 @@ void ProcessResponses(  )
 					needStart = !Stopped;
 				}
 				if (!needStart) {
+					//If the IP moved since the last stop the machine executed
+					// code so the shadow copy of memory is out of date
+					if (ip != StopIP) {
+						StopIP = ip;
+						Footprint::Executed();
+						Snapshots::Capture();
+					}
 					//If we request a stop the memory view needs to refresh
 					// and enable the checkpoint to send responses on memory
 					// change while stopped. We disable this checkpoint when
@@ -425,6 +499,11 @@ void ProcessResponses(  )
 				}
 				break;
 			}
+			//VICE snapshot loaded by a quick save slot or batch export
+			case COMMAND::UNDUMP:
+				QuickSave::Restored();
+				ExportView::Restored(arResponse);
+				break;
 			case COMMAND::RESUMED:
 				needStart = false;
 				break;
@@ -463,7 +542,10 @@ void Close(  )
 	SaveSettings();
 //	Checkpoints::Close();
 	BreakPoints::Close();						//Shut down BreakPoint tracking system
+	Heatmap::Disarm();
+	Smc::Disarm();
 	Resume();									//Resume VICE before we exit or it will lock up
+	Flow::ShutDown();
 	Thread::ShutDown();
 }
 
@@ -47,6 +47,7 @@ void FileMenu(  )
 		pFileDialogResult = []( const std::filesystem::path aSelected ) {
 			AddToHistory(aSelected);
 			Labels::Load(aSelected);
+			Regions::SetProject(aSelected);
 			Code::UpdateDisView();
 		};
 		FileDialog.SetTitle("Open Labels");
@@ -84,6 +85,13 @@ void ViceMenu(  )
 		ImGui::SetTooltip(VicePath.c_str());
 	}
 	ImGui::MenuItem("AutoStart", "", &bAutoStartVice);
+	if (bool record = Snapshots::QRecording(); ImGui::MenuItem("Record History", "", &record)) {
+		Snapshots::SetRecording(record);
+	}
+	if (ImGui::IsItemHovered()) {
+		ImGui::SetTooltip("Snapshot memory on every stop, %uK of %uK used"
+			, Snapshots::QBytes() / 1024, Snapshots::QBudget() / 1024);
+	}
 
 	ImGui::Separator();
 
@@ -95,11 +103,17 @@ void ViceMenu(  )
 
 	ImGui::Separator();
 
+	QuickSave::Menu();
+
+	ImGui::Separator();
+
 	if (ImGui::MenuItem("Soft Reset", "Ctrl+R")) {
 		Send(Command::SoftResetCommand);
+		Boundaries::Clear();
 	}
 	if (ImGui::MenuItem("Hard Reset", "Ctrl+Shift+R")) {
 		Send(Command::HardResetCommand);
+		Boundaries::Clear();
 	}
 }
 
@@ -109,6 +123,43 @@ void ViewMenu(  )
 	if (ImGui::MenuItem("Diagnostics", "Ctrl+D")) {
 		Diagnostics::DisplayOn();
 	}
+	//Extra code views, pinned to an address
+	char code[] = "Code1";
+	for ( uint32_t i = 1; i < Code::NUMVIEWS; ++i, ++code[4]) {
+		if (ImGui::MenuItem(code)) {
+			Code::DisplayOn(i);
+		}
+	}
+	if (ImGui::MenuItem("Search", "Ctrl+F")) {
+		SearchView::DisplayOn();
+	}
+	if (ImGui::MenuItem("Scanner")) {
+		ScannerView::DisplayOn();
+	}
+	if (ImGui::MenuItem("Heatmap")) {
+		Heatmap::DisplayOn();
+	}
+	if (ImGui::MenuItem("SMC Sites")) {
+		Smc::DisplayOn();
+	}
+	if (ImGui::MenuItem("Xrefs")) {
+		Xref::DisplayOn();
+	}
+	if (ImGui::MenuItem("Regions")) {
+		Regions::DisplayOn();
+	}
+	if (ImGui::MenuItem("Export")) {
+		ExportView::DisplayOn();
+	}
+	if (ImGui::MenuItem("Compare")) {
+		CompareView::DisplayOn();
+	}
+	if (ImGui::MenuItem("Fill/Copy")) {
+		MemoryOps::DisplayOn();
+	}
+	if (ImGui::MenuItem("Structs")) {
+		StructView::DisplayOn();
+	}
 }
 
 //----------------------------------------------------------------
@@ -0,0 +1,411 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    OpCodes.ipp
+// Compile: 6502.cpp, DisAssembler.cpp, Xref.cpp
+//----------------------------------------------------------------------
+
+#include <array>
+
+//----------------------------------------------------------------
+///Documented OpCode entry for all 255 possible values, BAD for the rest
+inline constexpr OpCode DocumentedA[] = {
+{"BRK", ADDRESS_MODE::NONE, 7},			//0x00
+{"ORA", ADDRESS_MODE::INDIRECT_X, 6},	//0x01
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x02
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x03
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x04
+{"ORA", ADDRESS_MODE::ZERO_PAGE, 3},	//0x05
+{"ASL", ADDRESS_MODE::ZERO_PAGE, 5},	//0x06
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x07
+{"PHP", ADDRESS_MODE::NONE, 3},			//0x08
+{"ORA", ADDRESS_MODE::IMMEDIATE, 2},	//0x09
+{"ASL", ADDRESS_MODE::NONE, 2},			//0x0a
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x0b
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x0c
+{"ORA", ADDRESS_MODE::ABSOLUTE, 4},		//0x0d
+{"ASL", ADDRESS_MODE::ABSOLUTE, 6},		//0x0e
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x0f
+{"BPL", ADDRESS_MODE::RELATIVE, 3},		//0x10
+{"ORA", ADDRESS_MODE::INDIRECT_Y, 5},	//0x11
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x12
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x13
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x14
+{"ORA", ADDRESS_MODE::ZERO_PAGE_X, 4},	//0x15
+{"ASL", ADDRESS_MODE::ZERO_PAGE_X, 6},	//0x16
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x17
+{"CLC", ADDRESS_MODE::NONE, 2},			//0x18
+{"ORA", ADDRESS_MODE::ABSOLUTE_Y, 4},	//0x19
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x1a
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x1b
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x1c
+{"ORA", ADDRESS_MODE::ABSOLUTE_X, 4},	//0x1d
+{"ASL", ADDRESS_MODE::ABSOLUTE_X, 7},	//0x1e
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x1f
+{"JSR", ADDRESS_MODE::ABSOLUTE, 6},		//0x20
+{"AND", ADDRESS_MODE::INDIRECT_X, 6},	//0x21
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x22
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x23
+{"BIT", ADDRESS_MODE::ZERO_PAGE, 3},	//0x24
+{"AND", ADDRESS_MODE::ZERO_PAGE, 3},	//0x25
+{"ROL", ADDRESS_MODE::ZERO_PAGE, 5},	//0x26
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x27
+{"PLP", ADDRESS_MODE::NONE, 4},			//0x28
+{"AND", ADDRESS_MODE::IMMEDIATE, 2},	//0x29
+{"ROL", ADDRESS_MODE::NONE, 2},			//0x2a
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x2b
+{"BIT", ADDRESS_MODE::ABSOLUTE, 4},		//0x2c
+{"AND", ADDRESS_MODE::ABSOLUTE, 4},		//0x2d
+{"ROL", ADDRESS_MODE::ABSOLUTE, 6},		//0x2e
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x2f
+{"BMI", ADDRESS_MODE::RELATIVE, 3},		//0x30
+{"AND", ADDRESS_MODE::INDIRECT_Y, 5},	//0x31
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x32
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x33
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x34
+{"AND", ADDRESS_MODE::ZERO_PAGE_X, 4},	//0x35
+{"ROL", ADDRESS_MODE::ZERO_PAGE_X, 6},	//0x36
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x37
+{"SEC", ADDRESS_MODE::NONE, 2},			//0x38
+{"AND", ADDRESS_MODE::ABSOLUTE_Y, 4},	//0x39
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x3a
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x3b
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x3c
+{"AND", ADDRESS_MODE::ABSOLUTE_X, 4},	//0x3d
+{"ROL", ADDRESS_MODE::ABSOLUTE_X, 7},	//0x3e
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x3f
+{"RTI", ADDRESS_MODE::NONE, 6},			//0x40
+{"EOR", ADDRESS_MODE::INDIRECT_X, 6},	//0x41
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x42
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x43
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x44
+{"EOR", ADDRESS_MODE::ZERO_PAGE, 3},	//0x45
+{"LSR", ADDRESS_MODE::ZERO_PAGE, 5},	//0x46
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x47
+{"PHA", ADDRESS_MODE::NONE, 3},			//0x48
+{"EOR", ADDRESS_MODE::IMMEDIATE, 2},	//0x49
+{"LSR", ADDRESS_MODE::NONE, 2},			//0x4a
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x4b
+{"JMP", ADDRESS_MODE::ABSOLUTE, 3},		//0x4c
+{"EOR", ADDRESS_MODE::ABSOLUTE, 4},		//0x4d
+{"LSR", ADDRESS_MODE::ABSOLUTE, 6},		//0x4e
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x4f
+{"BVC", ADDRESS_MODE::RELATIVE, 3},		//0x50
+{"EOR", ADDRESS_MODE::INDIRECT_Y, 5},	//0x51
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x52
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x53
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x54
+{"EOR", ADDRESS_MODE::ZERO_PAGE_X, 4},	//0x55
+{"LSR", ADDRESS_MODE::ZERO_PAGE_X, 6},	//0x56
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x57
+{"CLI", ADDRESS_MODE::NONE, 2},			//0x58
+{"EOR", ADDRESS_MODE::ABSOLUTE_Y, 4},	//0x59
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x5a
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x5b
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x5c
+{"EOR", ADDRESS_MODE::ABSOLUTE_X, 4},	//0x5d
+{"LSR", ADDRESS_MODE::ABSOLUTE_X, 7},	//0x5e
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x5f
+{"RTS", ADDRESS_MODE::NONE, 6},			//0x60
+{"ADC", ADDRESS_MODE::INDIRECT_X, 6},	//0x61
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x62
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x63
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x64
+{"ADC", ADDRESS_MODE::ZERO_PAGE, 3},	//0x65
+{"ROR", ADDRESS_MODE::ZERO_PAGE, 5},	//0x66
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x67
+{"PLA", ADDRESS_MODE::NONE, 4},			//0x68
+{"ADC", ADDRESS_MODE::IMMEDIATE, 2},	//0x69
+{"ROR", ADDRESS_MODE::NONE, 2},			//0x6a
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x6b
+{"JMP", ADDRESS_MODE::INDIRECT, 5},		//0x6c
+{"ADC", ADDRESS_MODE::ABSOLUTE, 4},		//0x6d
+{"ROR", ADDRESS_MODE::ABSOLUTE, 6},		//0x6e
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x6f
+{"BVS", ADDRESS_MODE::RELATIVE, 3},		//0x70
+{"ADC", ADDRESS_MODE::INDIRECT_Y, 5},	//0x71
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x72
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x73
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x74
+{"ADC", ADDRESS_MODE::ZERO_PAGE_X, 4},	//0x75
+{"ROR", ADDRESS_MODE::ZERO_PAGE_X, 6},	//0x76
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x77
+{"SEI", ADDRESS_MODE::NONE, 2},			//0x78
+{"ADC", ADDRESS_MODE::ABSOLUTE_Y, 4},	//0x79
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x7a
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x7b
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x7c
+{"ADC", ADDRESS_MODE::ABSOLUTE_X, 4},	//0x7d
+{"ROR", ADDRESS_MODE::ABSOLUTE_X, 7},	//0x7e
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x7f
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x80
+{"STA", ADDRESS_MODE::INDIRECT_X, 6},	//0x81
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x82
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x83
+{"STY", ADDRESS_MODE::ZERO_PAGE, 3},	//0x84
+{"STA", ADDRESS_MODE::ZERO_PAGE, 3},	//0x85
+{"STX", ADDRESS_MODE::ZERO_PAGE, 3},	//0x86
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x87
+{"DEY", ADDRESS_MODE::NONE, 2},			//0x88
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x89
+{"TXA", ADDRESS_MODE::NONE, 2},			//0x8a
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x8b
+{"STY", ADDRESS_MODE::ABSOLUTE, 4},		//0x8c
+{"STA", ADDRESS_MODE::ABSOLUTE, 4},		//0x8d
+{"STX", ADDRESS_MODE::ABSOLUTE, 4},		//0x8e
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x8f
+{"BCC", ADDRESS_MODE::RELATIVE, 3},		//0x90
+{"STA", ADDRESS_MODE::INDIRECT_Y, 6},	//0x91
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x92
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x93
+{"STY", ADDRESS_MODE::ZERO_PAGE_X, 4},	//0x94
+{"STA", ADDRESS_MODE::ZERO_PAGE_X, 4},	//0x95
+{"STX", ADDRESS_MODE::ZERO_PAGE_Y, 4},	//0x96
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x97
+{"TYA", ADDRESS_MODE::NONE, 2},			//0x98
+{"STA", ADDRESS_MODE::ABSOLUTE_Y, 5},	//0x99
+{"TXS", ADDRESS_MODE::NONE, 2},			//0x9a
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x9b
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x9c
+{"STA", ADDRESS_MODE::ABSOLUTE_X, 5},	//0x9d
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x9e
+{"BAD", ADDRESS_MODE::NONE, 2},			//0x9f
+{"LDY", ADDRESS_MODE::IMMEDIATE, 2},	//0xa0
+{"LDA", ADDRESS_MODE::INDIRECT_X, 6},	//0xa1
+{"LDX", ADDRESS_MODE::IMMEDIATE, 2},	//0xa2
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xa3
+{"LDY", ADDRESS_MODE::ZERO_PAGE, 3},	//0xa4
+{"LDA", ADDRESS_MODE::ZERO_PAGE, 3},	//0xa5
+{"LDX", ADDRESS_MODE::ZERO_PAGE, 3},	//0xa6
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xa7
+{"TAY", ADDRESS_MODE::NONE, 2},			//0xa8
+{"LDA", ADDRESS_MODE::IMMEDIATE, 2},	//0xa9
+{"TAX", ADDRESS_MODE::NONE, 2},			//0xaa
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xab
+{"LDY", ADDRESS_MODE::ABSOLUTE, 4},		//0xac
+{"LDA", ADDRESS_MODE::ABSOLUTE, 4},		//0xad
+{"LDX", ADDRESS_MODE::ABSOLUTE, 4},		//0xae
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xaf
+{"BCS", ADDRESS_MODE::RELATIVE, 3},		//0xb0
+{"LDA", ADDRESS_MODE::INDIRECT_Y, 5},	//0xb1
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xb2
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xb3
+{"LDY", ADDRESS_MODE::ZERO_PAGE_X, 4},	//0xb4
+{"LDA", ADDRESS_MODE::ZERO_PAGE_X, 4},	//0xb5
+{"LDX", ADDRESS_MODE::ZERO_PAGE_Y, 4},	//0xb6
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xb7
+{"CLV", ADDRESS_MODE::NONE, 2},			//0xb8
+{"LDA", ADDRESS_MODE::ABSOLUTE_Y, 4},	//0xb9
+{"TSX", ADDRESS_MODE::NONE, 2},			//0xba
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xbb
+{"LDY", ADDRESS_MODE::ABSOLUTE_X, 4},	//0xbc
+{"LDA", ADDRESS_MODE::ABSOLUTE_X, 4},	//0xbd
+{"LDX", ADDRESS_MODE::ABSOLUTE_Y, 4},	//0xbe
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xbf
+{"CPY", ADDRESS_MODE::IMMEDIATE, 2},	//0xc0
+{"CMP", ADDRESS_MODE::INDIRECT_X, 6},	//0xc1
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xc2
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xc3
+{"CPY", ADDRESS_MODE::ZERO_PAGE, 3},	//0xc4
+{"CMP", ADDRESS_MODE::ZERO_PAGE, 3},	//0xc5
+{"DEC", ADDRESS_MODE::ZERO_PAGE, 5},	//0xc6
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xc7
+{"INY", ADDRESS_MODE::NONE, 2},			//0xc8
+{"CMP", ADDRESS_MODE::IMMEDIATE, 2},	//0xc9
+{"DEX", ADDRESS_MODE::NONE, 2},			//0xca
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xcb
+{"CPY", ADDRESS_MODE::ABSOLUTE, 4},		//0xcc
+{"CMP", ADDRESS_MODE::ABSOLUTE, 4},		//0xcd
+{"DEC", ADDRESS_MODE::ABSOLUTE, 6},		//0xce
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xcf
+{"BNE", ADDRESS_MODE::RELATIVE, 3},		//0xd0
+{"CMP", ADDRESS_MODE::INDIRECT_Y, 5},	//0xd1
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xd2
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xd3
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xd4
+{"CMP", ADDRESS_MODE::ZERO_PAGE_X, 4},	//0xd5
+{"DEC", ADDRESS_MODE::ZERO_PAGE_X, 6},	//0xd6
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xd7
+{"CLD", ADDRESS_MODE::NONE, 2},			//0xd8
+{"CMP", ADDRESS_MODE::ABSOLUTE_Y, 4},	//0xd9
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xda
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xdb
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xdc
+{"CMP", ADDRESS_MODE::ABSOLUTE_X, 4},	//0xdd
+{"DEC", ADDRESS_MODE::ABSOLUTE_X, 7},	//0xde
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xdf
+{"CPX", ADDRESS_MODE::IMMEDIATE, 2},	//0xe0
+{"SBC", ADDRESS_MODE::INDIRECT_X, 6},	//0xe1
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xe2
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xe3
+{"CPX", ADDRESS_MODE::ZERO_PAGE, 3},	//0xe4
+{"SBC", ADDRESS_MODE::ZERO_PAGE, 3},	//0xe5
+{"INC", ADDRESS_MODE::ZERO_PAGE, 5},	//0xe6
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xe7
+{"INX", ADDRESS_MODE::NONE, 2},			//0xe8
+{"SBC", ADDRESS_MODE::IMMEDIATE, 2},	//0xe9
+{"NOP", ADDRESS_MODE::NONE, 2},			//0xea
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xeb
+{"CPX", ADDRESS_MODE::ABSOLUTE, 4},		//0xec
+{"SBC", ADDRESS_MODE::ABSOLUTE, 4},		//0xed
+{"INC", ADDRESS_MODE::ABSOLUTE, 6},		//0xee
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xef
+{"BEQ", ADDRESS_MODE::RELATIVE, 3},		//0xf0
+{"SBC", ADDRESS_MODE::INDIRECT_Y, 5},	//0xf1
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xf2
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xf3
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xf4
+{"SBC", ADDRESS_MODE::ZERO_PAGE_X, 4},	//0xf5
+{"INC", ADDRESS_MODE::ZERO_PAGE_X, 6},	//0xf6
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xf7
+{"SED", ADDRESS_MODE::NONE, 2},			//0xf8
+{"SBC", ADDRESS_MODE::ABSOLUTE_Y, 4},	//0xf9
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xfa
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xfb
+{"BAD", ADDRESS_MODE::NONE, 2},			//0xfc
+{"SBC", ADDRESS_MODE::ABSOLUTE_X, 4},	//0xfd
+{"INC", ADDRESS_MODE::ABSOLUTE_X, 7},	//0xfe
+{"BAD", ADDRESS_MODE::NONE, 2}			//0xff
+};
+
+//----------------------------------------------------------------
+///The stable undocumented opcodes of the NMOS 6502/6510. The unstable
+/// ones (ANE, LXA, SHA, SHX, SHY, TAS) and the JAMs stay BAD
+struct Undocumented
+{
+	uint8_t Op;
+	OpCode Code;
+};
+
+inline constexpr Undocumented UndocumentedA[] = {
+{0x03, {"SLO", ADDRESS_MODE::INDIRECT_X, 8, true}},
+{0x04, {"NOP", ADDRESS_MODE::ZERO_PAGE, 3, true}},
+{0x07, {"SLO", ADDRESS_MODE::ZERO_PAGE, 5, true}},
+{0x0b, {"ANC", ADDRESS_MODE::IMMEDIATE, 2, true}},
+{0x0c, {"NOP", ADDRESS_MODE::ABSOLUTE, 4, true}},
+{0x0f, {"SLO", ADDRESS_MODE::ABSOLUTE, 6, true}},
+{0x13, {"SLO", ADDRESS_MODE::INDIRECT_Y, 8, true}},
+{0x14, {"NOP", ADDRESS_MODE::ZERO_PAGE_X, 4, true}},
+{0x17, {"SLO", ADDRESS_MODE::ZERO_PAGE_X, 6, true}},
+{0x1a, {"NOP", ADDRESS_MODE::NONE, 2, true}},
+{0x1b, {"SLO", ADDRESS_MODE::ABSOLUTE_Y, 7, true}},
+{0x1c, {"NOP", ADDRESS_MODE::ABSOLUTE_X, 4, true}},
+{0x1f, {"SLO", ADDRESS_MODE::ABSOLUTE_X, 7, true}},
+{0x23, {"RLA", ADDRESS_MODE::INDIRECT_X, 8, true}},
+{0x27, {"RLA", ADDRESS_MODE::ZERO_PAGE, 5, true}},
+{0x2b, {"ANC", ADDRESS_MODE::IMMEDIATE, 2, true}},
+{0x2f, {"RLA", ADDRESS_MODE::ABSOLUTE, 6, true}},
+{0x33, {"RLA", ADDRESS_MODE::INDIRECT_Y, 8, true}},
+{0x34, {"NOP", ADDRESS_MODE::ZERO_PAGE_X, 4, true}},
+{0x37, {"RLA", ADDRESS_MODE::ZERO_PAGE_X, 6, true}},
+{0x3a, {"NOP", ADDRESS_MODE::NONE, 2, true}},
+{0x3b, {"RLA", ADDRESS_MODE::ABSOLUTE_Y, 7, true}},
+{0x3c, {"NOP", ADDRESS_MODE::ABSOLUTE_X, 4, true}},
+{0x3f, {"RLA", ADDRESS_MODE::ABSOLUTE_X, 7, true}},
+{0x43, {"SRE", ADDRESS_MODE::INDIRECT_X, 8, true}},
+{0x44, {"NOP", ADDRESS_MODE::ZERO_PAGE, 3, true}},
+{0x47, {"SRE", ADDRESS_MODE::ZERO_PAGE, 5, true}},
+{0x4b, {"ALR", ADDRESS_MODE::IMMEDIATE, 2, true}},
+{0x4f, {"SRE", ADDRESS_MODE::ABSOLUTE, 6, true}},
+{0x53, {"SRE", ADDRESS_MODE::INDIRECT_Y, 8, true}},
+{0x54, {"NOP", ADDRESS_MODE::ZERO_PAGE_X, 4, true}},
+{0x57, {"SRE", ADDRESS_MODE::ZERO_PAGE_X, 6, true}},
+{0x5a, {"NOP", ADDRESS_MODE::NONE, 2, true}},
+{0x5b, {"SRE", ADDRESS_MODE::ABSOLUTE_Y, 7, true}},
+{0x5c, {"NOP", ADDRESS_MODE::ABSOLUTE_X, 4, true}},
+{0x5f, {"SRE", ADDRESS_MODE::ABSOLUTE_X, 7, true}},
+{0x63, {"RRA", ADDRESS_MODE::INDIRECT_X, 8, true}},
+{0x64, {"NOP", ADDRESS_MODE::ZERO_PAGE, 3, true}},
+{0x67, {"RRA", ADDRESS_MODE::ZERO_PAGE, 5, true}},
+{0x6b, {"ARR", ADDRESS_MODE::IMMEDIATE, 2, true}},
+{0x6f, {"RRA", ADDRESS_MODE::ABSOLUTE, 6, true}},
+{0x73, {"RRA", ADDRESS_MODE::INDIRECT_Y, 8, true}},
+{0x74, {"NOP", ADDRESS_MODE::ZERO_PAGE_X, 4, true}},
+{0x77, {"RRA", ADDRESS_MODE::ZERO_PAGE_X, 6, true}},
+{0x7a, {"NOP", ADDRESS_MODE::NONE, 2, true}},
+{0x7b, {"RRA", ADDRESS_MODE::ABSOLUTE_Y, 7, true}},
+{0x7c, {"NOP", ADDRESS_MODE::ABSOLUTE_X, 4, true}},
+{0x7f, {"RRA", ADDRESS_MODE::ABSOLUTE_X, 7, true}},
+{0x80, {"NOP", ADDRESS_MODE::IMMEDIATE, 2, true}},
+{0x82, {"NOP", ADDRESS_MODE::IMMEDIATE, 2, true}},
+{0x83, {"SAX", ADDRESS_MODE::INDIRECT_X, 6, true}},
+{0x87, {"SAX", ADDRESS_MODE::ZERO_PAGE, 3, true}},
+{0x89, {"NOP", ADDRESS_MODE::IMMEDIATE, 2, true}},
+{0x8f, {"SAX", ADDRESS_MODE::ABSOLUTE, 4, true}},
+{0x97, {"SAX", ADDRESS_MODE::ZERO_PAGE_Y, 4, true}},
+{0xa3, {"LAX", ADDRESS_MODE::INDIRECT_X, 6, true}},
+{0xa7, {"LAX", ADDRESS_MODE::ZERO_PAGE, 3, true}},
+{0xaf, {"LAX", ADDRESS_MODE::ABSOLUTE, 4, true}},
+{0xb3, {"LAX", ADDRESS_MODE::INDIRECT_Y, 5, true}},
+{0xb7, {"LAX", ADDRESS_MODE::ZERO_PAGE_Y, 4, true}},
+{0xbb, {"LAS", ADDRESS_MODE::ABSOLUTE_Y, 4, true}},
+{0xbf, {"LAX", ADDRESS_MODE::ABSOLUTE_Y, 4, true}},
+{0xc2, {"NOP", ADDRESS_MODE::IMMEDIATE, 2, true}},
+{0xc3, {"DCP", ADDRESS_MODE::INDIRECT_X, 8, true}},
+{0xc7, {"DCP", ADDRESS_MODE::ZERO_PAGE, 5, true}},
+{0xcb, {"SBX", ADDRESS_MODE::IMMEDIATE, 2, true}},
+{0xcf, {"DCP", ADDRESS_MODE::ABSOLUTE, 6, true}},
+{0xd3, {"DCP", ADDRESS_MODE::INDIRECT_Y, 8, true}},
+{0xd4, {"NOP", ADDRESS_MODE::ZERO_PAGE_X, 4, true}},
+{0xd7, {"DCP", ADDRESS_MODE::ZERO_PAGE_X, 6, true}},
+{0xda, {"NOP", ADDRESS_MODE::NONE, 2, true}},
+{0xdb, {"DCP", ADDRESS_MODE::ABSOLUTE_Y, 7, true}},
+{0xdc, {"NOP", ADDRESS_MODE::ABSOLUTE_X, 4, true}},
+{0xdf, {"DCP", ADDRESS_MODE::ABSOLUTE_X, 7, true}},
+{0xe2, {"NOP", ADDRESS_MODE::IMMEDIATE, 2, true}},
+{0xe3, {"ISC", ADDRESS_MODE::INDIRECT_X, 8, true}},
+{0xe7, {"ISC", ADDRESS_MODE::ZERO_PAGE, 5, true}},
+{0xeb, {"SBC", ADDRESS_MODE::IMMEDIATE, 2, true}},
+{0xef, {"ISC", ADDRESS_MODE::ABSOLUTE, 6, true}},
+{0xf3, {"ISC", ADDRESS_MODE::INDIRECT_Y, 8, true}},
+{0xf4, {"NOP", ADDRESS_MODE::ZERO_PAGE_X, 4, true}},
+{0xf7, {"ISC", ADDRESS_MODE::ZERO_PAGE_X, 6, true}},
+{0xfa, {"NOP", ADDRESS_MODE::NONE, 2, true}},
+{0xfb, {"ISC", ADDRESS_MODE::ABSOLUTE_Y, 7, true}},
+{0xfc, {"NOP", ADDRESS_MODE::ABSOLUTE_X, 4, true}},
+{0xff, {"ISC", ADDRESS_MODE::ABSOLUTE_X, 7, true}}
+};
+
+//----------------------------------------------------------------
+///Table used by the assembler, disassembler and timing. Picked at compile
+/// time by UNDOCUMENTED_OPCODES so lookups stay a plain index
+constexpr std::array<OpCode, 0x100> MakeOpCodes(  )
+{
+	std::array<OpCode, 0x100> opcodes{};
+	for ( uint32_t i = 0; i < opcodes.size(); ++i) {
+		opcodes[i] = DocumentedA[i];
+	}
+#if UNDOCUMENTED_OPCODES
+	for ( const auto &rundoc : UndocumentedA ) {
+		opcodes[rundoc.Op] = rundoc.Code;
+	}
+#endif
+	return opcodes;
+}
+
+inline constexpr std::array<OpCode, 0x100> OpCodeA = MakeOpCodes();
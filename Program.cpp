@@ -30,9 +30,13 @@
 //----------------------------------------------------------------------
 
 #include "Program.h"
+#include "Boundaries.h"
 #include "Command.h"
 #include "Labels.h"
 #include "Monitor.h"
+#include "Regions.h"
+
+#include <fstream>
 
 namespace Program
 {
@@ -44,7 +48,48 @@ namespace Program
 
 constexpr uint32_t FILELEN = 0xff;				//Maximum file name size
 
+constexpr uint32_t BASICSTART = 0x0801;		//Load address of BASIC programs
+constexpr uint8_t SYSTOKEN = 0x9e;				//BASIC token for SYS
+
 CommandPtr LoadFileCommand = Command::Create(COMMAND::AUTOSTART, FILELEN);
+uint32_t Start = 0x10000;						//Start address of last program
+
+//----------------------------------------------------------------
+uint32_t FindStart( const uint8_t *apData, uint32_t aLen )
+{
+	if (aLen < 3) {
+		return 0x10000;
+	}
+
+	uint32_t start = apData[0] | (apData[1] << 8);
+	if (start == BASICSTART) {
+		//Skip the load address, link and line number and look for SYS on the first line
+		for ( uint32_t i = 6; (i < aLen) && apData[i]; ++i) {
+			if (apData[i] == SYSTOKEN) {
+				uint32_t sys = 0;
+				for ( ++i; (i < aLen) && (apData[i] == ' '); ++i) { }
+				for ( ; (i < aLen) && (apData[i] >= '0') && (apData[i] <= '9'); ++i) {
+					sys = (sys * 10) + (apData[i] - '0');
+				}
+				if (sys && (sys < 0x10000)) {
+					start = sys;
+				}
+				break;
+			}
+		}
+	}
+	return start;
+}
+
+//----------------------------------------------------------------
+///Read the start address from the start of the .prg file
+uint32_t ReadStart( const std::filesystem::path &arPath )
+{
+	uint8_t data[0x40] = { 0 };
+	std::ifstream file(arPath, std::ios::binary);
+	file.read(reinterpret_cast<char*>(data), sizeof(data));
+	return FindStart(data, static_cast<uint32_t>(file.gcount()));
+}
 
 //----------------------------------------------------------------
 bool Load( std::filesystem::path aPath )
@@ -59,6 +104,9 @@ bool Load( std::filesystem::path aPath )
 		LoadFileCommand->Add(static_cast<uint8_t>(len));
 		LoadFileCommand->Add(rname.c_str());	//Add file name
 		Monitor::Send(LoadFileCommand);			//Send command
+		Start = ReadStart(aPath);
+		Boundaries::Clear();					//IPs seen in the last program
+		Regions::SetProject(aPath);				//Code/data marks kept next to the program
 
 		aPath.replace_extension(".vs");			//Change extension to .vs
 		Labels::Load(aPath);					//Attempt to load .vs file
@@ -69,5 +117,11 @@ bool Load( std::filesystem::path aPath )
 	return bres;
 }
 
+//----------------------------------------------------------------
+uint32_t QStart(  )
+{
+	return Start;
+}
+
 
 }	//namespace Program
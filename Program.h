@@ -40,4 +40,15 @@ namespace Program
 	//----------------------------------------------------------------
 	///Send load command for given program to VICE and load .vs file
 	bool Load( std::filesystem::path aPath );
+
+	//----------------------------------------------------------------
+	///Get address the last loaded program starts at, the SYS address of
+	/// a BASIC stub or else its load address. 0x10000 if none
+	uint32_t QStart(  );
+
+	//----------------------------------------------------------------
+	///Get start address of .prg file data beginning with its 2 byte load
+	/// address. The SYS address of a BASIC stub or else the load address.
+	/// 0x10000 if too short
+	uint32_t FindStart( const uint8_t *apData, uint32_t aLen );
 }	//namespace Program
@@ -0,0 +1,204 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    QuickSave.cpp
+//----------------------------------------------------------------------
+
+#include "QuickSave.h"
+#include "Boundaries.h"
+#include "BreakPoints.h"
+#include "Code.h"
+#include "Command.h"
+#include "DisCache.h"
+#include "ImGuiUtils.h"
+#include "Labels.h"
+#include "Memory.h"
+#include "Monitor.h"
+#include "Shadow.h"
+
+#include <filesystem>
+#include <fstream>
+#include <imgui.h>
+
+namespace QuickSave
+{
+
+//DUMP
+//byte 0: Save ROMs to snapshot file? 0x01: true, 0x00: false
+//byte 1: Save disks to snapshot file? 0x01: true, 0x00: false
+//byte 2: Length of filename
+//byte 3+: Filename
+//UNDUMP
+//byte 0: Length of filename
+//byte 1+: Filename
+
+constexpr uint32_t FILELEN = 0xff;				//Maximum file name size
+constexpr uint32_t DUMPHEADER = 3;				//Bytes before the DUMP file name
+constexpr uint32_t UNDUMPHEADER = 1;			//Bytes before the UNDUMP file name
+constexpr char SLOTDIR[] = "QuickSave";
+
+CommandPtr DumpCommand = Command::Create(COMMAND::DUMP, DUMPHEADER + FILELEN);
+CommandPtr UndumpCommand = Command::Create(COMMAND::UNDUMP, UNDUMPHEADER + FILELEN);
+
+//----------------------------------------------------------------
+///Get path of slot file with given extension. VICE may not share our
+/// working directory so the path is absolute
+std::filesystem::path SlotPath( uint32_t aSlot, const char *apExt )
+{
+	auto path = std::filesystem::absolute(SLOTDIR);
+	path /= "slot";
+	path += std::to_string(aSlot + 1);
+	path += apExt;
+	return path;
+}
+
+//----------------------------------------------------------------
+bool Save( uint32_t aSlot )
+{
+	bool bres = false;
+	if ((aSlot < NUMSLOTS) && (Monitor::ViceState() != VICESTATE::DISCONNECTED)) {
+		std::error_code err;
+		std::filesystem::create_directories(SLOTDIR, err);
+
+		const auto name = SlotPath(aSlot, ".vsf").string();
+		const auto len = name.length() + 1;		//+ 1 to include null termination
+		if (bres = (len <= FILELEN); bres) {
+			DumpCommand->Reset();
+			DumpCommand->Add(0_u8);				//Don't save ROMs
+			DumpCommand->Add(1_u8);				//Save disks
+			DumpCommand->Add(static_cast<uint8_t>(len));
+			DumpCommand->Add(name.c_str());
+			Monitor::Send(DumpCommand);
+
+			//Save debugger state alongside
+			nlohmann::json data;
+			BreakPoints::StateToJson(data);
+			Code::ToJson(data);
+			Memory::ToJson(data);
+			data["LabelFile"] = Labels::QFile().string();
+
+			auto strm = std::ofstream(SlotPath(aSlot, ".json"));
+			strm << data.dump(2);
+			bres = strm.good();
+		}
+	}
+	return bres;
+}
+
+//----------------------------------------------------------------
+bool Restore( uint32_t aSlot )
+{
+	bool bres = false;
+	if (QUsed(aSlot) && (Monitor::ViceState() != VICESTATE::DISCONNECTED)) {
+		const auto name = SlotPath(aSlot, ".vsf").string();
+		const auto len = name.length() + 1;		//+ 1 to include null termination
+		auto strm = std::ifstream(SlotPath(aSlot, ".json"));
+		if (bres = (len <= FILELEN) && strm.good(); bres) {
+			UndumpCommand->Reset();
+			UndumpCommand->Add(static_cast<uint8_t>(len));
+			UndumpCommand->Add(name.c_str());
+			Monitor::Send(UndumpCommand);
+
+			//A damaged state file still restores the snapshot, just not our state
+			auto data = nlohmann::json::parse(strm, nullptr, false);
+			if (bres = !data.is_discarded() && data.is_object(); bres) {
+				const std::string labels = data.value("LabelFile", "");
+				if (!labels.empty() && (labels != Labels::QFile().string())) {
+					Labels::Load(labels);
+				}
+				BreakPoints::StateFromJson(data);
+				Code::FromJson(data);
+				Memory::FromJson(data);
+			}
+		}
+	}
+	return bres;
+}
+
+//----------------------------------------------------------------
+bool QUsed( uint32_t aSlot )
+{
+	std::error_code err;
+	return (aSlot < NUMSLOTS)
+		&& std::filesystem::exists(SlotPath(aSlot, ".vsf"), err)
+		&& std::filesystem::exists(SlotPath(aSlot, ".json"), err);
+}
+
+//----------------------------------------------------------------
+void Restored(  )
+{
+	//Whole machine state replaced so anything we've read is stale
+	Shadow::Invalidate();
+	Boundaries::Clear();
+	DisCache::Clear();
+	Memory::Refresh();
+	Code::Refresh();
+	Monitor::Send(Command::GetRegsCommand);
+}
+
+//----------------------------------------------------------------
+void Keys(  )
+{
+	//Ignore keys while typing into a field
+	if (!CtrlDown() || ImGui::GetIO().WantTextInput) return;
+
+	for ( uint32_t i = 0; i < NUMSLOTS; ++i) {
+		if (ImGui::IsKeyPressed(static_cast<ImGuiKey>(ImGuiKey_1 + i), false)) {
+			ShiftDown() ? Save(i) : Restore(i);
+		}
+	}
+}
+
+//----------------------------------------------------------------
+void Menu(  )
+{
+	char label[16] = "Slot 1";
+	char saveKey[16] = "Ctrl+Shift+1";
+	char loadKey[16] = "Ctrl+1";
+
+	if (ImGui::BeginMenu("Quick Save")) {
+		for ( uint32_t i = 0; i < NUMSLOTS; ++i) {
+			label[5] = saveKey[11] = static_cast<char>('1' + i);
+			if (ImGui::MenuItem(label, saveKey)) {
+				Save(i);
+			}
+		}
+		ImGui::EndMenu();
+	}
+	if (ImGui::BeginMenu("Quick Load")) {
+		for ( uint32_t i = 0; i < NUMSLOTS; ++i) {
+			label[5] = loadKey[5] = static_cast<char>('1' + i);
+			if (ImGui::MenuItem(label, loadKey, false, QUsed(i))) {
+				Restore(i);
+			}
+		}
+		ImGui::EndMenu();
+	}
+}
+
+}	//namespace QuickSave
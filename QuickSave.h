@@ -0,0 +1,69 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    QuickSave.h
+//----------------------------------------------------------------------
+
+#pragma once
+
+#include "types.h"
+
+///Quick save slots. Each slot pairs a VICE snapshot (DUMP/UNDUMP) with
+/// the debugger state (breakpoints, view addresses and label file) so a
+/// restore puts both back to the same point.
+namespace QuickSave
+{
+
+constexpr uint32_t NUMSLOTS = 4;
+
+//----------------------------------------------------------------
+///Save VICE and debugger state to the slot
+bool Save( uint32_t aSlot );
+
+//----------------------------------------------------------------
+///Restore VICE and debugger state from the slot. Return false if the
+/// slot can't be used or its debugger state is damaged
+bool Restore( uint32_t aSlot );
+
+//----------------------------------------------------------------
+///Return true if the slot has been saved
+bool QUsed( uint32_t aSlot );
+
+//----------------------------------------------------------------
+///Called after VICE reports the snapshot loaded to refresh views
+void Restored(  );
+
+//----------------------------------------------------------------
+///Handle slot hotkeys, Ctrl+Shift+n to save and Ctrl+n to restore
+void Keys(  );
+
+//----------------------------------------------------------------
+///Add slot items to a menu
+void Menu(  );
+
+}	//namespace QuickSave
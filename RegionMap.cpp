@@ -0,0 +1,262 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    RegionMap.cpp
+//----------------------------------------------------------------------
+
+#include "Regions.h"
+#include "6502.h"
+
+#include <algorithm>
+#include <bitset>
+#include <memory>
+
+//Map and Classify need nothing of the debugger's state, so they are
+// kept apart from the Regions window for the tools and tests that use them
+namespace Regions
+{
+
+constexpr uint32_t IMAGESIZE = 0x10000;
+constexpr uint32_t TEXTMIN = 8;					//Shortest run of characters taken as text
+constexpr uint32_t TABLEMIN = 2;				//Fewest code addresses in a row taken as a table
+constexpr uint32_t FILLMIN = 4;					//Shortest run of one value taken as fill
+
+//----------------------------------------------------------------
+std::vector<Map::Entry>::const_iterator Map::Find( uint16_t aAddress ) const
+{
+	//The first entry starts at 0 so there is always one before
+	return std::upper_bound(Entries.begin(), Entries.end(), aAddress
+		, []( uint16_t aValue, const Entry &arEntry ) { return aValue < arEntry.Start; }) - 1;
+}
+
+//----------------------------------------------------------------
+Run Map::QRun( uint16_t aAddress ) const
+{
+	const auto it = Find(aAddress);
+	const uint32_t end = ((it + 1) != Entries.end()) ? (it + 1)->Start - 1u : 0xffffu;
+	return { it->Start, static_cast<uint16_t>(end), it->Type };
+}
+
+//----------------------------------------------------------------
+void Map::Set( uint16_t aStart, uint16_t aEnd, TYPE aeType )
+{
+	if (aEnd < aStart) {
+		return;
+	}
+
+	//Drop the runs starting inside the range, then put back the one
+	// carrying on after it
+	const TYPE after = Get(aEnd);
+	auto first = std::lower_bound(Entries.begin(), Entries.end(), aStart
+		, []( const Entry &arEntry, uint16_t aValue ) { return arEntry.Start < aValue; });
+	auto last = std::upper_bound(first, Entries.end(), aEnd
+		, []( uint16_t aValue, const Entry &arEntry ) { return aValue < arEntry.Start; });
+	auto it = Entries.erase(first, last);
+	if ((aEnd < 0xffff) && ((it == Entries.end()) || (it->Start != (aEnd + 1)))) {
+		it = Entries.insert(it, { static_cast<uint16_t>(aEnd + 1), after });
+	}
+	it = Entries.insert(it, { aStart, aeType });
+
+	//Join with neighbours of the same type
+	if (((it + 1) != Entries.end()) && ((it + 1)->Type == aeType)) {
+		Entries.erase(it + 1);
+	}
+	if ((it != Entries.begin()) && ((it - 1)->Type == aeType)) {
+		Entries.erase(it);
+	}
+}
+
+//----------------------------------------------------------------
+void Map::Assign( const TYPE *apTypes )
+{
+	Entries.clear();
+	for ( uint32_t addr = 0; addr < IMAGESIZE; ++addr) {
+		if (Entries.empty() || (Entries.back().Type != apTypes[addr])) {
+			Entries.push_back({ static_cast<uint16_t>(addr), apTypes[addr] });
+		}
+	}
+}
+
+//----------------------------------------------------------------
+void Map::Overlay( const Map &arTop )
+{
+	arTop.ForEach([&]( const Run &arRun ) {
+		if (arRun.Type != TYPE::UNKNOWN) {
+			Set(arRun.Start, arRun.End, arRun.Type);
+		}
+	});
+}
+
+//----------------------------------------------------------------
+///Return true for PETSCII a program prints
+constexpr bool QPrintable( uint8_t aChar )
+{
+	return ((aChar >= 0x20) && (aChar <= 0x5f)) || ((aChar >= 0xc1) && (aChar <= 0xda));
+}
+
+//----------------------------------------------------------------
+constexpr bool QLetter( uint8_t aChar )
+{
+	return ((aChar >= 0x41) && (aChar <= 0x5a)) || ((aChar >= 0xc1) && (aChar <= 0xda));
+}
+
+//----------------------------------------------------------------
+///Sorts the gaps between Flow's blocks into text, address tables and
+/// bytes. Whatever could still be code is left unknown
+class Classifier
+{
+public:
+	//----------------------------------------------------------------
+	Classifier( const uint8_t *apImage, TYPE *apTypes, const std::bitset<IMAGESIZE> &arStarts )
+	: pImage(apImage), pTypes(apTypes), rStarts(arStarts) { }
+
+	//----------------------------------------------------------------
+	///Classify the gap from aStart to aEnd inclusive
+	void Gap( uint32_t aStart, uint32_t aEnd )
+	{
+		uint32_t rest = aStart;					//Start of bytes not yet claimed
+		for ( uint32_t addr = aStart; addr <= aEnd; ) {
+			uint32_t len = Text(addr, aEnd);
+			TYPE etype = TYPE::TEXT;
+			if (!len) {
+				len = Table(addr, aEnd);
+				etype = TYPE::WORDS;
+			}
+			if (!len) {
+				//Skip the rest of a run of characters that wasn't text
+				for ( ++addr; (addr <= aEnd) && QPrintable(pImage[addr]) && QPrintable(pImage[addr - 1]); ++addr) { }
+				continue;
+			}
+
+			Rest(rest, addr);
+			std::fill(pTypes + addr, pTypes + addr + len, etype);
+			addr += len;
+			rest = addr;
+		}
+		Rest(rest, aEnd + 1);
+	}
+
+private:
+	const uint8_t *pImage;
+	TYPE *pTypes;
+	const std::bitset<IMAGESIZE> &rStarts;		//Block starts
+
+	//----------------------------------------------------------------
+	///Get length of text starting at an address, 0 if it isn't. Text is
+	/// a run of printable characters at least half of which are letters
+	uint32_t Text( uint32_t aAddress, uint32_t aEnd ) const
+	{
+		uint32_t letters = 0;
+		uint32_t addr = aAddress;
+		for ( ; (addr <= aEnd) && QPrintable(pImage[addr]); ++addr) {
+			letters += QLetter(pImage[addr]);
+		}
+		const uint32_t len = addr - aAddress;
+		return ((len >= TEXTMIN) && ((letters * 2) >= len)) ? len : 0;
+	}
+
+	//----------------------------------------------------------------
+	///Get length of a table of code addresses starting at an address, 0
+	/// if it isn't. Addresses one short of a block are pushed for RTS
+	uint32_t Table( uint32_t aAddress, uint32_t aEnd ) const
+	{
+		uint32_t addr = aAddress;
+		for ( ; (addr + 1) <= aEnd; addr += 2) {
+			const uint16_t value = pImage[addr] | (pImage[addr + 1] << 8);
+			if (!rStarts[value] && !rStarts[static_cast<uint16_t>(value + 1)]) {
+				break;
+			}
+		}
+		const uint32_t len = addr - aAddress;
+		return (len >= (TABLEMIN * 2)) ? len : 0;
+	}
+
+	//----------------------------------------------------------------
+	///Bytes from aStart up to aEnd are data if they are fill or can't be
+	/// decoded as code, either hitting a bad opcode or running into the
+	/// code after them
+	void Rest( uint32_t aStart, uint32_t aEnd )
+	{
+		if (aStart >= aEnd) {
+			return;
+		}
+
+		uint32_t same = 1;
+		for ( uint32_t addr = aStart + 1; (addr < aEnd) && (pImage[addr] == pImage[aStart]); ++addr) {
+			++same;
+		}
+		bool bdata = (same == (aEnd - aStart)) && (same >= FILLMIN);
+
+		uint32_t addr = aStart;
+		while (!bdata && (addr < aEnd)) {
+			const OpCode &rop = OpCode::Get(pImage[addr]);
+			bdata = rop == "BAD";
+			addr += std::max<uint32_t>(rop.QSize(), 1);
+		}
+		bdata = bdata || ((addr > aEnd) && (aEnd < IMAGESIZE) && (pTypes[aEnd] == TYPE::CODE));
+
+		if (bdata) {
+			std::fill(pTypes + aStart, pTypes + aEnd, TYPE::BYTES);
+		}
+	}
+};
+
+//----------------------------------------------------------------
+Map Classify( const uint8_t *apImage, const Flow::PageSet &arPages, const std::vector<Flow::Block> &arBlocks )
+{
+	auto ptypes = std::make_unique<TYPE[]>(IMAGESIZE);	//Too big for the stack
+	std::fill(ptypes.get(), ptypes.get() + IMAGESIZE, TYPE::UNKNOWN);
+	auto pstarts = std::make_unique<std::bitset<IMAGESIZE>>();
+	for ( const auto &rblock : arBlocks ) {
+		(*pstarts)[rblock.Start] = true;
+		std::fill(ptypes.get() + rblock.Start, ptypes.get() + std::min<uint32_t>(rblock.End, IMAGESIZE), TYPE::CODE);
+	}
+
+	//Without any code there is nothing to tell the data apart from
+	if (!arBlocks.empty()) {
+		Classifier classifier(apImage, ptypes.get(), *pstarts);
+		uint32_t addr = 0;
+		while (addr < IMAGESIZE) {
+			if ((ptypes[addr] == TYPE::CODE) || !arPages[addr >> 8]) {
+				++addr;
+				continue;
+			}
+			const uint32_t start = addr;
+			while ((addr < IMAGESIZE) && (ptypes[addr] != TYPE::CODE) && arPages[addr >> 8]) {
+				++addr;
+			}
+			classifier.Gap(start, addr - 1);
+		}
+	}
+
+	Map map;
+	map.Assign(ptypes.get());
+	return map;
+}
+
+}	//namespace Regions
@@ -0,0 +1,371 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Regions.cpp
+//----------------------------------------------------------------------
+
+
+#include "Regions.h"
+#include "Code.h"
+#include "Labels.h"
+#include "Shadow.h"
+
+#include <algorithm>
+#include <fstream>
+#include <imgui.h>
+#include <memory>
+
+namespace Regions
+{
+
+//Bytes per Code view line, indexed by TYPE
+constexpr uint32_t LineA[] = { 0, 0, 4, 2, LINEMAX };
+const char *NameA[] = { "Unknown", "Code", "Bytes", "Words", "Text" };
+
+static_assert(std::size(LineA) == static_cast<size_t>(TYPE::COUNT));
+static_assert(std::size(NameA) == static_cast<size_t>(TYPE::COUNT));
+
+Map Found;										//What the analysis found
+Map Marks;										//User's marks, UNKNOWN where there are none
+Map Merged;										//Marks over what was found
+std::filesystem::path Project;					//File the marks are saved in, empty if none
+uint32_t FlowStamp = 0xffffffff;				//Sources of Found
+uint32_t ShadowStamp = 0xffffffff;
+uint32_t Stamp = 0;								//Incremented when Merged changes
+uint32_t MarkStamp = 0;							//Incremented when Marks change
+uint16_t MarkStart = 0;							//Range entered in the window
+uint16_t MarkEnd = 0;
+int32_t MarkType = static_cast<int32_t>(TYPE::BYTES);
+bool MarksOnly = false;							//List only the user's marks
+bool Enabled = false;							//Window enabled
+
+//----------------------------------------------------------------
+const char *QName( TYPE aeType )
+{
+	return (aeType < TYPE::COUNT) ? NameA[static_cast<uint32_t>(aeType)] : "";
+}
+
+//----------------------------------------------------------------
+///Join the marks with what was found, moving the stamp on if that
+/// changed anything
+void Merge(  )
+{
+	Map merged = Found;
+	merged.Overlay(Marks);
+	if (!(merged == Merged)) {
+		Merged = std::move(merged);
+		++Stamp;
+	}
+}
+
+//----------------------------------------------------------------
+///Classify the memory again if Flow or the memory changed
+void Check(  )
+{
+	const uint32_t flow = Flow::QStamp();
+	const uint32_t shadow = Shadow::QStamp(0, 0xffff);
+	if ((flow != FlowStamp) || (shadow != ShadowStamp)) {
+		FlowStamp = flow;
+		ShadowStamp = shadow;
+
+		Flow::PageSet pages;
+		for ( uint32_t page = 0; page < Shadow::NUMPAGES; ++page) {
+			const uint32_t base = page * Shadow::PAGESIZE;
+			pages[page] = Shadow::QStamp(static_cast<uint16_t>(base), static_cast<uint16_t>(base + Shadow::PAGESIZE - 1)) != 0;
+		}
+		Found = Classify(Shadow::QImage(), pages, Flow::QBlocks());
+		Merge();
+	}
+}
+
+//----------------------------------------------------------------
+const Map &QMap(  )
+{
+	Check();
+	return Merged;
+}
+
+//----------------------------------------------------------------
+TYPE QType( uint16_t aAddress )
+{
+	return QMap().Get(aAddress);
+}
+
+//----------------------------------------------------------------
+Span QLine( uint16_t aAddress, uint32_t aCodeSize )
+{
+	const Map &rmap = QMap();
+	const Run run = rmap.QRun(aAddress);
+	if (!QData(run.Type)) {
+		//An instruction running into data is shown as bytes up to it
+		if (((aAddress + aCodeSize - 1) > run.End) && (run.End < 0xffff) && QData(rmap.Get(run.End + 1))) {
+			return { aAddress, run.End + 1u - aAddress, TYPE::BYTES };
+		}
+		return { aAddress, aCodeSize, run.Type };
+	}
+
+	//Lines are a fixed number of bytes from the start of the run, with
+	// a new line at each label
+	const uint32_t per = LineA[static_cast<uint32_t>(run.Type)];
+	uint32_t start = run.Start + (((aAddress - run.Start) / per) * per);
+	uint32_t end = std::min<uint32_t>(start + per, run.End + 1u);
+	for ( uint32_t addr = aAddress; addr > start; --addr) {
+		if (Labels::Find(static_cast<uint16_t>(addr))) {
+			start = addr;
+			break;
+		}
+	}
+	for ( uint32_t addr = aAddress + 1u; addr < end; ++addr) {
+		if (Labels::Find(static_cast<uint16_t>(addr))) {
+			end = addr;
+			break;
+		}
+	}
+	return { static_cast<uint16_t>(start), end - start, run.Type };
+}
+
+//----------------------------------------------------------------
+uint32_t QStamp(  )
+{
+	Check();
+	return Stamp;
+}
+
+//----------------------------------------------------------------
+///Get the marks as Json
+nlohmann::json MarksToJson(  )
+{
+	auto marks = nlohmann::json::array();
+	Marks.ForEach([&]( const Run &arRun ) {
+		if (arRun.Type != TYPE::UNKNOWN) {
+			marks.push_back({ {"Start", arRun.Start}, {"End", arRun.End}, {"Type", QName(arRun.Type)} });
+		}
+	});
+	return marks;
+}
+
+//----------------------------------------------------------------
+///Replace the marks with those in Json
+void MarksFromJson( const nlohmann::json &arMarks )
+{
+	Marks = Map();
+	if (arMarks.is_array()) {
+		for ( const auto &mark : arMarks ) {
+			const std::string name = mark.value("Type", "");
+			for ( uint32_t type = 0; type < static_cast<uint32_t>(TYPE::COUNT); ++type) {
+				if (name == NameA[type]) {
+					Marks.Set(mark.value("Start", 0_u16), mark.value("End", 0_u16), static_cast<TYPE>(type));
+				}
+			}
+		}
+	}
+	++MarkStamp;
+	Merge();
+}
+
+//----------------------------------------------------------------
+///Write the marks to the project's file
+void Save(  )
+{
+	if (!Project.empty()) {
+		std::ofstream strm(Project);
+		if (strm.good()) {
+			strm << nlohmann::json{ {"Marks", MarksToJson()} }.dump(2);
+		}
+	}
+}
+
+//----------------------------------------------------------------
+void Set( uint16_t aStart, uint16_t aEnd, TYPE aeType )
+{
+	Marks.Set(aStart, aEnd, aeType);
+	++MarkStamp;
+	Merge();
+	Save();
+}
+
+//----------------------------------------------------------------
+std::vector<uint16_t> QCodeMarks(  )
+{
+	std::vector<uint16_t> starts;
+	Marks.ForEach([&]( const Run &arRun ) {
+		if (arRun.Type == TYPE::CODE) {
+			starts.push_back(arRun.Start);
+		}
+	});
+	return starts;
+}
+
+//----------------------------------------------------------------
+uint32_t QMarkStamp(  )
+{
+	return MarkStamp;
+}
+
+//----------------------------------------------------------------
+void SetProject( std::filesystem::path aPath )
+{
+	aPath.replace_extension(".regions");
+	if (aPath == Project) {
+		return;
+	}
+
+	Project = aPath;
+	nlohmann::json marks;
+	if (std::ifstream strm(Project); strm.good()) {
+		marks = nlohmann::json::parse(strm, nullptr, false);
+	}
+	MarksFromJson(marks.is_object() ? marks["Marks"] : marks);
+}
+
+//----------------------------------------------------------------
+void ToJson( nlohmann::json &arData )
+{
+	//Marks of a project are in its own file
+	arData["Regions"] = {
+		{"On", Enabled},
+		{"Project", Project.string()},
+		{"Marks", Project.empty() ? MarksToJson() : nlohmann::json::array()}
+	};
+}
+
+//----------------------------------------------------------------
+void FromJson( nlohmann::json &arData )
+{
+	auto obj = arData["Regions"];
+	if (!obj.is_null()) {
+		Enabled = obj["On"];
+		if (const std::string project = obj.value("Project", ""); !project.empty()) {
+			SetProject(project);
+		}
+		else {
+			MarksFromJson(obj["Marks"]);
+		}
+	}
+}
+
+//----------------------------------------------------------------
+void DisplayOn(  )
+{
+	Enabled = true;
+}
+
+//----------------------------------------------------------------
+void Display(  )
+{
+	if (!Enabled) return;						//Early out if view not visible
+
+	ImGui::SetNextWindowSize(ImVec2(300, 320), ImGuiCond_FirstUseEver);
+	ImGui::Begin("Regions", &Enabled);
+
+	const float w = ImGui::GetFontSize();
+
+	//Range to mark
+	auto hex = []( const char *apID, uint16_t *apValue ) {
+		ImGui::InputScalar(apID, ImGuiDataType_U16, apValue, nullptr, nullptr, "%04x"
+			, ImGuiInputTextFlags_CharsHexadecimal | ImGuiInputTextFlags_AlwaysOverwrite);
+	};
+	ImGui::PushItemWidth(w * 3.0f);
+	hex("##Start", &MarkStart);
+	ImGui::SameLine(0.0f, 1.0f);
+	ImGui::TextUnformatted("-");
+	ImGui::SameLine(0.0f, 1.0f);
+	hex("##End", &MarkEnd);
+	ImGui::PopItemWidth();
+	ImGui::SameLine();
+	ImGui::PushItemWidth(w * 4.5f);
+	if (ImGui::BeginCombo("##Type", NameA[MarkType])) {
+		for ( int32_t i = static_cast<int32_t>(TYPE::CODE); i < static_cast<int32_t>(TYPE::COUNT); ++i) {
+			if (ImGui::Selectable(NameA[i], i == MarkType)) {
+				MarkType = i;
+			}
+		}
+		ImGui::EndCombo();
+	}
+	ImGui::PopItemWidth();
+	ImGui::SameLine();
+	if (ImGui::Button("Mark")) {
+		Set(MarkStart, MarkEnd, static_cast<TYPE>(MarkType));
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Unmark")) {
+		Set(MarkStart, MarkEnd, TYPE::UNKNOWN);
+	}
+
+	std::vector<Run> runs;
+	(MarksOnly ? Marks : QMap()).ForEach([&]( const Run &arRun ) {
+		if (!MarksOnly || (arRun.Type != TYPE::UNKNOWN)) {
+			runs.push_back(arRun);
+		}
+	});
+	ImGui::Checkbox("Marks only", &MarksOnly);
+	ImGui::SameLine();
+	ImGui::Text("%u runs", static_cast<uint32_t>(runs.size()));
+
+	if (ImGui::BeginTable("##Runs", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg
+		| ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable)) {
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("Start");
+		ImGui::TableSetupColumn("End");
+		ImGui::TableSetupColumn("Type");
+		ImGui::TableSetupColumn("Label");
+		ImGui::TableHeadersRow();
+
+		ImGuiListClipper clipper;
+		clipper.Begin(static_cast<int32_t>(runs.size()));
+		while (clipper.Step()) {
+			for ( int32_t i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+				const Run &rrun = runs[i];
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				char text[8];
+				snprintf(text, sizeof(text), "%04x", rrun.Start);
+				//Click shows the run in the Code view and picks it to mark
+				ImGui::PushID(i);
+				if (ImGui::Selectable(text, false, ImGuiSelectableFlags_SpanAllColumns)) {
+					Code::SetAddress(rrun.Start);
+					MarkStart = rrun.Start;
+					MarkEnd = rrun.End;
+				}
+				ImGui::PopID();
+				ImGui::TableNextColumn();
+				ImGui::Text("%04x", rrun.End);
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(QName(rrun.Type));
+				ImGui::TableNextColumn();
+				const char *plabel = Labels::Find(rrun.Start);
+				ImGui::TextUnformatted(plabel ? plabel : "");
+			}
+		}
+		ImGui::EndTable();
+	}
+
+	ImGui::End();
+}
+
+}	//namespace Regions
@@ -0,0 +1,210 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Regions.h
+//----------------------------------------------------------------------
+
+
+#pragma once
+
+#include "types.h"
+#include "Flow.h"
+#include "json/json.hpp"
+
+#include <filesystem>
+#include <vector>
+
+///Which bytes of the computer's memory are code and which are data.
+/// Flow's blocks are code, the gaps between them are classified as text,
+/// word tables or bytes by a few heuristics, and the user can mark any
+/// range over that. Types are kept as runs, so a lookup is a binary
+/// search over the run starts. The Code view shows data as .byte, .word
+/// and .text lines and source exports follow the same map.
+/// User marks are saved in a .regions file next to the program or
+/// labels loaded, or in the settings when neither has been.
+namespace Regions
+{
+
+constexpr uint32_t LINEMAX = 12;				//Most bytes in a Code view line
+
+//----------------------------------------------------------------
+enum class TYPE : uint8_t
+{
+	UNKNOWN,									//Shown as code
+	CODE,
+	BYTES,
+	WORDS,										//Little endian addresses
+	TEXT,										//PETSCII
+	COUNT
+};
+
+//----------------------------------------------------------------
+///Return true for types shown as data rather than instructions
+constexpr bool QData( TYPE aeType ) { return (aeType >= TYPE::BYTES) && (aeType < TYPE::COUNT); }
+
+//----------------------------------------------------------------
+///Get display name of a type
+const char *QName( TYPE aeType );
+
+//----------------------------------------------------------------
+///Bytes Start to End inclusive of one type
+struct Run
+{
+	uint16_t Start;
+	uint16_t End;
+	TYPE Type;
+};
+
+//----------------------------------------------------------------
+///Line of the Code view. Data lines start where their run does, every
+/// few bytes after and at labels. Code lines are an instruction, cut
+/// short as bytes if it would run into data
+struct Span
+{
+	uint16_t Start;								//First byte of the line
+	uint32_t Length;							//Bytes in the line
+	TYPE Type;
+};
+
+//----------------------------------------------------------------
+///Run length map of types over 64K
+class Map
+{
+public:
+	//----------------------------------------------------------------
+	///Everything unknown
+	Map(  ) : Entries{ { 0, TYPE::UNKNOWN } } { }
+
+	//----------------------------------------------------------------
+	///Get type of an address
+	TYPE Get( uint16_t aAddress ) const { return Find(aAddress)->Type; }
+
+	//----------------------------------------------------------------
+	///Get run holding an address
+	Run QRun( uint16_t aAddress ) const;
+
+	//----------------------------------------------------------------
+	///Set type of a range, joining runs of the same type
+	void Set( uint16_t aStart, uint16_t aEnd, TYPE aeType );
+
+	//----------------------------------------------------------------
+	///Replace the map with runs of a type per byte
+	void Assign( const TYPE *apTypes );
+
+	//----------------------------------------------------------------
+	///Set every run of arTop that isn't UNKNOWN over this
+	void Overlay( const Map &arTop );
+
+	//----------------------------------------------------------------
+	///Number of runs
+	size_t QSize(  ) const { return Entries.size(); }
+
+	//----------------------------------------------------------------
+	///Call the function with each run in address order
+	template<class FN> void ForEach( FN aFunction ) const
+	{
+		for ( size_t i = 0; i < Entries.size(); ++i) {
+			const uint32_t end = ((i + 1) < Entries.size()) ? Entries[i + 1].Start - 1u : 0xffffu;
+			aFunction(Run{ Entries[i].Start, static_cast<uint16_t>(end), Entries[i].Type });
+		}
+	}
+
+	//----------------------------------------------------------------
+	bool operator==( const Map &arOther ) const = default;
+
+private:
+	//----------------------------------------------------------------
+	///Start of a run, which goes on to the next start
+	struct Entry
+	{
+		uint16_t Start;
+		TYPE Type;
+
+		bool operator==( const Entry &arOther ) const = default;
+	};
+
+	std::vector<Entry> Entries;					//Sorted by Start, the first at 0
+
+	//----------------------------------------------------------------
+	///Get entry for the run holding an address
+	std::vector<Entry>::const_iterator Find( uint16_t aAddress ) const;
+};
+
+//----------------------------------------------------------------
+///Classify an image from the blocks Flow found in it. Only pages in
+/// arPages are read, the rest is unknown. May run on any thread
+Map Classify( const uint8_t *apImage, const Flow::PageSet &arPages, const std::vector<Flow::Block> &arBlocks );
+
+//----------------------------------------------------------------
+///Get map of the computer's memory with the user's marks applied,
+/// reclassified if Flow or the memory changed
+const Map &QMap(  );
+
+//----------------------------------------------------------------
+///Get type of an address in the computer's memory
+TYPE QType( uint16_t aAddress );
+
+//----------------------------------------------------------------
+///Get the Code view line holding an address given the size of the
+/// instruction there
+Span QLine( uint16_t aAddress, uint32_t aCodeSize );
+
+//----------------------------------------------------------------
+///Return a stamp that changes whenever the map does
+uint32_t QStamp(  );
+
+//----------------------------------------------------------------
+///Mark a range as a type. UNKNOWN removes marks, leaving what the
+/// analysis found
+void Set( uint16_t aStart, uint16_t aEnd, TYPE aeType );
+
+//----------------------------------------------------------------
+///Get starts of ranges the user marked as code, for Flow to walk
+std::vector<uint16_t> QCodeMarks(  );
+
+//----------------------------------------------------------------
+///Return a stamp that changes whenever the user's marks do
+uint32_t QMarkStamp(  );
+
+//----------------------------------------------------------------
+///Switch to the marks saved for a program or labels file
+void SetProject( std::filesystem::path aPath );
+
+///Save data to Json
+void ToJson( nlohmann::json &arData );
+
+///Load data from Json
+void FromJson( nlohmann::json &arData );
+
+///Enable window
+void DisplayOn(  );
+
+///Draw window
+void Display(  );
+
+}	//namespace Regions
@@ -202,6 +202,18 @@ void FromResponse( const Response &arResponse )
 	Code::NewIP(RegValueA[REGID::IP]);
 }
 
+//----------------------------------------------------------------
+CPU QCPU(  )
+{
+	return {
+		RegValueA[REGID::IP],
+		static_cast<uint8_t>(RegValueA[REGID::AR]),
+		static_cast<uint8_t>(RegValueA[REGID::XR]),
+		static_cast<uint8_t>(RegValueA[REGID::YR]),
+		static_cast<uint8_t>(RegValueA[REGID::SP])
+	};
+}
+
 //----------------------------------------------------------------
 void Display( bool abInputEnabled )
 {
@@ -39,6 +39,21 @@ namespace Registers
 	///Set register values from the response
 	void FromResponse( const Response &arResponse );
 
+	//----------------------------------------------------------------
+	///CPU registers that decide where an instruction reads and writes
+	struct CPU
+	{
+		uint16_t IP;
+		uint8_t AR;
+		uint8_t XR;
+		uint8_t YR;
+		uint8_t SP;
+	};
+
+	//----------------------------------------------------------------
+	///Get register values from the last response
+	CPU QCPU(  );
+
 	//----------------------------------------------------------------
 	///Display register window
 	void Display( bool abEnabled );
@@ -0,0 +1,146 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Scanner.cpp
+//----------------------------------------------------------------------
+
+#include "Scanner.h"
+#include "Simd.h"
+
+#include <bit>
+#include <string.h>
+
+namespace Scanner
+{
+
+const char *FilterNames[] =
+{
+	"Equals",
+	"Changed",
+	"Unchanged",
+	"Increased",
+	"Decreased"
+};
+
+//----------------------------------------------------------------
+const char *FilterName( FILTER aFilter )
+{
+	return aFilter < FILTER::COUNT ? FilterNames[static_cast<uint32_t>(aFilter)] : "";
+}
+
+//----------------------------------------------------------------
+void Scan::Reset(  )
+{
+	for ( auto &row : Rows ) {
+		row = 0xffff;
+	}
+	Count = ADDRESSES;
+	Started = false;
+}
+
+//----------------------------------------------------------------
+bool Scan::QPageHasCandidates( uint32_t aPage ) const
+{
+	const uint16_t *prow = &Rows[aPage * ROWSPERPAGE];
+	for ( uint32_t i = 0; i < ROWSPERPAGE; ++i) {
+		if (prow[i]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+//----------------------------------------------------------------
+void Scan::Snapshot( const uint8_t *apImage )
+{
+	memcpy_s(Prev, sizeof(Prev), apImage, ADDRESSES);
+	Started = true;
+}
+
+//----------------------------------------------------------------
+uint32_t Scan::Filter( FILTER aFilter, const uint8_t *apImage, uint8_t aValue )
+{
+	uint32_t count = 0;
+	for ( uint32_t row = 0; row < NUMROWS; ++row) {
+		uint32_t candidates = Rows[row];
+		if (!candidates) continue;				//Most rows are empty after a few passes
+
+		const uint8_t *pcur = &apImage[row * ROWSIZE];
+		uint8_t *pprev = &Prev[row * ROWSIZE];
+		uint32_t pass = 0;
+		switch (aFilter) {
+			case FILTER::EQUALS:
+				pass = Simd::ValueMask(pcur, aValue);
+				break;
+			case FILTER::CHANGED:
+				pass = ~Simd::EqualMask(pcur, pprev);
+				break;
+			case FILTER::UNCHANGED:
+				pass = Simd::EqualMask(pcur, pprev);
+				break;
+			case FILTER::INCREASED:
+				pass = Simd::GreaterMask(pcur, pprev);
+				break;
+			case FILTER::DECREASED:
+				pass = Simd::GreaterMask(pprev, pcur);
+				break;
+			default:
+				break;
+		}
+
+		candidates &= pass;
+		Rows[row] = static_cast<uint16_t>(candidates);
+		count += std::popcount(candidates);
+		memcpy_s(pprev, ROWSIZE, pcur, ROWSIZE);	//Next filter compares against this snapshot
+	}
+
+	Count = count;
+	Started = true;
+	return count;
+}
+
+//----------------------------------------------------------------
+uint32_t Scan::Get( uint32_t aStart, uint16_t *apResults, uint32_t aMax ) const
+{
+	uint32_t num = 0;
+	for ( uint32_t row = aStart / ROWSIZE; (row < NUMROWS) && (num < aMax); ++row) {
+		//Ignore candidates before aStart in the first row
+		uint32_t candidates = Rows[row];
+		if (row == aStart / ROWSIZE) {
+			candidates &= ~(bit(aStart % ROWSIZE) - 1);
+		}
+
+		while (candidates && (num < aMax)) {
+			apResults[num++] = static_cast<uint16_t>(row * ROWSIZE + Simd::LowBit(candidates));
+			candidates &= candidates - 1;		//Clear lowest bit
+		}
+	}
+	return num;
+}
+
+}	//namespace Scanner
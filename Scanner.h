@@ -0,0 +1,112 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Scanner.h
+//----------------------------------------------------------------------
+
+#pragma once
+
+#include "types.h"
+
+///Value scanner used to find where a program keeps a variable.
+/// Start with every address as a candidate, then after each snapshot
+/// keep only addresses whose value passes the chosen filter.
+namespace Scanner
+{
+
+constexpr uint32_t ADDRESSES = 0x10000;
+constexpr uint32_t ROWSIZE = 0x10;				//Addresses per candidate row
+constexpr uint32_t NUMROWS = ADDRESSES / ROWSIZE;
+constexpr uint32_t ROWSPERPAGE = 0x100 / ROWSIZE;
+
+enum class FILTER
+{
+	EQUALS,										//Value equals given value
+	CHANGED,									//Value differs from last snapshot
+	UNCHANGED,									//Value same as last snapshot
+	INCREASED,									//Value greater than last snapshot
+	DECREASED,									//Value less than last snapshot
+	COUNT
+};
+
+//----------------------------------------------------------------
+///Get name of the filter
+const char *FilterName( FILTER aFilter );
+
+//----------------------------------------------------------------
+///Candidate set and last snapshot of memory
+class Scan
+{
+public:
+	//----------------------------------------------------------------
+	///Constructor, starts with every address a candidate
+	Scan(  ) { Reset(); }
+
+	//----------------------------------------------------------------
+	///Make every address a candidate again
+	void Reset(  );
+
+	//----------------------------------------------------------------
+	///Return true if a snapshot has been taken
+	bool QStarted(  ) const { return Started; }
+
+	//----------------------------------------------------------------
+	///Get number of remaining candidates
+	uint32_t QCount(  ) const { return Count; }
+
+	//----------------------------------------------------------------
+	///Return true if given 256 byte page holds any candidates
+	bool QPageHasCandidates( uint32_t aPage ) const;
+
+	//----------------------------------------------------------------
+	///Get value of address at the last snapshot
+	uint8_t QValue( uint16_t aAddress ) const { return Prev[aAddress]; }
+
+	//----------------------------------------------------------------
+	///Take first snapshot from the 64K image. Candidates are unchanged
+	void Snapshot( const uint8_t *apImage );
+
+	//----------------------------------------------------------------
+	///Remove candidates that fail the filter against the 64K image,
+	/// then snapshot the candidate rows. aValue is used by EQUALS.
+	/// Returns remaining candidate count
+	uint32_t Filter( FILTER aFilter, const uint8_t *apImage, uint8_t aValue = 0 );
+
+	//----------------------------------------------------------------
+	///Fill apResults with up to aMax candidates starting at aStart and
+	/// return number written
+	uint32_t Get( uint32_t aStart, uint16_t *apResults, uint32_t aMax ) const;
+
+private:
+	uint8_t Prev[ADDRESSES];					//Value of each address at last snapshot
+	uint16_t Rows[NUMROWS];						//Candidate bits, 1 per address in each 16 byte row
+	uint32_t Count = 0;							//Number of candidates
+	bool Started = false;						//Snapshot taken
+};
+
+}	//namespace Scanner
@@ -0,0 +1,248 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    ScannerView.cpp
+//----------------------------------------------------------------------
+
+#include "ScannerView.h"
+#include "ImGuiUtils.h"
+#include "Labels.h"
+#include "Memory.h"
+#include "Monitor.h"
+#include "Numbers.h"
+#include "Scanner.h"
+#include "Shadow.h"
+
+#include <cstdlib>
+#include <imgui.h>
+#include <memory>
+
+namespace ScannerView
+{
+
+constexpr uint32_t MAXSHOWN = 0x100;			//Maximum candidates listed
+
+enum class STEP
+{
+	NONE,
+	SNAPSHOT,									//Waiting for pages to take first snapshot
+	FILTER										//Waiting for pages to filter
+};
+
+bool Enabled = false;							//Window enabled
+STEP Pending = STEP::NONE;						//Step waiting on memory
+int32_t Filter = 0;								//Scanner::FILTER as int for combo box
+char ValueText[8] = "00";						//Value for equals filter
+uint16_t Shown[MAXSHOWN];						//Candidates displayed
+uint32_t NumShown = 0;
+Banks::Space Space = Banks::MAIN;				//Memspace and bank scanned
+std::unique_ptr<Scanner::Scan> pScan;			//Allocated on first use, it's large
+
+//----------------------------------------------------------------
+///Range of given page
+inline uint16_t PageStart( uint32_t aPage ) { return static_cast<uint16_t>(aPage * Shadow::PAGESIZE); }
+inline uint16_t PageEnd( uint32_t aPage ) { return static_cast<uint16_t>(PageStart(aPage) + Shadow::PAGESIZE - 1); }
+
+//----------------------------------------------------------------
+///Request pages holding candidates. If running the copies we have
+/// are stale so they are invalidated first
+void FetchCandidates(  )
+{
+	const bool stale = Monitor::ViceState() != VICESTATE::STOPPED;
+	for ( uint32_t page = 0; page < Shadow::NUMPAGES; ++page) {
+		if (pScan->QPageHasCandidates(page)) {
+			if (stale) {
+				Shadow::Invalidate(PageStart(page), PageEnd(page), Space);
+			}
+			Shadow::Fetch(PageStart(page), PageEnd(page), Space);
+		}
+	}
+}
+
+//----------------------------------------------------------------
+///Return number of candidate pages still waiting on data
+uint32_t QWaitingPages(  )
+{
+	uint32_t waiting = 0;
+	for ( uint32_t page = 0; page < Shadow::NUMPAGES; ++page) {
+		if (pScan->QPageHasCandidates(page) && !Shadow::QValid(PageStart(page), PageEnd(page), Space)) {
+			++waiting;
+		}
+	}
+	return waiting;
+}
+
+//----------------------------------------------------------------
+///Start a step, the step runs once the memory arrives
+void Start( STEP aStep )
+{
+	if (!pScan) {
+		pScan = std::make_unique<Scanner::Scan>();
+	}
+	if (aStep == STEP::SNAPSHOT) {
+		pScan->Reset();
+		NumShown = 0;
+	}
+	Pending = aStep;
+	FetchCandidates();
+}
+
+//----------------------------------------------------------------
+///Run pending step if all the memory it needs is here
+void Update(  )
+{
+	if ((Pending != STEP::NONE) && !QWaitingPages()) {
+		const uint8_t *pimage = Shadow::QImage(Space);
+		if (Pending == STEP::SNAPSHOT) {
+			pScan->Snapshot(pimage);
+		}
+		else {
+			//Input may be 1 digit, so don't read a fixed 2
+			auto value = static_cast<uint8_t>(strtoul(ValueText, nullptr, 16));
+			pScan->Filter(static_cast<Scanner::FILTER>(Filter), pimage, value);
+		}
+		NumShown = pScan->Get(0, Shown, MAXSHOWN);
+		Pending = STEP::NONE;
+	}
+}
+
+//----------------------------------------------------------------
+void ToJson( nlohmann::json &arData )
+{
+	arData["Scanner"] = {
+		{"On", Enabled},
+		{"Filter", Filter},
+		{"Space", Space}
+	};
+}
+
+//----------------------------------------------------------------
+void FromJson( nlohmann::json &arData )
+{
+	auto obj = arData["Scanner"];
+	if (!obj.is_null()) {
+		Enabled = obj["On"];
+		Filter = obj["Filter"];
+		if (obj["Space"].is_number()) {
+			Space = obj["Space"];
+		}
+	}
+}
+
+//----------------------------------------------------------------
+void DisplayOn(  )
+{
+	Enabled = true;
+}
+
+//----------------------------------------------------------------
+void Display(  )
+{
+	if (!Enabled) return;						//Early out if view not visible
+
+	Update();
+
+	ImGui::SetNextWindowSize(ImVec2(260, 400), ImGuiCond_FirstUseEver);
+	ImGui::Begin("Scanner", &Enabled);
+
+	const float w = ImGui::GetFontSize();
+	const bool started = pScan && pScan->QStarted();
+
+	if (ImGui::Button("New")) {
+		Start(STEP::SNAPSHOT);
+	}
+	ImGui::SameLine();
+	ImGui::PushItemWidth(w * 6.0f);
+	if (ImGui::BeginCombo("##Filter", Scanner::FilterName(static_cast<Scanner::FILTER>(Filter)))) {
+		for ( int32_t i = 0; i < static_cast<int32_t>(Scanner::FILTER::COUNT); ++i) {
+			if (ImGui::Selectable(Scanner::FilterName(static_cast<Scanner::FILTER>(i)), i == Filter)) {
+				Filter = i;
+			}
+		}
+		ImGui::EndCombo();
+	}
+	ImGui::PopItemWidth();
+	//Only equals can be used without a previous snapshot
+	const bool canFilter = started || (Filter == static_cast<int32_t>(Scanner::FILTER::EQUALS));
+	if (Filter == static_cast<int32_t>(Scanner::FILTER::EQUALS)) {
+		ImGui::SameLine();
+		ImGui::PushItemWidth(w * 2.0f);
+		ImGui::InputText("##Value", ValueText, 3, ImGuiInputTextFlags_CharsHexadecimal);
+		ImGui::PopItemWidth();
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Next") && canFilter) {
+		Start(STEP::FILTER);
+	}
+
+	//Candidates are only meaningful in the space they were found in,
+	// so changing it starts over
+	if (Banks::Combo("##Space", Space) && pScan) {
+		pScan->Reset();
+		NumShown = 0;
+		Pending = STEP::NONE;
+	}
+	ImGui::SameLine();
+	if (Pending != STEP::NONE) {
+		ImGui::Text("Fetching %u pages", QWaitingPages());
+	}
+	else if (pScan) {
+		ImGui::Text("%u candidates", pScan->QCount());
+	}
+
+	//List candidates, click to show in Memory view 0, Ctrl+click for view 1
+	if (ImGui::BeginListBox("##Candidates", ImVec2(-FLT_MIN, -FLT_MIN))) {
+		const uint8_t *pimage = Shadow::QImage(Space);
+		char line[16];
+		for ( uint32_t i = 0; i < NumShown; ++i) {
+			uint16_t addr = Shown[i];
+			line[0] = '$';
+			Numbers::ToHex(&line[1], addr);
+			line[5] = ' ';
+			Numbers::ToHex(&line[6], pScan->QValue(addr));
+			line[8] = ' ';
+			Numbers::ToHex(&line[9], pimage[addr]);
+			line[11] = 0;
+
+			ImGui::PushID(static_cast<int32_t>(i));
+			if (ImGui::Selectable(line)) {
+				Memory::SetAddress(CtrlDown() ? 1 : 0, addr, Space);
+			}
+			ImGui::PopID();
+			if (const char *plabel = Labels::Find(addr); plabel) {
+				ImGui::SameLine();
+				ImGui::Text(plabel);
+			}
+		}
+		ImGui::EndListBox();
+	}
+
+	ImGui::End();
+}
+
+}	//namespace ScannerView
@@ -0,0 +1,248 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Search.cpp
+//----------------------------------------------------------------------
+
+#include "Search.h"
+#include "6502.h"								//For Upper() and IsHex()
+#include "Numbers.h"
+#include "Simd.h"
+
+namespace Search
+{
+
+//----------------------------------------------------------------
+const char *ModeNameA[] =
+{
+	"Bytes",
+	"Word",
+	"PETSCII",
+	"Screen"
+};
+
+//----------------------------------------------------------------
+const char *ModeName( MODE aeMode )
+{
+	return ModeNameA[static_cast<uint32_t>(aeMode)];
+}
+
+//----------------------------------------------------------------
+uint8_t ToPetscii( char aChar )
+{
+	//Letters are in the 0x41-0x5A range, everything else from 0x20-0x5F is ascii
+	auto c = static_cast<uint8_t>(Upper(aChar));
+	return ((c >= 0x20) && (c < 0x60)) ? c : 0x3F;	//Unknown chars become '?'
+}
+
+//----------------------------------------------------------------
+uint8_t ToScreenCode( char aChar )
+{
+	//Screen codes move PETSCII 0x40-0x5F down to 0x00-0x1F
+	auto c = ToPetscii(aChar);
+	return (c >= 0x40) ? c - 0x40 : c;
+}
+
+//----------------------------------------------------------------
+///Parse a hex digit or '?' wildcard into arValue/arMask nibble
+bool ParseNibble( char aChar, uint8_t &arValue, uint8_t &arMask )
+{
+	arValue <<= 4;
+	arMask <<= 4;
+	if (IsHex(aChar)) {
+		arValue |= static_cast<uint8_t>(Numbers::ToNum(aChar));
+		arMask |= 0x0f;
+	}
+	else if (aChar != '?') {
+		return false;
+	}
+	return true;
+}
+
+//----------------------------------------------------------------
+///Skip spaces and return pointer to next char
+const char *SkipSpaces( const char *apSource )
+{
+	while (*apSource == ' ') {
+		++apSource;
+	}
+	return apSource;
+}
+
+//----------------------------------------------------------------
+bool Pattern::Parse( const char *apSource, MODE aeMode, bool abIgnoreCase )
+{
+	Len = 0;
+
+	//Add a byte to the pattern
+	auto add = [this]( uint8_t aValue, uint8_t aMask ) {
+		if (Len < MAXPATTERN) {
+			Masks[Len] = aMask;
+			Values[Len++] = aValue & aMask;
+			return true;
+		}
+		return false;
+	};
+
+	switch (aeMode) {
+		case MODE::BYTES:
+			//Pairs of nibbles with optional /mask
+			for ( const char *p = SkipSpaces(apSource); *p; p = SkipSpaces(p)) {
+				uint8_t value = 0, mask = 0;
+				if (!ParseNibble(p[0], value, mask) || !ParseNibble(p[1], value, mask)) {
+					return false;
+				}
+				p += 2;
+				if (*p == '/') {
+					if (!IsHex(p[1]) || !IsHex(p[2])) {
+						return false;
+					}
+					mask &= Numbers::HexToUInt8(p + 1);
+					p += 3;
+				}
+				if (!add(value, mask)) {
+					return false;
+				}
+			}
+			break;
+		case MODE::WORD:
+			//Space separated words of up to 4 nibbles with optional $
+			for ( const char *p = SkipSpaces(apSource); *p; p = SkipSpaces(p)) {
+				if (*p == '$') {
+					++p;
+				}
+				uint16_t value = 0, mask = 0;
+				uint32_t digits = 0;
+				for ( ; *p && (*p != ' '); ++p, ++digits) {
+					uint8_t v = 0, m = 0;
+					if ((digits == 4) || !ParseNibble(*p, v, m)) {
+						return false;
+					}
+					value = static_cast<uint16_t>((value << 4) | v);
+					mask = static_cast<uint16_t>((mask << 4) | m);
+				}
+				//Leading digits not given are 0
+				mask |= static_cast<uint16_t>(0xffff << (digits * 4));
+				if (!digits
+					|| !add(static_cast<uint8_t>(value), static_cast<uint8_t>(mask))
+					|| !add(static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(mask >> 8))) {
+					return false;
+				}
+			}
+			break;
+		case MODE::PETSCII:
+		case MODE::SCREEN:
+		{
+			const bool petscii = aeMode == MODE::PETSCII;
+			for ( const char *p = apSource; *p; ++p) {
+				uint8_t value = petscii ? ToPetscii(*p) : ToScreenCode(*p);
+				uint8_t mask = 0xff;
+				//Upper/lower case letters differ by bit 7 in PETSCII and bit 6 in screen codes
+				if (abIgnoreCase && (Upper(*p) >= 'A') && (Upper(*p) <= 'Z')) {
+					mask = petscii ? 0x7f : 0xbf;
+				}
+				if (!add(value, mask)) {
+					return false;
+				}
+			}
+			break;
+		}
+		default:
+			return false;
+	}
+
+	return Len != 0;
+}
+
+//----------------------------------------------------------------
+bool Pattern::Matches( const uint8_t *apData ) const
+{
+	for ( uint32_t i = 0; i < Len; ++i) {
+		if ((apData[i] & Masks[i]) != Values[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------------
+uint32_t Find( const Pattern &arPattern, const uint8_t *apData, uint32_t aSize,
+	uint16_t *apResults, uint32_t aMaxResults )
+{
+	uint32_t found = 0;
+	if (!arPattern.Len || (arPattern.Len > aSize)) {
+		return found;
+	}
+
+	const uint32_t last = aSize - arPattern.Len;	//Last offset a match may start at
+
+	//Use the first fully specified byte as the filter, or failing that
+	// the first byte with any bits specified
+	uint32_t anchor = 0;
+	for ( uint32_t i = 0; i < arPattern.Len; ++i) {
+		if (arPattern.Masks[i] == 0xff) {
+			anchor = i;
+			break;
+		}
+		if (arPattern.Masks[i] && !arPattern.Masks[anchor]) {
+			anchor = i;
+		}
+	}
+
+	//Compare 16 positions at a time against the anchor byte, then verify the
+	// whole pattern at each position that passed the filter
+	const auto value = _mm_set1_epi8(static_cast<char>(arPattern.Values[anchor]));
+	const auto mask = _mm_set1_epi8(static_cast<char>(arPattern.Masks[anchor]));
+	const uint8_t *panchor = apData + anchor;
+
+	uint32_t pos = 0;
+	for ( ; (pos + Simd::LANES <= last + 1) && (found < aMaxResults); pos += Simd::LANES) {
+		auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(panchor + pos));
+		auto hits = static_cast<uint32_t>(_mm_movemask_epi8(
+			_mm_cmpeq_epi8(_mm_and_si128(v, mask), value)));
+
+		while (hits && (found < aMaxResults)) {
+			uint32_t offset = pos + Simd::LowBit(hits);
+			if (arPattern.Matches(apData + offset)) {
+				apResults[found++] = static_cast<uint16_t>(offset);
+			}
+			hits &= hits - 1;					//Clear lowest bit
+		}
+	}
+
+	//Check remaining positions one at a time
+	for ( ; (pos <= last) && (found < aMaxResults); ++pos) {
+		if (arPattern.Matches(apData + pos)) {
+			apResults[found++] = static_cast<uint16_t>(pos);
+		}
+	}
+
+	return found;
+}
+
+}	//namespace Search
@@ -0,0 +1,97 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Search.h
+//----------------------------------------------------------------------
+
+#pragma once
+
+#include "types.h"
+
+///Pattern search over a block of c64 memory.
+/// Patterns are parsed from a string in one of several modes:
+///  BYTES   - "A9 ?? 8D 20 D0", '?' is a nibble wildcard and "xx/mm"
+///            applies mask mm to the byte. ie: "80/80" matches bit 7 set
+///  WORD    - "D020 ?400" 16 bit values stored little endian
+///  PETSCII - Text converted to PETSCII
+///  SCREEN  - Text converted to screen codes
+namespace Search
+{
+
+constexpr uint32_t MAXPATTERN = 0x40;			//Maximum pattern length in bytes
+
+//----------------------------------------------------------------
+enum class MODE : uint8_t
+{
+	BYTES,
+	WORD,
+	PETSCII,
+	SCREEN,
+	COUNT
+};
+
+//----------------------------------------------------------------
+///Byte values and masks to compare against memory
+/// memory matches when (memory & Masks[i]) == Values[i]
+struct Pattern
+{
+	uint8_t Values[MAXPATTERN];
+	uint8_t Masks[MAXPATTERN];
+	uint32_t Len = 0;
+
+	//----------------------------------------------------------------
+	///Parse string in given mode into the pattern. Return false on error
+	/// abIgnoreCase is only used by the text modes
+	bool Parse( const char *apSource, MODE aeMode, bool abIgnoreCase = false );
+
+	//----------------------------------------------------------------
+	///Return true if the pattern matches the memory at apData
+	/// apData must have at least Len bytes
+	bool Matches( const uint8_t *apData ) const;
+};
+
+//----------------------------------------------------------------
+///Get display name for the given mode
+const char *ModeName( MODE aeMode );
+
+//----------------------------------------------------------------
+///Convert ascii char to PETSCII
+uint8_t ToPetscii( char aChar );
+
+//----------------------------------------------------------------
+///Convert ascii char to a screen code
+uint8_t ToScreenCode( char aChar );
+
+//----------------------------------------------------------------
+///Find all matches of arPattern in apData of size aSize. Offsets
+/// of matches are written to apResults up to aMaxResults.
+/// Returns the number of results written
+uint32_t Find( const Pattern &arPattern, const uint8_t *apData, uint32_t aSize,
+	uint16_t *apResults, uint32_t aMaxResults );
+
+}	//namespace Search
@@ -0,0 +1,202 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    SearchView.cpp
+//----------------------------------------------------------------------
+
+#include "SearchView.h"
+#include "ImGuiUtils.h"
+#include "Labels.h"
+#include "Memory.h"
+#include "Monitor.h"
+#include "Numbers.h"
+#include "Search.h"
+#include "Shadow.h"
+
+#include <chrono>
+#include <imgui.h>
+
+namespace SearchView
+{
+
+constexpr uint32_t MAXRESULTS = 0x400;
+constexpr uint32_t PREVIEWBYTES = 8;			//Bytes shown after each result address
+
+bool Enabled = false;							//Window enabled
+bool Pending = false;							//Waiting for shadow image to search
+bool IgnoreCase = true;							//Text searches ignore case
+int32_t Mode = 0;								//Search::MODE as int for combo box
+char Text[64] = "";								//Pattern text
+char Status[64] = "";							//Result or error string
+Search::Pattern ThePattern;
+uint16_t Results[MAXRESULTS];
+uint32_t NumResults = 0;
+Banks::Space Space = Banks::MAIN;				//Memspace and bank to search
+Banks::Space ResultSpace = Banks::MAIN;			//Memspace and bank Results are in
+
+//----------------------------------------------------------------
+///Run the search over the shadow image
+void RunSearch(  )
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	NumResults = Search::Find(ThePattern, Shadow::QImage(ResultSpace), Shadow::IMAGESIZE, Results, MAXRESULTS);
+	auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::high_resolution_clock::now() - start).count();
+	snprintf(Status, sizeof(Status), "%u%s found in %lldus", NumResults,
+		NumResults == MAXRESULTS ? "+" : "", static_cast<long long>(us));
+	Pending = false;
+}
+
+//----------------------------------------------------------------
+///Parse the pattern and start a search, fetching memory if needed
+void StartSearch(  )
+{
+	NumResults = 0;
+	if (ThePattern.Parse(Text, static_cast<Search::MODE>(Mode), IgnoreCase)) {
+		Pending = true;
+		ResultSpace = Space;
+		//While running memory is changing, so take a fresh copy
+		if (Monitor::ViceState() != VICESTATE::STOPPED) {
+			Shadow::Invalidate(0, 0xffff, ResultSpace);
+		}
+		Shadow::Fetch(0, 0xffff, ResultSpace);	//Make sure we have all of memory
+	}
+	else {
+		Pending = false;
+		snprintf(Status, sizeof(Status), "Bad pattern");
+	}
+}
+
+//----------------------------------------------------------------
+void ToJson( nlohmann::json &arData )
+{
+	arData["Search"] = {
+		{"On", Enabled},
+		{"Mode", Mode},
+		{"Space", Space},
+		{"IgnoreCase", IgnoreCase}
+	};
+}
+
+//----------------------------------------------------------------
+void FromJson( nlohmann::json &arData )
+{
+	auto obj = arData["Search"];
+	if (!obj.is_null()) {
+		Enabled = obj["On"];
+		Mode = obj["Mode"];
+		IgnoreCase = obj["IgnoreCase"];
+		if (obj["Space"].is_number()) {
+			Space = obj["Space"];
+		}
+	}
+}
+
+//----------------------------------------------------------------
+void DisplayOn(  )
+{
+	Enabled = true;
+}
+
+//----------------------------------------------------------------
+void Display(  )
+{
+	if (!Enabled) return;						//Early out if view not visible
+
+	//Once the whole image is cached, do the search
+	if (Pending) {
+		if (auto pages = Shadow::QValidPages(ResultSpace); pages == Shadow::NUMPAGES) {
+			RunSearch();
+		}
+		else {
+			snprintf(Status, sizeof(Status), "Fetching %u/%u", pages, Shadow::NUMPAGES);
+		}
+	}
+
+	ImGui::SetNextWindowSize(ImVec2(300, 400), ImGuiCond_FirstUseEver);
+	ImGui::Begin("Search", &Enabled);
+
+	const float w = ImGui::GetFontSize();
+
+	ImGui::PushItemWidth(w * 6.0f);
+	if (ImGui::BeginCombo("##Mode", Search::ModeName(static_cast<Search::MODE>(Mode)))) {
+		for ( int32_t i = 0; i < static_cast<int32_t>(Search::MODE::COUNT); ++i) {
+			if (ImGui::Selectable(Search::ModeName(static_cast<Search::MODE>(i)), i == Mode)) {
+				Mode = i;
+			}
+		}
+		ImGui::EndCombo();
+	}
+	ImGui::PopItemWidth();
+	ImGui::SameLine();
+	ImGui::Checkbox("Ignore Case", &IgnoreCase);
+	ImGui::SameLine();
+	Banks::Combo("##Space", Space);
+
+	ImGui::PushItemWidth(w * 14.0f);
+	bool find = ImGui::InputText("##Pattern", Text, sizeof(Text), ImGuiInputTextFlags_EnterReturnsTrue);
+	ImGui::PopItemWidth();
+	if (ImGui::IsItemHovered()) {
+		ImGui::SetTooltip("Bytes: A9 ?? 8D 2? D0 80/80\nWord: D020 ?400\nText: HELLO");
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Find") || find) {
+		StartSearch();
+	}
+
+	ImGui::Text(Status);
+
+	//List results, click to show in Memory view 0, Ctrl+click for view 1
+	if (ImGui::BeginListBox("##Results", ImVec2(-FLT_MIN, -FLT_MIN))) {
+		const uint8_t *pimage = Shadow::QImage(ResultSpace);
+		char line[64];
+		for ( uint32_t i = 0; i < NumResults; ++i) {
+			uint16_t addr = Results[i];
+			line[0] = '$';
+			Numbers::ToHex(&line[1], addr);
+			line[5] = ' ';
+			uint32_t len = Shadow::IMAGESIZE - addr;
+			Numbers::ToHex(&line[6], sizeof(line) - 6, &pimage[addr], len < PREVIEWBYTES ? len : PREVIEWBYTES);
+
+			ImGui::PushID(static_cast<int32_t>(i));
+			if (ImGui::Selectable(line)) {
+				Memory::SetAddress(CtrlDown() ? 1 : 0, addr, ResultSpace);
+			}
+			ImGui::PopID();
+			if (const char *plabel = Labels::Find(addr); plabel) {
+				ImGui::SameLine();
+				ImGui::Text(plabel);
+			}
+		}
+		ImGui::EndListBox();
+	}
+
+	ImGui::End();
+}
+
+}	//namespace SearchView
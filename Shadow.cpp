@@ -0,0 +1,267 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Shadow.cpp
+//----------------------------------------------------------------------
+
+#include "Shadow.h"
+#include "Command.h"
+#include "Monitor.h"
+#include "Response.h"
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+
+namespace Shadow
+{
+
+//NOTE: VICE responses are limited to < 0x200 bytes by Response::LooksGood(),
+// so we fetch a page per request.
+
+//----------------------------------------------------------------
+///Image of one memspace and bank
+struct Image
+{
+	uint8_t Data[IMAGESIZE] = { 0 };			//The memory image
+	bool ValidA[NUMPAGES] = { false };			//Page up to date flags
+	bool PendingA[NUMPAGES] = { false };		//Page request sent flags
+	uint32_t StampA[NUMPAGES] = { 0 };			//Stamp of last store to each page
+	uint32_t RequestA[NUMPAGES] = { 0 };		//ID of the latest request for each page
+};
+
+//----------------------------------------------------------------
+///Page a request was sent for
+struct PageRef
+{
+	Image *pImage;
+	Banks::Space Space;
+	uint8_t Page;
+};
+
+//----------------------------------------------------------------
+///Bytes a refetch was sent for
+struct PatchRef
+{
+	CommandPtr pCommand;
+	Banks::Space Space;
+	uint16_t Start;
+	uint16_t End;
+};
+
+uint32_t Stamp = 0;								//Incremented on each store
+std::unordered_map<Banks::Space, std::unique_ptr<Image>> Images;	//Image per memspace/bank
+std::unordered_map<uint32_t, PageRef> PageIDs;	//Command ID to page lookup
+std::unordered_map<uint32_t, PatchRef> PatchIDs;	//Command ID to refetch lookup
+
+//----------------------------------------------------------------
+///Get image for a space, creating it if needed
+Image &Get( Banks::Space aSpace )
+{
+	auto &pimage = Images[aSpace];
+	if (!pimage) {
+		pimage = std::make_unique<Image>();
+	}
+	return *pimage;
+}
+
+//----------------------------------------------------------------
+const uint8_t *QImage( Banks::Space aSpace )
+{
+	return Get(aSpace).Data;
+}
+
+//----------------------------------------------------------------
+bool QValid( uint16_t aStart, uint16_t aEnd, Banks::Space aSpace )
+{
+	const Image &image = Get(aSpace);
+	for ( uint32_t page = aStart / PAGESIZE; page <= aEnd / PAGESIZE; ++page) {
+		if (!image.ValidA[page]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------------
+uint32_t QValidPages( Banks::Space aSpace )
+{
+	uint32_t count = 0;
+	for ( auto valid : Get(aSpace).ValidA ) {
+		count += valid;
+	}
+	return count;
+}
+
+//----------------------------------------------------------------
+uint32_t QStamp( uint16_t aStart, uint16_t aEnd, Banks::Space aSpace )
+{
+	const Image &image = Get(aSpace);
+	uint32_t stamp = 0;
+	for ( uint32_t page = aStart / PAGESIZE; page <= aEnd / PAGESIZE; ++page) {
+		stamp = image.StampA[page] > stamp ? image.StampA[page] : stamp;
+	}
+	return stamp;
+}
+
+//----------------------------------------------------------------
+void Store( uint16_t aAddress, const uint8_t *apData, uint32_t aSize, Banks::Space aSpace )
+{
+	//Clamp to end of address space
+	if (aAddress + aSize > IMAGESIZE) {
+		aSize = IMAGESIZE - aAddress;
+	}
+
+	if (aSize) {
+		Image &image = Get(aSpace);
+		memcpy_s(&image.Data[aAddress], IMAGESIZE - aAddress, apData, aSize);
+
+		++Stamp;
+		for ( uint32_t page = aAddress / PAGESIZE; page <= (aAddress + aSize - 1) / PAGESIZE; ++page) {
+			image.StampA[page] = Stamp;
+		}
+
+		//Mark pages completely covered by the data as up to date
+		uint32_t first = (aAddress + PAGESIZE - 1) / PAGESIZE;
+		uint32_t last = (aAddress + aSize) / PAGESIZE;
+		for ( uint32_t page = first; page < last; ++page) {
+			image.ValidA[page] = true;
+		}
+	}
+}
+
+//----------------------------------------------------------------
+void Invalidate(  )
+{
+	for ( auto &[space, pimage] : Images ) {
+		for ( uint32_t i = 0; i < NUMPAGES; ++i) {
+			pimage->ValidA[i] = false;
+			pimage->PendingA[i] = false;		//Allow re-request if a response was lost
+		}
+	}
+}
+
+//----------------------------------------------------------------
+void Invalidate( uint16_t aStart, uint16_t aEnd, Banks::Space aSpace )
+{
+	Image &image = Get(aSpace);
+	for ( uint32_t page = aStart / PAGESIZE; page <= aEnd / PAGESIZE; ++page) {
+		image.ValidA[page] = false;
+		image.PendingA[page] = false;
+	}
+}
+
+//----------------------------------------------------------------
+void Fetch( uint16_t aStart, uint16_t aEnd, Banks::Space aSpace )
+{
+	Image &image = Get(aSpace);
+	for ( uint32_t page = aStart / PAGESIZE; page <= aEnd / PAGESIZE; ++page) {
+		//Only ask for pages we don't have and haven't already asked for
+		if (!image.ValidA[page] && !image.PendingA[page]) {
+			//A new ID each time so a response to an earlier request for the
+			// page, still on its way, can't pass for this one
+			auto pcommand = CommandPtr(new Command(COMMAND::MEMORY_GET));
+			PageIDs[pcommand->QID()] = { &image, aSpace, static_cast<uint8_t>(page) };
+			image.RequestA[page] = pcommand->QID();
+
+			auto start = static_cast<uint16_t>(page * PAGESIZE);
+			pcommand->Add(0_u8);				//No side effects
+			pcommand->Add(start);				//Start Address
+			pcommand->Add(static_cast<uint16_t>(start + PAGESIZE - 1));	//End Address
+			pcommand->Add(Banks::QMemspace(aSpace));
+			pcommand->Add(Banks::QBank(aSpace));
+			Monitor::Send(pcommand);
+			image.PendingA[page] = true;
+		}
+	}
+}
+
+//----------------------------------------------------------------
+void Refetch( uint16_t aStart, uint16_t aEnd, Banks::Space aSpace )
+{
+	const Image &image = Get(aSpace);
+	uint32_t start = aStart;
+	while (start <= aEnd) {
+		//Request at most to the end of the page, as for Fetch
+		const uint32_t end = std::min<uint32_t>(start | (PAGESIZE - 1), aEnd);
+		if (image.ValidA[start / PAGESIZE]) {
+			auto pcommand = CommandPtr(new Command(COMMAND::MEMORY_GET));
+			pcommand->Add(0_u8);				//No side effects
+			pcommand->Add(static_cast<uint16_t>(start));
+			pcommand->Add(static_cast<uint16_t>(end));
+			pcommand->Add(Banks::QMemspace(aSpace));
+			pcommand->Add(Banks::QBank(aSpace));
+			PatchIDs[pcommand->QID()] = { pcommand, aSpace, static_cast<uint16_t>(start), static_cast<uint16_t>(end) };
+			Monitor::Send(pcommand);
+		}
+		start = end + 1;
+	}
+}
+
+//----------------------------------------------------------------
+std::vector<Banks::Space> QSpaces(  )
+{
+	std::vector<Banks::Space> spaces;
+	for ( const auto &entry : Images ) {
+		spaces.push_back(entry.first);
+	}
+	return spaces;
+}
+
+//----------------------------------------------------------------
+bool FromResponse( const Response &arResponse )
+{
+	bool bres = false;
+	if (auto patch = PatchIDs.find(arResponse.QID()); patch != PatchIDs.end()) {
+		bres = true;
+		const PatchRef &ref = patch->second;
+		//If the page was invalidated since the request VICE may have run
+		// since, so the whole page will be fetched again
+		if (QValid(ref.Start, ref.End, ref.Space)) {
+			const uint32_t size = std::min<uint32_t>(arResponse.Get16(0), ref.End - ref.Start + 1);
+			Store(ref.Start, arResponse.QBody() + 2, size, ref.Space);
+		}
+		PatchIDs.erase(patch);
+	}
+	else if (auto entry = PageIDs.find(arResponse.QID()); entry != PageIDs.end()) {
+		bres = true;
+		const PageRef ref = entry->second;
+		PageIDs.erase(entry);
+		//If invalidated or asked for again since the request the data may
+		// be stale, so drop it
+		if (ref.pImage->PendingA[ref.Page] && (ref.pImage->RequestA[ref.Page] == arResponse.QID())) {
+			ref.pImage->PendingA[ref.Page] = false;
+			uint16_t size = arResponse.Get16(0);
+			if (size > PAGESIZE) { size = PAGESIZE; }
+			Store(static_cast<uint16_t>(ref.Page * PAGESIZE), arResponse.QBody() + 2, size, ref.Space);
+		}
+	}
+	return bres;
+}
+
+}	//namespace Shadow
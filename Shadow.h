@@ -0,0 +1,105 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Shadow.h
+//----------------------------------------------------------------------
+
+#pragma once
+
+#include "types.h"
+#include "Banks.h"
+
+#include <vector>
+
+class Response;
+
+///Shadow copy of the c64 64K address space.
+/// Every memory response we receive is stored here so systems that need
+/// to look at large amounts of memory (search, compare etc) can work on
+/// a local image instead of requesting data from VICE. Data is tracked
+/// in 256 byte pages which are invalidated whenever VICE runs. After a
+/// single step only the bytes the instruction could write are refetched
+/// (see Footprint).
+/// There is an image per memspace and bank, created on first use, so
+/// views switching between them keep what was already fetched.
+namespace Shadow
+{
+
+constexpr uint32_t PAGESIZE = 0x100;
+constexpr uint32_t NUMPAGES = 0x100;
+constexpr uint32_t IMAGESIZE = PAGESIZE * NUMPAGES;
+
+//----------------------------------------------------------------
+///Get pointer to the 64K image
+const uint8_t *QImage( Banks::Space aSpace = Banks::MAIN );
+
+//----------------------------------------------------------------
+///Return true if all pages in the given range are up to date
+bool QValid( uint16_t aStart, uint16_t aEnd, Banks::Space aSpace = Banks::MAIN );
+
+//----------------------------------------------------------------
+///Return number of up to date pages
+uint32_t QValidPages( Banks::Space aSpace = Banks::MAIN );
+
+//----------------------------------------------------------------
+///Return a stamp that changes whenever data is stored to any page
+/// in the given range
+uint32_t QStamp( uint16_t aStart, uint16_t aEnd, Banks::Space aSpace = Banks::MAIN );
+
+//----------------------------------------------------------------
+///Copy data into the image at given address. Pages completely covered
+/// by the data are marked up to date
+void Store( uint16_t aAddress, const uint8_t *apData, uint32_t aSize, Banks::Space aSpace = Banks::MAIN );
+
+//----------------------------------------------------------------
+///Mark all pages of every image as out of date
+void Invalidate(  );
+
+//----------------------------------------------------------------
+///Mark pages in the given range as out of date
+void Invalidate( uint16_t aStart, uint16_t aEnd, Banks::Space aSpace = Banks::MAIN );
+
+//----------------------------------------------------------------
+///Ask VICE again for just the given bytes of pages we have. The pages stay
+/// up to date, so views show the old bytes until the new ones arrive.
+/// Pages we don't have are left to be fetched whole when needed
+void Refetch( uint16_t aStart, uint16_t aEnd, Banks::Space aSpace = Banks::MAIN );
+
+//----------------------------------------------------------------
+///Get spaces that have an image
+std::vector<Banks::Space> QSpaces(  );
+
+//----------------------------------------------------------------
+///Request all out of date pages in the given range from VICE
+void Fetch( uint16_t aStart, uint16_t aEnd, Banks::Space aSpace = Banks::MAIN );
+
+//----------------------------------------------------------------
+///Process memory response if it was for one of our requests
+bool FromResponse( const Response &arResponse );
+
+}	//namespace Shadow
@@ -0,0 +1,105 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Simd.h
+//----------------------------------------------------------------------
+
+#pragma once
+
+#include "types.h"
+#include <bit>
+#include <emmintrin.h>							//SSE2 is always available on x64
+
+///Small SSE2 helpers for comparing blocks of c64 memory
+namespace Simd
+{
+
+constexpr uint32_t LANES = 0x10;				//Bytes per 128 bit register
+
+//----------------------------------------------------------------
+///Return bitmask of bytes in the 16 byte rows at apA and apB that are equal
+inline uint32_t EqualMask( const uint8_t *apA, const uint8_t *apB )
+{
+	auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(apA));
+	auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(apB));
+	return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+}
+
+//----------------------------------------------------------------
+///Return bitmask of bytes in the 16 byte row at apA equal to aValue
+inline uint32_t ValueMask( const uint8_t *apA, uint8_t aValue )
+{
+	auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(apA));
+	auto v = _mm_set1_epi8(static_cast<char>(aValue));
+	return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, v)));
+}
+
+//----------------------------------------------------------------
+///Return bitmask of bytes in the 16 byte row at apA that are greater
+/// (unsigned) than the matching byte at apB
+inline uint32_t GreaterMask( const uint8_t *apA, const uint8_t *apB )
+{
+	auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(apA));
+	auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(apB));
+	//SSE2 has no unsigned compare, a > b when max(a, b) == a and a != b
+	auto ge = _mm_cmpeq_epi8(_mm_max_epu8(a, b), a);
+	auto gt = _mm_andnot_si128(_mm_cmpeq_epi8(a, b), ge);
+	return static_cast<uint32_t>(_mm_movemask_epi8(gt));
+}
+
+//----------------------------------------------------------------
+///Return true if the 16 byte rows at apA and apB differ
+inline bool RowDiffers( const uint8_t *apA, const uint8_t *apB )
+{
+	return EqualMask(apA, apB) != 0xffff;
+}
+
+//----------------------------------------------------------------
+///Return index of the lowest set bit in aMask, aMask must not be 0
+inline uint32_t LowBit( uint32_t aMask )
+{
+	return static_cast<uint32_t>(std::countr_zero(aMask));
+}
+
+//----------------------------------------------------------------
+///Compare aRows 16 byte rows (64 maximum) and return a bitmask with
+/// a bit set for each row that differs
+inline uint64_t DiffRows( const uint8_t *apA, const uint8_t *apB, uint32_t aRows )
+{
+	uint64_t mask = 0;
+	for ( uint32_t i = 0; i < aRows; ++i) {
+		if (RowDiffers(apA, apB)) {
+			mask |= 1ull << i;
+		}
+		apA += LANES;
+		apB += LANES;
+	}
+	return mask;
+}
+
+}	//namespace Simd
@@ -0,0 +1,394 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Smc.cpp
+//----------------------------------------------------------------------
+
+
+#include "Smc.h"
+#include "6502.h"
+#include "Code.h"
+#include "Command.h"
+#include "DisAssembler.h"
+#include "Labels.h"
+#include "Monitor.h"
+#include "Regions.h"
+#include "Response.h"
+#include "Shadow.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <imgui.h>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Smc
+{
+
+constexpr uint32_t MAXWATCHES = 0x80;			//Most checkpoints we will place
+constexpr uint32_t BUDGET = 0x40;				//Hits per second before a watch is disabled
+constexpr auto WINDOW = std::chrono::seconds(1);	//Period hit rates are measured over
+constexpr auto COOLDOWN = std::chrono::seconds(3);	//Time a watch stays disabled before counting again
+constexpr uint8_t STORE = 1_bit;				//Checkpoint operation
+constexpr uint32_t LINELEN = 0x20;				//Disassembly line length
+
+using Clock = std::chrono::steady_clock;
+
+//CHECKPOINT_INFO body offsets
+constexpr uint32_t INFO_INDEX = 0;
+constexpr uint32_t INFO_HITCOUNT = 13;
+
+//----------------------------------------------------------------
+///A write checkpoint over a run of code
+struct Watch
+{
+	CommandPtr pCommand;						//Command used to control the checkpoint
+	uint32_t Index = 0xffffffff;				//VICE checkpoint number
+	uint32_t HitCount = 0;						//Last hit count reported by VICE
+	uint32_t Writes = 0;						//Writes counted while enabled
+	uint32_t WindowHits = 0;					//Hits during the current rate window
+	Clock::time_point DisabledAt;				//When the watch was disabled for going over budget
+	uint16_t Start = 0;
+	uint16_t End = 0;
+	std::vector<uint8_t> Seen;					//Bytes as last read, empty until read
+	std::vector<uint16_t> Sites;				//Instructions whose bytes changed, sorted
+	bool Enabled = true;
+	bool Throttled = false;						//Writes were missed while disabled
+	bool Stale = true;							//Written or not read since Seen was taken
+
+	bool Legit(  ) const { return Index != 0xffffffff; }
+
+	//----------------------------------------------------------------
+	///Find the instructions the write changed, decoding them as they
+	/// were before it
+	void Compare( const uint8_t *apImage )
+	{
+		for ( uint32_t addr = Start; addr <= End; ) {
+			const uint8_t *pold = &Seen[addr - Start];
+			const uint32_t size = std::max<uint32_t>(OpCode::Get(*pold).QSize(), 1);
+			const uint32_t last = std::min<uint32_t>(addr + size - 1, End);
+			if (memcmp(pold, apImage + addr, last - addr + 1)) {
+				auto it = std::lower_bound(Sites.begin(), Sites.end(), addr);
+				if ((it == Sites.end()) || (*it != addr)) {
+					Sites.insert(it, static_cast<uint16_t>(addr));
+				}
+			}
+			addr += size;
+		}
+	}
+
+	//----------------------------------------------------------------
+	///Send VICE command to set enable state
+	void Enable( bool abTF )
+	{
+		if (Legit() && (Enabled != abTF)) {
+			Enabled = abTF;
+			pCommand->SetCommand(COMMAND::CHECKPOINT_TGL);
+			pCommand->Reset();
+			pCommand->Add(Index);
+			pCommand->Add(static_cast<uint8_t>(Enabled));
+			Monitor::Send(pCommand);
+		}
+	}
+};
+
+std::vector<Watch> Watches;
+std::unordered_map<uint32_t, uint32_t> WatchIDs;	//Command ID or VICE index to watch
+std::map<uint16_t, uint32_t> WatchAt;			//Start address to watch
+uint32_t RegionStamp = 0xffffffff;				//Regions map the watches were placed from
+Clock::time_point WindowStart = Clock::now();
+bool Enabled = false;							//Window enabled
+bool Watching = true;							//Place checkpoints on code
+
+//----------------------------------------------------------------
+///Place a checkpoint from aStart to aEnd inclusive
+void Add( uint16_t aStart, uint16_t aEnd )
+{
+	Watch watch;
+	watch.Start = aStart;
+	watch.End = aEnd;
+	watch.pCommand = CommandPtr(new Command(COMMAND::CHECKPOINT_SET));
+	watch.pCommand->Add(watch.Start);			//Start address
+	watch.pCommand->Add(watch.End);				//End address
+	watch.pCommand->Add(0_u8);					//Don't stop when hit
+	watch.pCommand->Add(1_u8);					//Enabled
+	watch.pCommand->Add(STORE);					//Writes only
+	watch.pCommand->Add(0_u16);					//Not temporary and memspace 0
+	WatchIDs[watch.pCommand->QID()] = static_cast<uint32_t>(Watches.size());
+	WatchAt[aStart] = static_cast<uint32_t>(Watches.size());
+	Monitor::Send(watch.pCommand);
+	Watches.push_back(std::move(watch));
+}
+
+//----------------------------------------------------------------
+///Watch the parts of a code run no watch covers yet
+void Cover( uint16_t aStart, uint16_t aEnd )
+{
+	uint32_t addr = aStart;
+	while ((addr <= aEnd) && (Watches.size() < MAXWATCHES)) {
+		auto next = WatchAt.upper_bound(static_cast<uint16_t>(addr));
+		if (next != WatchAt.begin()) {
+			if (const Watch &rwatch = Watches[std::prev(next)->second]; rwatch.End >= addr) {
+				addr = rwatch.End + 1u;			//Already watched
+				continue;
+			}
+		}
+		const uint32_t end = (next != WatchAt.end()) ? std::min<uint32_t>(next->first - 1u, aEnd) : aEnd;
+		Add(static_cast<uint16_t>(addr), static_cast<uint16_t>(end));
+		addr = end + 1;
+	}
+}
+
+//----------------------------------------------------------------
+///Watch the code Flow found, as it is found. Code that runs in a loop
+/// is watched without VICE having to stop in it
+void Place(  )
+{
+	if (!Watching || (Monitor::ViceState() == VICESTATE::DISCONNECTED)) return;
+
+	if (const uint32_t stamp = Regions::QStamp(); stamp != RegionStamp) {
+		RegionStamp = stamp;
+		Regions::QMap().ForEach([]( const Regions::Run &arRun ) {
+			if (arRun.Type == Regions::TYPE::CODE) {
+				Cover(arRun.Start, arRun.End);
+			}
+		});
+	}
+}
+
+//----------------------------------------------------------------
+///Read back watched code that was written, to find which instructions
+/// changed
+void Check(  )
+{
+	const uint8_t *pimage = Shadow::QImage();
+	for ( auto &watch : Watches ) {
+		if (!watch.Stale) continue;
+
+		if (!Shadow::QValid(watch.Start, watch.End)) {
+			Shadow::Fetch(watch.Start, watch.End);
+			continue;
+		}
+		if (!watch.Seen.empty()) {
+			watch.Compare(pimage);
+		}
+		watch.Seen.assign(pimage + watch.Start, pimage + watch.End + 1);
+		watch.Stale = false;
+	}
+}
+
+//----------------------------------------------------------------
+bool QSite( uint16_t aStart, uint16_t aEnd )
+{
+	for ( const auto &watch : Watches ) {
+		if ((watch.Start <= aEnd) && (watch.End >= aStart)) {
+			auto it = std::lower_bound(watch.Sites.begin(), watch.Sites.end(), aStart);
+			if ((it != watch.Sites.end()) && (*it <= aEnd)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+//----------------------------------------------------------------
+bool ProcessInfo( const Response &arResponse )
+{
+	const uint32_t index = arResponse.Get<uint32_t>(INFO_INDEX);
+
+	//Responses to our set command carry its ID, later ones only the VICE index
+	auto entry = WatchIDs.find(arResponse.QID());
+	if (entry == WatchIDs.end()) {
+		entry = WatchIDs.find(index | 0x80000000);
+	}
+	if (entry == WatchIDs.end()) return false;
+
+	Watch &watch = Watches[entry->second];
+	if (!watch.Legit()) {
+		watch.Index = index;
+		WatchIDs[index | 0x80000000] = entry->second;	//Keep VICE indices apart from command IDs
+	}
+
+	const uint32_t hitCount = arResponse.Get<uint32_t>(INFO_HITCOUNT);
+	if (hitCount > watch.HitCount) {
+		const uint32_t hits = hitCount - watch.HitCount;
+		watch.Writes += hits;
+		watch.WindowHits += hits;
+		watch.Stale = true;
+
+		//The code changed under us, so drop what we have of it
+		Shadow::Invalidate(watch.Start, watch.End);
+		Code::Invalidate(watch.Start, watch.End);
+	}
+	watch.HitCount = hitCount;
+	return true;
+}
+
+//----------------------------------------------------------------
+///Disable watches hit faster than the budget, enable those that have cooled down
+void Throttle(  )
+{
+	const auto now = Clock::now();
+	if (now - WindowStart < WINDOW) return;
+
+	for ( auto &watch : Watches ) {
+		if (watch.Enabled) {
+			if (watch.WindowHits > BUDGET) {
+				watch.Enable(false);
+				watch.DisabledAt = now;
+				watch.Throttled = true;
+			}
+		}
+		else if (now - watch.DisabledAt >= COOLDOWN) {
+			watch.Enable(true);
+		}
+		watch.WindowHits = 0;
+	}
+	WindowStart = now;
+}
+
+//----------------------------------------------------------------
+void Disarm(  )
+{
+	for ( auto &watch : Watches ) {
+		if (watch.Legit()) {
+			watch.pCommand->SetCommand(COMMAND::CHECKPOINT_DEL);
+			watch.pCommand->Reset();
+			watch.pCommand->Add(watch.Index);
+			Monitor::Send(watch.pCommand);
+		}
+	}
+	Watches.clear();
+	WatchIDs.clear();
+	WatchAt.clear();
+	RegionStamp = 0xffffffff;					//Place again from what is known now
+}
+
+//----------------------------------------------------------------
+void ToJson( nlohmann::json &arData )
+{
+	arData["Smc"] = {
+		{"On", Enabled},
+		{"Watching", Watching}
+	};
+}
+
+//----------------------------------------------------------------
+void FromJson( nlohmann::json &arData )
+{
+	auto obj = arData["Smc"];
+	if (!obj.is_null()) {
+		Enabled = obj["On"];
+		Watching = obj["Watching"];
+	}
+}
+
+//----------------------------------------------------------------
+void DisplayOn(  )
+{
+	Enabled = true;
+}
+
+//----------------------------------------------------------------
+void Display(  )
+{
+	Place();
+	if (!Watches.empty()) {
+		Throttle();								//Keep checking rates while hidden
+		Check();
+	}
+
+	if (!Enabled) return;						//Early out if view not visible
+
+	ImGui::SetNextWindowSize(ImVec2(330, 300), ImGuiCond_FirstUseEver);
+	ImGui::Begin("SMC Sites", &Enabled);
+
+	ImGui::Checkbox("Watch code", &Watching);
+	ImGui::SameLine();
+	if (ImGui::Button("Clear")) {
+		Disarm();
+	}
+	ImGui::Text("%u of %u code runs watched", static_cast<uint32_t>(Watches.size()), MAXWATCHES);
+
+	//Sites in address order, the writes are those to the run holding them
+	std::vector<std::pair<uint16_t, const Watch*>> sites;
+	for ( const auto &[start, index] : WatchAt ) {
+		for ( uint16_t site : Watches[index].Sites ) {
+			sites.emplace_back(site, &Watches[index]);
+		}
+	}
+
+	if (ImGui::BeginTable("##Sites", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg
+		| ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable)) {
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("Address");
+		ImGui::TableSetupColumn("Label");
+		ImGui::TableSetupColumn("Instruction");
+		ImGui::TableSetupColumn("Run writes");
+		ImGui::TableHeadersRow();
+
+		for ( const auto &[site, pwatch] : sites ) {
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			char text[8];
+			snprintf(text, sizeof(text), "%04x", site);
+			//Click shows the site in the Code view
+			if (ImGui::Selectable(text, false, ImGuiSelectableFlags_SpanAllColumns)) {
+				Code::SetAddress(site);
+			}
+			ImGui::TableNextColumn();
+			const char *plabel = Labels::Find(site);
+			ImGui::TextUnformatted(plabel ? plabel : "");
+
+			//Instruction as it is now
+			ImGui::TableNextColumn();
+			const uint32_t size = std::min<uint32_t>(pwatch->End - site + 1u, 3);
+			if (Shadow::QValid(site, static_cast<uint16_t>(site + size - 1))) {
+				char line[LINELEN];
+				char bytes[LINELEN];
+				const OpCode *pop = nullptr;
+				uint8_t data[3] = { 0 };
+				memcpy_s(data, sizeof(data), Shadow::QImage() + site, size);
+				DisAssembler::Input input{ line, bytes, &pop, data, sizeof(line), sizeof(data), 1, site };
+				DisAssembler::DisAssemble(input);
+				ImGui::TextUnformatted(line);
+			}
+
+			ImGui::TableNextColumn();
+			ImGui::Text(pwatch->Throttled ? "%u+" : "%u", pwatch->Writes);
+		}
+		ImGui::EndTable();
+	}
+
+	ImGui::End();
+}
+
+}	//namespace Smc
@@ -0,0 +1,369 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Snapshots.cpp
+//----------------------------------------------------------------------
+
+#include "Snapshots.h"
+#include "Lz.h"
+#include "Shadow.h"
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <string.h>
+#include <vector>
+
+namespace Snapshots
+{
+
+constexpr uint32_t PAGESIZE = Shadow::PAGESIZE;
+constexpr uint32_t NUMPAGES = Shadow::NUMPAGES;
+constexpr uint32_t KEYINTERVAL = 0x40;			//Maximum snapshots using a keyframe
+constexpr uint32_t KEYDELTA = 0x40;				//Maximum pages in a delta before a new keyframe
+constexpr uint32_t DEFBUDGET = 4 * 1024 * 1024;
+
+uint32_t PageBytes = 0;							//Bytes held by all stored pages
+
+//----------------------------------------------------------------
+///Immutable 256 byte page of memory, compressed if that saves space.
+/// Pages are shared between snapshots
+class Page
+{
+public:
+	//----------------------------------------------------------------
+	///Constructor, compress the page of data
+	explicit Page( const uint8_t *apData )
+	{
+		uint8_t packed[PAGESIZE];
+		uint32_t len = Lz::Compress(apData, PAGESIZE, packed, sizeof(packed) - 1);
+		Packed = len != 0;
+		Data.assign(Packed ? packed : apData, (Packed ? packed : apData) + (Packed ? len : PAGESIZE));
+		PageBytes += QBytes();
+	}
+
+	Page( const Page& ) = delete;
+	Page &operator=( const Page& ) = delete;
+
+	~Page(  )
+	{
+		PageBytes -= QBytes();
+	}
+
+	//----------------------------------------------------------------
+	///Get bytes used by the page
+	uint32_t QBytes(  ) const { return static_cast<uint32_t>(Data.size() + sizeof(*this)); }
+
+	//----------------------------------------------------------------
+	///Copy page data uncompressed into apDest
+	void Unpack( uint8_t *apDest ) const
+	{
+		if (Packed) {
+			Lz::Decompress(Data.data(), static_cast<uint32_t>(Data.size()), apDest, PAGESIZE);
+		}
+		else {
+			memcpy_s(apDest, PAGESIZE, Data.data(), PAGESIZE);
+		}
+	}
+
+private:
+	std::vector<uint8_t> Data;
+	bool Packed = false;						//Data is compressed
+};
+
+using PagePtr = std::shared_ptr<const Page>;
+
+//----------------------------------------------------------------
+///Page in a delta snapshot
+struct Entry
+{
+	uint8_t Index;
+	PagePtr pPage;
+};
+
+//----------------------------------------------------------------
+///Snapshot is either a keyframe with all pages or a delta holding pages
+/// which differ from its keyframe
+struct Snapshot
+{
+	uint32_t Key = 0;							//Serial of keyframe, our serial if we are one
+	std::vector<PagePtr> Pages;					//All pages if a keyframe
+	std::vector<Entry> Delta;					//Pages that differ from keyframe, sorted by Index
+
+	bool QKeyFrame(  ) const { return !Pages.empty(); }
+
+	uint32_t QBytes(  ) const
+	{
+		return static_cast<uint32_t>(sizeof(*this) + (Pages.size() * sizeof(PagePtr))
+			+ (Delta.size() * sizeof(Entry)));
+	}
+};
+
+std::deque<Snapshot> Ring;						//Snapshots oldest to newest
+uint32_t End = 0;								//Serial of next snapshot
+PagePtr LastPages[NUMPAGES];					//Pages of the newest snapshot
+uint8_t LastImage[Shadow::IMAGESIZE];			//Uncompressed newest snapshot to detect changes
+uint32_t Budget = DEFBUDGET;
+bool Recording = false;
+bool Pending = false;							//Waiting for shadow image to take snapshot
+
+//----------------------------------------------------------------
+///Get snapshot for serial or nullptr if not in the ring
+const Snapshot *Find( uint32_t aSerial )
+{
+	return ((aSerial >= QFirst()) && (aSerial < End)) ? &Ring[aSerial - QFirst()] : nullptr;
+}
+
+//----------------------------------------------------------------
+///Get page of snapshot
+const PagePtr &PageOf( const Snapshot &arSnap, uint32_t aPage )
+{
+	if (arSnap.QKeyFrame()) {
+		return arSnap.Pages[aPage];
+	}
+
+	auto it = std::lower_bound(arSnap.Delta.begin(), arSnap.Delta.end(), aPage
+		, []( const Entry &arEntry, uint32_t aIndex ) { return arEntry.Index < aIndex; });
+	if ((it != arSnap.Delta.end()) && (it->Index == aPage)) {
+		return it->pPage;
+	}
+	return Find(arSnap.Key)->Pages[aPage];
+}
+
+//----------------------------------------------------------------
+///Drop the oldest snapshot. If it was the keyframe for later snapshots
+/// the next one becomes the keyframe and the rest are rebased onto it
+void PopFront(  )
+{
+	Snapshot old = std::move(Ring.front());
+	Ring.pop_front();
+
+	if (!Ring.empty() && !Ring.front().QKeyFrame()) {
+		const uint32_t oldKey = Ring.front().Key;
+		const uint32_t newKey = QFirst();
+
+		//Promote next snapshot to keyframe
+		Snapshot &key = Ring.front();
+		key.Pages = old.Pages;
+		for ( const auto &entry : key.Delta ) {
+			key.Pages[entry.Index] = entry.pPage;
+		}
+		key.Delta.clear();
+		key.Key = newKey;
+
+		//Rebuild deltas of snapshots that used the old keyframe
+		for ( size_t i = 1; (i < Ring.size()) && (Ring[i].Key == oldKey); ++i) {
+			auto &snap = Ring[i];
+			std::vector<Entry> delta;
+			auto it = snap.Delta.begin();
+			for ( uint32_t page = 0; page < NUMPAGES; ++page) {
+				const PagePtr &ppage = ((it != snap.Delta.end()) && (it->Index == page))
+					? (it++)->pPage
+					: old.Pages[page];
+				if (ppage != key.Pages[page]) {
+					delta.push_back({static_cast<uint8_t>(page), ppage});
+				}
+			}
+			snap.Delta = std::move(delta);
+			snap.Key = newKey;
+		}
+	}
+}
+
+//----------------------------------------------------------------
+///Drop oldest snapshots until within budget, always keeping the newest
+void Trim(  )
+{
+	while ((Ring.size() > 1) && (QBytes() > Budget)) {
+		PopFront();
+	}
+}
+
+//----------------------------------------------------------------
+void ToJson( nlohmann::json &arData )
+{
+	arData["Snapshots"] = {
+		{"Record", Recording},
+		{"Budget", Budget}
+	};
+}
+
+//----------------------------------------------------------------
+void FromJson( nlohmann::json &arData )
+{
+	auto obj = arData["Snapshots"];
+	if (!obj.is_null()) {
+		Recording = obj["Record"];
+		Budget = obj["Budget"];
+	}
+}
+
+//----------------------------------------------------------------
+bool QRecording(  )
+{
+	return Recording;
+}
+
+//----------------------------------------------------------------
+void SetRecording( bool abTF )
+{
+	Recording = abTF;
+	Pending &= abTF;
+}
+
+//----------------------------------------------------------------
+uint32_t QFirst(  )
+{
+	return End - static_cast<uint32_t>(Ring.size());
+}
+
+//----------------------------------------------------------------
+uint32_t QEnd(  )
+{
+	return End;
+}
+
+//----------------------------------------------------------------
+uint32_t QBytes(  )
+{
+	uint32_t bytes = PageBytes;
+	for ( const auto &snap : Ring ) {
+		bytes += snap.QBytes();
+	}
+	return bytes;
+}
+
+//----------------------------------------------------------------
+uint32_t QBudget(  )
+{
+	return Budget;
+}
+
+//----------------------------------------------------------------
+void SetBudget( uint32_t aBytes )
+{
+	Budget = aBytes;
+	Trim();
+}
+
+//----------------------------------------------------------------
+void Capture(  )
+{
+	if (Recording) {
+		Pending = true;
+		Shadow::Fetch(0, 0xffff);
+	}
+}
+
+//----------------------------------------------------------------
+void Update(  )
+{
+	if (Pending && (Shadow::QValidPages() == NUMPAGES)) {
+		Add(Shadow::QImage());
+		Pending = false;
+	}
+}
+
+//----------------------------------------------------------------
+uint32_t Add( const uint8_t *apImage )
+{
+	//Store new pages only where memory changed since the last snapshot
+	for ( uint32_t page = 0; page < NUMPAGES; ++page) {
+		const uint32_t offset = page * PAGESIZE;
+		if (!LastPages[page] || memcmp(&apImage[offset], &LastImage[offset], PAGESIZE)) {
+			LastPages[page] = std::make_shared<const Page>(&apImage[offset]);
+			memcpy_s(&LastImage[offset], PAGESIZE, &apImage[offset], PAGESIZE);
+		}
+	}
+
+	Snapshot snap;
+	bool keyFrame = Ring.empty() || (End - Ring.back().Key >= KEYINTERVAL);
+	if (!keyFrame) {
+		snap.Key = Ring.back().Key;
+		const Snapshot &key = *Find(snap.Key);
+		for ( uint32_t page = 0; page < NUMPAGES; ++page) {
+			if (LastPages[page] != key.Pages[page]) {
+				snap.Delta.push_back({static_cast<uint8_t>(page), LastPages[page]});
+			}
+		}
+		//If the delta has grown large, start a new keyframe
+		keyFrame = snap.Delta.size() > KEYDELTA;
+	}
+
+	if (keyFrame) {
+		snap.Key = End;
+		snap.Pages.assign(std::begin(LastPages), std::end(LastPages));
+		snap.Delta.clear();
+	}
+
+	Ring.push_back(std::move(snap));
+	++End;
+	Trim();
+	return End - 1;
+}
+
+//----------------------------------------------------------------
+bool Get( uint32_t aSerial, uint16_t aAddress, uint8_t *apDest, uint32_t aSize )
+{
+	const Snapshot *psnap = Find(aSerial);
+	if (psnap) {
+		uint8_t data[PAGESIZE];
+		uint32_t addr = aAddress;
+		const uint32_t end = std::min<uint32_t>(addr + aSize, Shadow::IMAGESIZE);
+		while (addr < end) {
+			const uint32_t page = addr / PAGESIZE;
+			const uint32_t offset = addr % PAGESIZE;
+			const uint32_t len = std::min(PAGESIZE - offset, end - addr);
+			PageOf(*psnap, page)->Unpack(data);
+			memcpy_s(apDest, len, &data[offset], len);
+			apDest += len;
+			addr += len;
+		}
+	}
+	return psnap != nullptr;
+}
+
+//----------------------------------------------------------------
+bool PageDiffers( uint32_t aSerialA, uint32_t aSerialB, uint32_t aPage )
+{
+	const Snapshot *pa = Find(aSerialA);
+	const Snapshot *pb = Find(aSerialB);
+	return !pa || !pb || (PageOf(*pa, aPage) != PageOf(*pb, aPage));
+}
+
+//----------------------------------------------------------------
+void Clear(  )
+{
+	Ring.clear();
+	for ( auto &ppage : LastPages ) {
+		ppage.reset();
+	}
+	Pending = false;
+}
+
+}	//namespace Snapshots
@@ -0,0 +1,109 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Snapshots.h
+//----------------------------------------------------------------------
+
+#pragma once
+
+#include "types.h"
+#include "json/json.hpp"
+
+///Ring of 64K memory snapshots taken each time VICE stops.
+/// Memory is stored as compressed 256 byte pages shared between
+/// snapshots (a page is only stored again when it changes). Every so
+/// often a snapshot is a keyframe holding all pages, the others hold
+/// only the pages that differ from their keyframe. The oldest snapshots
+/// are dropped to keep within the memory budget.
+/// Snapshots are referred to by serial number which increases forever.
+namespace Snapshots
+{
+
+//----------------------------------------------------------------
+///Save data to Json
+void ToJson( nlohmann::json &arData );
+
+//----------------------------------------------------------------
+///Load data from Json
+void FromJson( nlohmann::json &arData );
+
+//----------------------------------------------------------------
+///Return true if recording snapshots on each stop
+bool QRecording(  );
+
+//----------------------------------------------------------------
+///Enable/Disable recording
+void SetRecording( bool abTF );
+
+//----------------------------------------------------------------
+///Get serial of the oldest snapshot
+uint32_t QFirst(  );
+
+//----------------------------------------------------------------
+///Get serial after the newest snapshot. QFirst() == QEnd() when empty
+uint32_t QEnd(  );
+
+//----------------------------------------------------------------
+///Get bytes used by page data and snapshot bookkeeping
+uint32_t QBytes(  );
+
+//----------------------------------------------------------------
+///Get memory budget in bytes
+uint32_t QBudget(  );
+
+//----------------------------------------------------------------
+///Set memory budget in bytes, drops oldest snapshots if over
+void SetBudget( uint32_t aBytes );
+
+//----------------------------------------------------------------
+///Request a snapshot of memory as soon as the shadow image is complete
+void Capture(  );
+
+//----------------------------------------------------------------
+///Take any pending snapshot. Call once a frame
+void Update(  );
+
+//----------------------------------------------------------------
+///Add snapshot of the 64K image and return its serial
+uint32_t Add( const uint8_t *apImage );
+
+//----------------------------------------------------------------
+///Copy aSize bytes starting at aAddress from the given snapshot into
+/// apDest. Return false if the snapshot is no longer in the ring
+bool Get( uint32_t aSerial, uint16_t aAddress, uint8_t *apDest, uint32_t aSize );
+
+//----------------------------------------------------------------
+///Return true if the page may differ between the two snapshots. False
+/// means both share the same stored page so no compare is needed
+bool PageDiffers( uint32_t aSerialA, uint32_t aSerialB, uint32_t aPage );
+
+//----------------------------------------------------------------
+///Remove all snapshots
+void Clear(  );
+
+}	//namespace Snapshots
@@ -0,0 +1,612 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Source.cpp
+//----------------------------------------------------------------------
+
+#include "Source.h"
+#include "6502.h"
+#include "Flow.h"
+#include "Labels.h"
+#include "Program.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace Source
+{
+
+constexpr uint32_t IMAGESIZE = 0x10000;
+constexpr uint32_t BUFFERSIZE = 0x1000;			//Text handed to OUTFN at a time
+constexpr uint32_t LINEMAX = 0x100;				//Longest line
+constexpr uint32_t NAMEMAX = 0x70;				//Longest label written
+constexpr uint32_t LINEBYTES = 16;				//Bytes per .byte line
+constexpr uint32_t LINEWORDS = 8;				//Words per .word line
+constexpr uint8_t DATA = 0xff;					//Offset of a byte not in an instruction line
+
+//----------------------------------------------------------------
+///KickAssembler operand text per ADDRESS_MODE
+struct Template
+{
+	const char *pPrefix;						//Text before value
+	const char *pSuffix;						//Text after value
+	uint8_t Digits;								//Hex digits of value, 0 if none
+	bool bAddress;								//Value is an address that may take a label
+};
+
+//----------------------------------------------------------------
+///Indexed by ADDRESS_MODE
+constexpr Template TemplateA[] =
+{
+	{ "", "", 0, false },						//NONE
+	{ "#$", "", 2, false },						//IMMEDIATE
+	{ "", "", 2, true },						//ZERO_PAGE
+	{ "", ",x", 2, true },						//ZERO_PAGE_X
+	{ "", ",y", 2, true },						//ZERO_PAGE_Y
+	{ "(", ",x)", 2, true },					//INDIRECT_X
+	{ "(", "),y", 2, true },					//INDIRECT_Y
+	{ "", "", 4, true },						//RELATIVE
+	{ "", "", 4, true },						//ABSOLUTE
+	{ "", ",x", 4, true },						//ABSOLUTE_X
+	{ "", ",y", 4, true },						//ABSOLUTE_Y
+	{ "(", ")", 4, true },						//INDIRECT
+	{ "", "", 0, false },						//ERROR
+};
+
+constexpr char HexA[] = "0123456789ABCDEF";
+
+//----------------------------------------------------------------
+///Write 2 upper case hex digits without a terminator
+inline char *AddHex( char *apDest, uint8_t aValue )
+{
+	apDest[0] = HexA[aValue >> 4];
+	apDest[1] = HexA[aValue & 0x0f];
+	return apDest + 2;
+}
+
+//----------------------------------------------------------------
+///Append string without its terminator
+inline char *AddStr( char *apDest, const char *apSource )
+{
+	while (*apSource) {
+		*apDest++ = *apSource++;
+	}
+	return apDest;
+}
+
+//----------------------------------------------------------------
+///Works out which bytes are code and which addresses need labels, then
+/// writes the lines
+class Writer
+{
+public:
+	//----------------------------------------------------------------
+	Writer( const Job &arJob, const OUTFN &aOut ) : rJob(arJob), rOut(aOut), pImage(arJob.pImage) { }
+
+	//----------------------------------------------------------------
+	void Run(  )
+	{
+		Analyse();
+		Layout();
+		Reference();
+		Emit();
+	}
+
+private:
+	const Job &rJob;
+	const OUTFN &rOut;
+	const uint8_t *pImage;
+	std::bitset<IMAGESIZE> InRange;				//Bytes to write
+	std::bitset<IMAGESIZE> Starts;				//Instruction starts Flow found
+	std::bitset<IMAGESIZE> Labelled;			//Line starts that get a label
+	std::bitset<IMAGESIZE> Words;				//First bytes of words in address tables
+	Regions::Map Types;							//Code and data
+	std::vector<uint8_t> Offset = std::vector<uint8_t>(IMAGESIZE, DATA);	//Offset of each byte in its instruction line
+	std::vector<uint16_t> Externals;			//Labels used but not placed on a line
+	uint32_t Used = 0;							//Chars in Buffer
+	char Buffer[BUFFERSIZE];
+
+	//----------------------------------------------------------------
+	const OpCode &Op( uint32_t aAddress ) const { return OpCode::Get(pImage[aAddress]); }
+
+	//----------------------------------------------------------------
+	///Operand value of the instruction at an address, the target for branches
+	uint16_t Operand( uint32_t aAddress ) const
+	{
+		const OpCode &rop = Op(aAddress);
+		uint16_t value = pImage[(aAddress + 1) & 0xffff];
+		if (rop.QSize() == 3) {
+			value |= pImage[(aAddress + 2) & 0xffff] << 8;
+		}
+		else if (rop.eMode == ADDRESS_MODE::RELATIVE) {
+			value = static_cast<uint16_t>(aAddress + 2 + static_cast<int8_t>(value));
+		}
+		return value;
+	}
+
+	//----------------------------------------------------------------
+	const char *UserLabel( uint16_t aAddress ) const
+	{
+		return rJob.FindLabel ? rJob.FindLabel(aAddress) : nullptr;
+	}
+
+	//----------------------------------------------------------------
+	///True if the address is written at the start of a line
+	bool QLineStart( uint16_t aAddress ) const
+	{
+		return InRange[aAddress] && ((Offset[aAddress] == 0) || (Offset[aAddress] == DATA));
+	}
+
+	//----------------------------------------------------------------
+	///Walk the code in the ranges from the entry points
+	void Analyse(  )
+	{
+		Flow::PageSet pages;
+		for ( const auto &range : rJob.Ranges ) {
+			for ( uint32_t addr = range.Start; addr <= range.End; ++addr) {
+				InRange[addr] = true;
+			}
+			for ( uint32_t page = range.Start >> 8; page <= (range.End >> 8u); ++page) {
+				pages[page] = true;
+			}
+		}
+
+		//Code marked in the map is walked too
+		std::vector<uint16_t> entries;
+		for ( auto entry : rJob.Entries ) {
+			if (InRange[entry]) {
+				entries.push_back(entry);
+			}
+		}
+		if (rJob.pRegions) {
+			rJob.pRegions->ForEach([&]( const Regions::Run &arRun ) {
+				if ((arRun.Type == Regions::TYPE::CODE) && InRange[arRun.Start]) {
+					entries.push_back(arRun.Start);
+				}
+			});
+		}
+
+		const auto blocks = Flow::Analyse(pImage, pages, std::move(entries));
+		for ( const auto &rblock : blocks ) {
+			for ( uint32_t addr = rblock.Start; addr <= rblock.Last; addr += Op(addr).QSize()) {
+				Starts[addr] = true;
+			}
+		}
+		Types = rJob.pRegions ? *rJob.pRegions : Regions::Classify(pImage, pages, blocks);
+	}
+
+	//----------------------------------------------------------------
+	///True if the map has the address as data
+	bool QData( uint32_t aAddress ) const
+	{
+		return Regions::QData(Types.Get(static_cast<uint16_t>(aAddress)));
+	}
+
+	//----------------------------------------------------------------
+	///Choose the instruction lines. An instruction is only written as one
+	/// if it is inside its range, isn't data in the map and no other
+	/// instruction starts inside it, so decoding is back in step at every
+	/// entry point. Address tables are laid out a word at a time
+	void Layout(  )
+	{
+		for ( const auto &range : rJob.Ranges ) {
+			for ( uint32_t addr = range.Start; addr <= range.End; ) {
+				if (const Regions::Run run = Types.QRun(static_cast<uint16_t>(addr)); run.Type == Regions::TYPE::WORDS) {
+					const uint32_t end = std::min<uint32_t>(run.End, range.End);
+					for ( ; (addr + 1) <= end; addr += 2) {
+						Words[addr] = true;
+						Offset[addr] = 0;
+						Offset[addr + 1] = 1;
+					}
+					addr = end + 1;
+					continue;
+				}
+
+				if (Starts[addr] && !QData(addr)) {
+					const uint32_t size = Op(addr).QSize();
+					bool bfits = (addr + size - 1) <= range.End;
+					for ( uint32_t i = 1; bfits && (i < size); ++i) {
+						bfits = !Starts[addr + i] && !QData(addr + i);
+					}
+					if (bfits) {
+						for ( uint32_t i = 0; i < size; ++i) {
+							Offset[addr + i] = static_cast<uint8_t>(i);
+						}
+						addr += size;
+						continue;
+					}
+				}
+				++addr;
+			}
+		}
+	}
+
+	//----------------------------------------------------------------
+	///Label the line an operand or table entry refers to. Values in the
+	/// middle of an instruction use its line's label plus an offset
+	void Refer( uint16_t aValue )
+	{
+		if (UserLabel(aValue)) {
+			if (!QLineStart(aValue)) {
+				Externals.push_back(aValue);
+			}
+		}
+		else if (InRange[aValue]) {
+			Labelled[(Offset[aValue] == DATA) ? aValue : (aValue - Offset[aValue])] = true;
+		}
+	}
+
+	//----------------------------------------------------------------
+	///Label every line start that has a user label or that an operand
+	/// or address table refers to
+	void Reference(  )
+	{
+		for ( const auto &range : rJob.Ranges ) {
+			for ( uint32_t addr = range.Start; addr <= range.End; ++addr) {
+				if (QLineStart(static_cast<uint16_t>(addr)) && UserLabel(static_cast<uint16_t>(addr))) {
+					Labelled[addr] = true;
+				}
+				if (Words[addr]) {
+					Refer(pImage[addr] | (pImage[addr + 1] << 8));
+				}
+				else if ((Offset[addr] == 0) && TemplateA[static_cast<uint32_t>(Op(addr).eMode)].bAddress) {
+					Refer(Operand(addr));
+				}
+			}
+		}
+		std::sort(Externals.begin(), Externals.end());
+		Externals.erase(std::unique(Externals.begin(), Externals.end()), Externals.end());
+	}
+
+	//----------------------------------------------------------------
+	///Write a user label with anything KickAssembler won't take as '_'
+	char *AddUserLabel( char *apDest, const char *apLabel ) const
+	{
+		if ((*apLabel >= '0') && (*apLabel <= '9')) {
+			*apDest++ = '_';
+		}
+		for ( uint32_t i = 0; *apLabel && (i < NAMEMAX); ++i, ++apLabel) {
+			const char c = *apLabel;
+			*apDest++ = (isalnum(static_cast<uint8_t>(c)) || (c == '_')) ? c : '_';
+		}
+		return apDest;
+	}
+
+	//----------------------------------------------------------------
+	///Write the name of the label for a line start
+	char *AddLineLabel( char *apDest, uint16_t aAddress ) const
+	{
+		if (const char *plabel = UserLabel(aAddress); plabel) {
+			return AddUserLabel(apDest, plabel);
+		}
+		*apDest++ = 'L';
+		apDest = AddHex(apDest, static_cast<uint8_t>(aAddress >> 8));
+		return AddHex(apDest, static_cast<uint8_t>(aAddress));
+	}
+
+	//----------------------------------------------------------------
+	///Write an operand value as a label, label plus offset or hex
+	char *AddValue( char *apDest, uint16_t aValue, uint8_t aDigits ) const
+	{
+		if (const char *plabel = UserLabel(aValue); plabel) {
+			return AddUserLabel(apDest, plabel);
+		}
+		if (InRange[aValue]) {
+			if (Offset[aValue] == DATA) {
+				return AddLineLabel(apDest, aValue);
+			}
+			apDest = AddLineLabel(apDest, static_cast<uint16_t>(aValue - Offset[aValue]));
+			if (Offset[aValue]) {
+				*apDest++ = '+';
+				*apDest++ = static_cast<char>('0' + Offset[aValue]);
+			}
+			return apDest;
+		}
+		*apDest++ = '$';
+		if (aDigits == 4) {
+			apDest = AddHex(apDest, static_cast<uint8_t>(aValue >> 8));
+		}
+		return AddHex(apDest, static_cast<uint8_t>(aValue));
+	}
+
+	//----------------------------------------------------------------
+	///Get room in the buffer for a line, handing on what's there if full
+	char *Line(  )
+	{
+		if ((Used + LINEMAX) > BUFFERSIZE) {
+			Flush();
+		}
+		return &Buffer[Used];
+	}
+
+	//----------------------------------------------------------------
+	///Keep the line built at the end of the buffer
+	void EndLine( char *apEnd )
+	{
+		*apEnd++ = '\n';
+		Used = static_cast<uint32_t>(apEnd - Buffer);
+	}
+
+	//----------------------------------------------------------------
+	void Flush(  )
+	{
+		if (Used) {
+			rOut(Buffer, Used);
+			Used = 0;
+		}
+	}
+
+	//----------------------------------------------------------------
+	///Write the instruction line at an address
+	void EmitInstruction( uint16_t aAddress )
+	{
+		const OpCode &rop = Op(aAddress);
+		const Template &rtemp = TemplateA[static_cast<uint32_t>(rop.eMode)];
+		char *pline = Line();
+		*pline++ = '\t';
+		//Assemblers disagree on the names of undocumented opcodes and some
+		// share a name and mode with a documented one, so write their bytes
+		// and show the instruction in a comment
+		if (rop.bUndocumented) {
+			pline = AddStr(pline, ".byte ");
+			for ( uint32_t i = 0; i < rop.QSize(); ++i) {
+				if (i) {
+					*pline++ = ',';
+				}
+				*pline++ = '$';
+				pline = AddHex(pline, pImage[(aAddress + i) & 0xffff]);
+			}
+			pline = AddStr(pline, "\t// ");
+		}
+		for ( uint32_t i = 0; i < 3; ++i) {
+			*pline++ = static_cast<char>(tolower(static_cast<uint8_t>(rop.pName[i])));
+		}
+
+		if (rtemp.Digits) {
+			const uint16_t value = Operand(aAddress);
+			//Absolute modes with a zero page value would assemble shorter
+			if ((rop.QSize() == 3) && (value < 0x100)) {
+				pline = AddStr(pline, ".abs");
+			}
+			*pline++ = ' ';
+			pline = AddStr(pline, rtemp.pPrefix);
+			if (rtemp.bAddress) {
+				pline = AddValue(pline, value, rtemp.Digits);
+			}
+			else {
+				pline = AddHex(pline, static_cast<uint8_t>(value));
+			}
+			pline = AddStr(pline, rtemp.pSuffix);
+		}
+		EndLine(pline);
+	}
+
+	//----------------------------------------------------------------
+	///Write up to LINEWORDS table entries from an address, stopping at
+	/// the end of the table or a label. Return the number of bytes written
+	uint32_t EmitWords( uint32_t aAddress )
+	{
+		char *pline = AddStr(Line(), "\t.word ");
+		uint32_t count = 0;
+		do {
+			if (count) {
+				*pline++ = ',';
+				*pline++ = ' ';
+			}
+			const uint32_t addr = aAddress + count;
+			pline = AddValue(pline, static_cast<uint16_t>(pImage[addr] | (pImage[addr + 1] << 8)), 4);
+			count += 2;
+		} while ((count < (LINEWORDS * 2)) && ((aAddress + count) < IMAGESIZE) && Words[aAddress + count]
+			&& !Labelled[aAddress + count]);
+		EndLine(pline);
+		return count;
+	}
+
+	//----------------------------------------------------------------
+	///Write up to LINEBYTES data bytes from an address, stopping at the
+	/// next line that starts an instruction or has a label and where the
+	/// map's type changes. Text is repeated in a comment. Return the
+	/// number of bytes written
+	uint32_t EmitData( uint32_t aAddress, uint32_t aEnd )
+	{
+		const Regions::Run run = Types.QRun(static_cast<uint16_t>(aAddress));
+		aEnd = std::min<uint32_t>(aEnd, run.End);
+
+		char *pline = AddStr(Line(), "\t.byte ");
+		uint32_t count = 0;
+		do {
+			if (count) {
+				*pline++ = ',';
+			}
+			*pline++ = '$';
+			pline = AddHex(pline, pImage[aAddress + count]);
+			++count;
+		} while ((count < LINEBYTES) && ((aAddress + count) <= aEnd)
+			&& (Offset[aAddress + count] != 0) && !Labelled[aAddress + count]);
+
+		if (run.Type == Regions::TYPE::TEXT) {
+			pline = AddStr(pline, "\t// \"");
+			for ( uint32_t i = 0; i < count; ++i) {
+				//Shifted letters show as capitals too
+				const uint8_t c = pImage[aAddress + i];
+				*pline++ = ((c >= 0x20) && (c <= 0x5f)) ? static_cast<char>(c)
+					: ((c >= 0xc1) && (c <= 0xda)) ? static_cast<char>(c - 0x80) : '.';
+			}
+			*pline++ = '"';
+		}
+		EndLine(pline);
+		return count;
+	}
+
+	//----------------------------------------------------------------
+	void Emit(  )
+	{
+		EndLine(AddStr(Line(), "// Disassembled by c64debugger"));
+
+		//Labels out of the ranges or inside instructions
+		if (!Externals.empty()) {
+			EndLine(Line());
+		}
+		for ( auto value : Externals ) {
+			char *pline = AddStr(Line(), ".label ");
+			pline = AddUserLabel(pline, UserLabel(value));
+			pline = AddStr(pline, " = $");
+			pline = AddHex(pline, static_cast<uint8_t>(value >> 8));
+			EndLine(AddHex(pline, static_cast<uint8_t>(value)));
+		}
+
+		uint32_t next = IMAGESIZE + 1;			//Address following the last range
+		for ( const auto &range : rJob.Ranges ) {
+			if (range.Start != next) {
+				EndLine(Line());
+				char *pline = AddStr(Line(), "* = $");
+				pline = AddHex(pline, static_cast<uint8_t>(range.Start >> 8));
+				EndLine(AddHex(pline, static_cast<uint8_t>(range.Start)));
+			}
+
+			for ( uint32_t addr = range.Start; addr <= range.End; ) {
+				if (Labelled[addr]) {
+					char *pline = AddLineLabel(Line(), static_cast<uint16_t>(addr));
+					*pline++ = ':';
+					EndLine(pline);
+				}
+				if (Words[addr]) {
+					addr += EmitWords(addr);
+				}
+				else if (Offset[addr] == 0) {
+					EmitInstruction(static_cast<uint16_t>(addr));
+					addr += Op(addr).QSize();
+				}
+				else {
+					addr += EmitData(addr, range.End);
+				}
+			}
+			next = range.End + 1;
+		}
+		Flush();
+	}
+};
+
+//----------------------------------------------------------------
+void Write( const Job &arJob, const OUTFN &aOut )
+{
+	auto pwriter = std::make_unique<Writer>(arJob, aOut);	//Too big for the stack
+	pwriter->Run();
+}
+
+//----------------------------------------------------------------
+bool DisassemblePrg( const std::filesystem::path &arPath )
+{
+	std::ifstream file(arPath, std::ios::binary);
+	const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	if (data.size() < 3) {
+		return false;
+	}
+
+	const uint32_t load = data[0] | (data[1] << 8);
+	const uint32_t size = std::min<uint32_t>(static_cast<uint32_t>(data.size()) - 2, IMAGESIZE - load);
+	auto pimage = std::make_unique<uint8_t[]>(IMAGESIZE);
+	memcpy(&pimage[load], &data[2], size);
+
+	Labels::LabelMap labels;
+	auto path = arPath;
+	Labels::Read(path.replace_extension(".vs"), labels);
+
+	Job job;
+	job.pImage = pimage.get();
+	job.Ranges.push_back({ static_cast<uint16_t>(load), static_cast<uint16_t>(load + size - 1), "" });
+	if (const uint32_t start = Program::FindStart(data.data(), static_cast<uint32_t>(data.size())); start < IMAGESIZE) {
+		job.Entries.push_back(static_cast<uint16_t>(start));
+	}
+	for ( const auto &[value, name] : labels ) {
+		if (Flow::QEntryLabel(value)) {
+			job.Entries.push_back(value);
+		}
+	}
+	job.FindLabel = [&]( uint16_t aAddress ) -> const char * {
+		const auto it = labels.find(aAddress);
+		return (it != labels.end()) ? it->second.c_str() : nullptr;
+	};
+
+	std::ofstream out(path.replace_extension(".asm"));
+	if (!out.is_open()) {
+		return false;
+	}
+	Write(job, [&]( const char *apText, uint32_t aSize ) { out.write(apText, aSize); });
+	return out.good();
+}
+
+//----------------------------------------------------------------
+uint32_t Batch( const std::vector<std::filesystem::path> &arPaths, uint32_t aThreads )
+{
+	std::vector<std::filesystem::path> files;
+	for ( const auto &path : arPaths ) {
+		std::error_code error;
+		if (std::filesystem::is_directory(path, error)) {
+			for ( const auto &entry : std::filesystem::directory_iterator(path, error) ) {
+				if (entry.is_regular_file() && !_stricmp(entry.path().extension().string().c_str(), ".prg")) {
+					files.push_back(entry.path());
+				}
+			}
+		}
+		else {
+			files.push_back(path);
+		}
+	}
+
+	//Each thread takes the next file until there are none left
+	std::atomic<size_t> next = 0;
+	std::atomic<uint32_t> failed = 0;
+	auto runner = [&](  ) {
+		for ( size_t i = next++; i < files.size(); i = next++) {
+			if (!DisassemblePrg(files[i])) {
+				++failed;
+				fprintf(stderr, "Failed disassembling %s\n", files[i].string().c_str());
+			}
+		}
+	};
+
+	uint32_t threads = aThreads ? aThreads : std::max(std::thread::hardware_concurrency(), 1u);
+	threads = std::min<uint32_t>(threads, static_cast<uint32_t>(files.size()));
+	std::vector<std::thread> pool;
+	for ( uint32_t i = 0; i < threads; ++i) {
+		pool.emplace_back(runner);
+	}
+	for ( auto &thread : pool ) {
+		thread.join();
+	}
+	return failed;
+}
+
+}	//namespace Source
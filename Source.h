@@ -0,0 +1,86 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Source.h
+//----------------------------------------------------------------------
+
+#pragma once
+
+#include "types.h"
+#include "Export.h"
+#include "Regions.h"
+
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+///Disassembly of memory ranges to KickAssembler source that assembles
+/// back to the same bytes. Code is found by walking from known entry
+/// points with Flow, everything else in the ranges is written as
+/// ".byte" lines, or ".word" for address tables, following a Regions
+/// map. Lines restart at entry points, so an instruction that would run
+/// over one is written as bytes instead. Branch, jump and data targets
+/// inside the ranges get a label if they have none, and labels used
+/// from outside the ranges are defined with ".label".
+namespace Source
+{
+
+//Label for an address or nullptr if none
+using LABELFN = std::function<const char *( uint16_t aAddress )>;
+//Receives the text as it is made
+using OUTFN = std::function<void ( const char *apText, uint32_t aSize )>;
+
+//----------------------------------------------------------------
+///Everything to disassemble
+struct Job
+{
+	const uint8_t *pImage = nullptr;			//64K image holding the bytes of the ranges
+	Export::RangeList Ranges;					//Written in the order given
+	std::vector<uint16_t> Entries;				//Known code entry points
+	LABELFN FindLabel;							//Optional names for addresses
+	const Regions::Map *pRegions = nullptr;		//Code and data, classified from what Flow finds if nullptr
+};
+
+//----------------------------------------------------------------
+///Write the job as KickAssembler source through aOut in buffer sized
+/// chunks. Safe to run on several threads at once
+void Write( const Job &arJob, const OUTFN &aOut );
+
+//----------------------------------------------------------------
+///Disassemble one .prg file to a .asm file of the same name, using the
+/// labels in its .vs file if there is one. Code is walked from the SYS
+/// address or load address and the labels. Return false on error
+bool DisassemblePrg( const std::filesystem::path &arPath );
+
+//----------------------------------------------------------------
+///Disassemble .prg files on aThreads threads, or one per core if 0.
+/// A directory stands for the .prg files in it. Errors are reported on
+/// stderr. Return the number of files that failed
+uint32_t Batch( const std::vector<std::filesystem::path> &arPaths, uint32_t aThreads = 0 );
+
+}	//namespace Source
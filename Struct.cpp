@@ -0,0 +1,290 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Struct.cpp
+//----------------------------------------------------------------------
+
+#include "Struct.h"
+#include "Labels.h"
+
+#include <cctype>
+#include <sstream>
+
+namespace Struct
+{
+
+constexpr uint32_t MAXROWS = 0x100;
+constexpr uint32_t MAXCOUNT = 0x20;				//Maximum array elements per row
+
+//----------------------------------------------------------------
+///Parse a type name with optional [count] into the field
+bool ParseType( const std::string &arType, Field &arField )
+{
+	std::string name = arType;
+	if (auto bracket = name.find('['); bracket != std::string::npos) {
+		arField.Count = static_cast<uint32_t>(atoi(name.c_str() + bracket + 1));
+		if (!arField.Count || (arField.Count > MAXCOUNT) || (name.back() != ']')) {
+			return false;
+		}
+		name.resize(bracket);
+	}
+
+	if (name == "byte") {
+		arField.Type = TYPE::BYTE;
+		arField.Size = 1;
+	}
+	else if (name == "sbyte") {
+		arField.Type = TYPE::SBYTE;
+		arField.Size = 1;
+	}
+	else if (name == "word") {
+		arField.Type = TYPE::WORD;
+		arField.Size = 2;
+	}
+	else if (name == "ptr") {
+		arField.Type = TYPE::PTR;
+		arField.Size = 2;
+	}
+	else if (name == "lohi") {
+		arField.Type = TYPE::LOHI;
+		arField.Size = 1;						//1 byte in each table
+		return arField.Count == 1;
+	}
+	else if (!name.compare(0, 3, "fix") || !name.compare(0, 4, "sfix")) {
+		const bool sign = (name[0] == 's');
+		uint32_t integer = 0;
+		if (sscanf_s(name.c_str() + (sign ? 4 : 3), "%u.%u", &integer, &arField.Fraction) != 2) {
+			return false;
+		}
+		if ((integer + arField.Fraction != 8) && (integer + arField.Fraction != 16)) {
+			return false;
+		}
+		arField.Type = sign ? TYPE::SFIXED : TYPE::FIXED;
+		arField.Size = (integer + arField.Fraction) / 8;
+	}
+	else {
+		return false;
+	}
+	return true;
+}
+
+//----------------------------------------------------------------
+bool Layout::Parse( std::string &arError )
+{
+	Fields.clear();
+	Rows = 1;
+	Stride = 0;
+
+	std::istringstream strm(Text);
+	std::string line;
+	uint32_t lineNum = 0;
+	while (std::getline(strm, line)) {
+		++lineNum;
+		if (auto comment = line.find('#'); comment != std::string::npos) {
+			line.resize(comment);
+		}
+
+		std::istringstream words(line);
+		std::string first, second, third;
+		words >> first >> second >> third;
+		if (first.empty()) {
+			continue;
+		}
+
+		bool good = false;
+		if (first == "rows") {
+			Rows = static_cast<uint32_t>(atoi(second.c_str()));
+			good = Rows && (Rows <= MAXROWS);
+		}
+		else if (first == "stride") {
+			Stride = static_cast<uint32_t>(atoi(second.c_str()));
+			good = Stride && (Stride <= 0x100);
+		}
+		else if (!third.empty()) {
+			Field field;
+			field.Name = first;
+			if (good = ParseType(second, field); good) {
+				if (field.Type == TYPE::LOHI) {
+					auto slash = third.find('/');
+					good = (slash != std::string::npos);
+					if (good) {
+						field.Location = third.substr(0, slash);
+						field.HiLocation = third.substr(slash + 1);
+					}
+				}
+				else {
+					field.Location = third;
+				}
+			}
+			if (good) {
+				Fields.push_back(std::move(field));
+			}
+		}
+
+		if (!good) {
+			arError = "Line " + std::to_string(lineNum) + ": " + line;
+			return false;
+		}
+	}
+
+	if (Fields.empty()) {
+		arError = "No fields";
+		return false;
+	}
+	return true;
+}
+
+//----------------------------------------------------------------
+bool Layout::Resolve( std::vector<Address> &arBases ) const
+{
+	bool bres = true;
+	std::vector<Address> bases(Fields.size());
+	for ( size_t i = 0; i < Fields.size(); ++i) {
+		bres &= Struct::Resolve(Fields[i].Location, bases[i].Lo);
+		if (Fields[i].Type == TYPE::LOHI) {
+			bres &= Struct::Resolve(Fields[i].HiLocation, bases[i].Hi);
+		}
+	}
+	if (bres) {
+		arBases.swap(bases);
+	}
+	return bres;
+}
+
+//----------------------------------------------------------------
+Address Layout::Locate( const Field &arField, const Address &arBase, uint32_t aRow ) const
+{
+	Address addr;
+	if (arField.Type == TYPE::LOHI) {
+		const uint32_t step = Stride ? Stride : 1;
+		addr.Lo = static_cast<uint16_t>(arBase.Lo + (aRow * step));
+		addr.Hi = static_cast<uint16_t>(arBase.Hi + (aRow * step));
+	}
+	else {
+		addr.Lo = static_cast<uint16_t>(arBase.Lo + (aRow * (Stride ? Stride : arField.QRowSize())));
+	}
+	return addr;
+}
+
+//----------------------------------------------------------------
+bool Resolve( const std::string &arLocation, uint16_t &arAddress )
+{
+	std::string base = arLocation;
+	uint32_t offset = 0;
+	if (auto plus = base.find('+'); plus != std::string::npos) {
+		offset = static_cast<uint32_t>(strtoul(base.c_str() + plus + 1, nullptr, 16));
+		base.resize(plus);
+	}
+
+	if (base.empty()) {
+		return false;
+	}
+	if (base[0] == '$') {
+		if ((base.size() < 2) || (base.size() > 5)) {
+			return false;
+		}
+		for ( size_t i = 1; i < base.size(); ++i) {
+			if (!isxdigit(static_cast<uint8_t>(base[i]))) {
+				return false;
+			}
+		}
+		arAddress = static_cast<uint16_t>(strtoul(base.c_str() + 1, nullptr, 16));
+	}
+	else if (!Labels::Find(base.c_str(), arAddress)) {
+		return false;
+	}
+	arAddress = static_cast<uint16_t>(arAddress + offset);
+	return true;
+}
+
+//----------------------------------------------------------------
+uint32_t Format( const Field &arField, const Address &arAddress, const uint8_t *apImage
+	, char *apDest, uint32_t aDestLen )
+{
+	int32_t written = 0;
+	uint16_t addr = arAddress.Lo;
+
+	//Read little endian value of the field size and step to the next
+	auto read = [&](  ) {
+		uint32_t value = apImage[addr];
+		if (arField.Size == 2) {
+			value |= apImage[static_cast<uint16_t>(addr + 1)] << 8;
+		}
+		addr = static_cast<uint16_t>(addr + arField.Size);
+		return value;
+	};
+
+	for ( uint32_t i = 0; (i < arField.Count) && (static_cast<uint32_t>(written) + 1 < aDestLen); ++i) {
+		char *pdest = apDest + written;
+		const uint32_t left = aDestLen - written;
+		const char *psep = i ? " " : "";
+		int32_t len = 0;
+		switch (arField.Type) {
+			case TYPE::BYTE:
+				len = snprintf(pdest, left, "%s%02X", psep, read());
+				break;
+			case TYPE::SBYTE:
+				len = snprintf(pdest, left, "%s%d", psep, static_cast<int8_t>(read()));
+				break;
+			case TYPE::WORD:
+				len = snprintf(pdest, left, "%s%04X", psep, read());
+				break;
+			case TYPE::PTR:
+			{
+				const auto value = static_cast<uint16_t>(read());
+				const char *plabel = Labels::Find(value);
+				len = snprintf(pdest, left, "%s%04X%s%s", psep, value, plabel ? " " : "", plabel ? plabel : "");
+				break;
+			}
+			case TYPE::FIXED:
+				len = snprintf(pdest, left, "%s%.3f", psep, static_cast<double>(read()) / (1 << arField.Fraction));
+				break;
+			case TYPE::SFIXED:
+			{
+				auto value = static_cast<int32_t>(read());
+				if (value & (1 << ((arField.Size * 8) - 1))) {
+					value -= 1 << (arField.Size * 8);	//Sign extend
+				}
+				len = snprintf(pdest, left, "%s%.3f", psep, static_cast<double>(value) / (1 << arField.Fraction));
+				break;
+			}
+			case TYPE::LOHI:
+				len = snprintf(pdest, left, "%s%04X", psep, apImage[arAddress.Lo] | (apImage[arAddress.Hi] << 8));
+				break;
+			default:
+				break;
+		}
+		written += len > 0 ? len : 0;
+	}
+	if (static_cast<uint32_t>(written) >= aDestLen) {
+		written = static_cast<int32_t>(aDestLen) - 1;	//Truncated
+	}
+	return static_cast<uint32_t>(written);
+}
+
+}	//namespace Struct
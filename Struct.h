@@ -0,0 +1,125 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Struct.h
+//----------------------------------------------------------------------
+
+#pragma once
+
+#include "types.h"
+
+#include <string>
+#include <vector>
+
+///Typed layouts of memory tables. A layout is declared as text, one
+/// statement per line, '#' starts a comment:
+///  rows 32               Number of rows (objects) in the table
+///  stride 8              Bytes per row for interleaved tables. Without
+///                        it each field is its own array
+///  name type location    A field
+/// Types are byte, sbyte, word, ptr, fixI.F (unsigned fixed point with I
+/// integer and F fraction bits, I + F is 8 or 16), sfixI.F (signed) and
+/// lohi (16 bit value split in a lo and a hi table). Any type but lohi
+/// may be an array per row, ie: byte[4].
+/// Locations are a label or $hex with an optional +hex offset, lohi
+/// fields have two separated by '/', ie: xlo/xhi
+namespace Struct
+{
+
+//----------------------------------------------------------------
+enum class TYPE : uint8_t
+{
+	BYTE,
+	SBYTE,
+	WORD,
+	PTR,
+	FIXED,
+	SFIXED,
+	LOHI
+};
+
+//----------------------------------------------------------------
+struct Field
+{
+	std::string Name;
+	std::string Location;						//Base, or lo table for LOHI
+	std::string HiLocation;						//Hi table for LOHI
+	TYPE Type = TYPE::BYTE;
+	uint32_t Count = 1;							//Elements per row
+	uint32_t Size = 1;							//Bytes per element
+	uint32_t Fraction = 0;						//Fraction bits of fixed point
+
+	//----------------------------------------------------------------
+	///Bytes the field takes in a row
+	uint32_t QRowSize(  ) const { return Count * Size; }
+};
+
+//----------------------------------------------------------------
+///Address of a field element for one row, Hi is only used by LOHI
+struct Address
+{
+	uint16_t Lo = 0;
+	uint16_t Hi = 0;
+};
+
+//----------------------------------------------------------------
+struct Layout
+{
+	std::string Name;
+	std::string Text;							//Source the layout was parsed from
+	std::vector<Field> Fields;
+	uint32_t Rows = 1;
+	uint32_t Stride = 0;						//0 if each field is its own array
+
+	//----------------------------------------------------------------
+	///Parse layout from Text. On error arError is set to the problem
+	/// and the line it was found on
+	bool Parse( std::string &arError );
+
+	//----------------------------------------------------------------
+	///Resolve the location of each field to its row 0 address. Return
+	/// false if any doesn't resolve, leaving arBases as it was
+	bool Resolve( std::vector<Address> &arBases ) const;
+
+	//----------------------------------------------------------------
+	///Get address of a field in a row from its row 0 address
+	Address Locate( const Field &arField, const Address &arBase, uint32_t aRow ) const;
+};
+
+//----------------------------------------------------------------
+///Resolve a location: label or $hex with optional +hex offset.
+/// Return false if it doesn't resolve
+bool Resolve( const std::string &arLocation, uint16_t &arAddress );
+
+//----------------------------------------------------------------
+///Format field value for a row from the 64K image apImage into apDest.
+/// Return number of chars written
+uint32_t Format( const Field &arField, const Address &arAddress, const uint8_t *apImage
+	, char *apDest, uint32_t aDestLen );
+
+}	//namespace Struct
@@ -0,0 +1,388 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    StructView.cpp
+//----------------------------------------------------------------------
+
+#include "StructView.h"
+#include "Banks.h"
+#include "Command.h"
+#include "Monitor.h"
+#include "Response.h"
+#include "Shadow.h"
+#include "Struct.h"
+
+#include <algorithm>
+#include <imgui.h>
+#include <vector>
+
+namespace StructView
+{
+
+//Responses must be < 0x200 bytes (Response::LooksGood), leave room for the header
+constexpr uint32_t MAXREQUEST = 0x1e0;			//Largest memory request
+constexpr uint32_t MAXREQUESTS = 8;				//Requests per refresh
+constexpr uint32_t CELLLEN = 64;				//Longest formatted field
+
+constexpr char DEFLAYOUT[] =
+	"# Sprite positions, VIC registers are interleaved x/y\n"
+	"rows 8\n"
+	"stride 2\n"
+	"x byte $d000\n"
+	"y byte $d001\n";
+
+//----------------------------------------------------------------
+///Inclusive address range
+struct Span
+{
+	uint32_t Start;
+	uint32_t End;
+};
+
+bool Enabled = false;							//Window enabled
+bool Continuous = true;							//Refresh while running
+bool Editing = false;							//Showing layout text editor
+bool Dirty = true;								//Need to ask for memory
+int32_t Selected = -1;							//Layout shown
+std::vector<Struct::Layout> Layouts;
+std::vector<Struct::Address> Bases;				//Row 0 address of each field
+Banks::Space Space = Banks::MAIN;
+CommandPtr RequestA[MAXREQUESTS];				//Commands, created on first use
+uint16_t RequestStartA[MAXREQUESTS];			//Start address of each request
+uint32_t Outstanding = 0;						//Requests waiting on a response
+uint32_t FirstRow = 0;							//Rows visible last frame
+uint32_t LastRow = 0;
+VICESTATE LastState = VICESTATE::DISCONNECTED;
+char EditName[32] = "";
+char EditText[0x800] = "";
+char Error[128] = "";
+
+//----------------------------------------------------------------
+///Send one MEMORY_GET for an inclusive range
+void Request( uint32_t aStart, uint32_t aEnd )
+{
+	auto &pcommand = RequestA[Outstanding];
+	if (!pcommand) {
+		pcommand = CommandPtr(new Command(COMMAND::MEMORY_GET));
+	}
+	pcommand->Reset();
+	pcommand->Add(0_u8);						//No side effects
+	pcommand->Add(static_cast<uint16_t>(aStart));
+	pcommand->Add(static_cast<uint16_t>(aEnd));
+	pcommand->Add(Banks::QMemspace(Space));
+	pcommand->Add(Banks::QBank(Space));
+	Monitor::Send(pcommand);
+	RequestStartA[Outstanding++] = static_cast<uint16_t>(aStart);
+}
+
+//----------------------------------------------------------------
+///Ask for the memory of every field in the visible rows. Field spans
+/// are merged so a whole table normally comes back in one response
+void Refresh(  )
+{
+	if (Outstanding || (Selected < 0)) return;
+
+	const auto &layout = Layouts[Selected];
+	if (!layout.Resolve(Bases)) {
+		Bases.clear();							//Don't show rows from where it was before
+		snprintf(Error, sizeof(Error), "Location not found");
+		return;
+	}
+
+	//Span covering each field (and hi table) over the visible rows
+	std::vector<Span> spans;
+	for ( size_t i = 0; i < layout.Fields.size(); ++i) {
+		const auto &field = layout.Fields[i];
+		const auto first = layout.Locate(field, Bases[i], FirstRow);
+		const auto last = layout.Locate(field, Bases[i], LastRow);
+		const uint32_t size = (field.Type == Struct::TYPE::LOHI) ? 1 : field.QRowSize();
+		spans.push_back({ first.Lo, std::min<uint32_t>(std::max(first.Lo, last.Lo) + size - 1, 0xffff) });
+		if (field.Type == Struct::TYPE::LOHI) {
+			spans.push_back({ first.Hi, std::max(first.Hi, last.Hi) });
+		}
+	}
+	std::sort(spans.begin(), spans.end(), []( const Span &a, const Span &b ) { return a.Start < b.Start; });
+
+	//Grow each request while the hull stays small enough for one response
+	std::vector<Span> requests;
+	for ( const auto &span : spans ) {
+		if (!requests.empty()) {
+			auto &last = requests.back();
+			const uint32_t end = std::max(last.End, span.End);
+			if (end - last.Start < MAXREQUEST) {
+				last.End = end;
+				continue;
+			}
+		}
+		//Start a new request, splitting spans too large for one
+		for ( uint32_t start = span.Start; start <= span.End; start += MAXREQUEST) {
+			requests.push_back({ start, std::min(start + MAXREQUEST - 1, span.End) });
+		}
+	}
+
+	for ( const auto &request : requests ) {
+		if (Outstanding < MAXREQUESTS) {
+			Request(request.Start, request.End);
+		}
+		else {
+			//Very scattered layout, let the Shadow fetch the rest by page
+			Shadow::Invalidate(static_cast<uint16_t>(request.Start), static_cast<uint16_t>(request.End), Space);
+			Shadow::Fetch(static_cast<uint16_t>(request.Start), static_cast<uint16_t>(request.End), Space);
+		}
+	}
+	Error[0] = 0;
+	Dirty = false;
+}
+
+//----------------------------------------------------------------
+///Show layout text in the editor
+void Edit( int32_t aLayout )
+{
+	Selected = aLayout;
+	if (Selected >= 0) {
+		snprintf(EditName, sizeof(EditName), "%s", Layouts[Selected].Name.c_str());
+		snprintf(EditText, sizeof(EditText), "%s", Layouts[Selected].Text.c_str());
+	}
+	Dirty = true;
+}
+
+//----------------------------------------------------------------
+///Parse editor text into the selected layout
+void Apply(  )
+{
+	if (Selected >= 0) {
+		Struct::Layout layout;
+		layout.Name = EditName;
+		layout.Text = EditText;
+		std::string error;
+		if (layout.Parse(error)) {
+			Layouts[Selected] = std::move(layout);
+			Error[0] = 0;
+			Dirty = true;
+		}
+		else {
+			snprintf(Error, sizeof(Error), "%s", error.c_str());
+		}
+	}
+}
+
+//----------------------------------------------------------------
+void ToJson( nlohmann::json &arData )
+{
+	auto layouts = nlohmann::json::array();
+	for ( const auto &layout : Layouts ) {
+		layouts.push_back({ {"Name", layout.Name}, {"Text", layout.Text} });
+	}
+	arData["Structs"] = {
+		{"On", Enabled},
+		{"Continuous", Continuous},
+		{"Selected", Selected},
+		{"Space", Space},
+		{"Layouts", layouts}
+	};
+}
+
+//----------------------------------------------------------------
+void FromJson( nlohmann::json &arData )
+{
+	auto obj = arData["Structs"];
+	if (!obj.is_null()) {
+		Enabled = obj["On"];
+		Continuous = obj["Continuous"];
+		Space = obj["Space"];
+		Layouts.clear();
+		for ( auto &entry : obj["Layouts"] ) {
+			Struct::Layout layout;
+			layout.Name = entry["Name"];
+			layout.Text = entry["Text"];
+			std::string error;
+			layout.Parse(error);				//Labels may not be loaded yet, so they resolve later
+			Layouts.push_back(std::move(layout));
+		}
+		Edit(std::min(obj["Selected"].get<int32_t>(), static_cast<int32_t>(Layouts.size()) - 1));
+	}
+}
+
+//----------------------------------------------------------------
+bool FromResponse( const Response &arResponse )
+{
+	for ( uint32_t i = 0; i < MAXREQUESTS; ++i) {
+		if (RequestA[i] && (RequestA[i]->QID() == arResponse.QID())) {
+			uint16_t size = arResponse.Get16(0);
+			Shadow::Store(RequestStartA[i], arResponse.QBody() + 2, size, Space);
+			if (Outstanding) {
+				--Outstanding;
+			}
+			//While running ask again once the last of the data is in
+			Dirty |= !Outstanding && Continuous && (Monitor::ViceState() == VICESTATE::RUNNING);
+			return true;
+		}
+	}
+	return false;
+}
+
+//----------------------------------------------------------------
+void DisplayOn(  )
+{
+	Enabled = true;
+}
+
+//----------------------------------------------------------------
+void Display(  )
+{
+	if (!Enabled) return;						//Early out if view not visible
+
+	//Memory changes whenever VICE has run
+	const auto state = Monitor::ViceState();
+	if (state != LastState) {
+		Dirty |= (state == VICESTATE::STOPPED) || (Continuous && (state == VICESTATE::RUNNING));
+		if (state == VICESTATE::DISCONNECTED) {
+			Outstanding = 0;					//Responses won't come
+		}
+		LastState = state;
+	}
+	if (Dirty && (state != VICESTATE::DISCONNECTED)) {
+		Refresh();
+	}
+
+	ImGui::SetNextWindowSize(ImVec2(400, 360), ImGuiCond_FirstUseEver);
+	ImGui::Begin("Structs", &Enabled);
+
+	const float w = ImGui::GetFontSize();
+
+	//Layout picker and management
+	ImGui::PushItemWidth(w * 8.0f);
+	if (ImGui::BeginCombo("##Layout", Selected >= 0 ? Layouts[Selected].Name.c_str() : "")) {
+		for ( int32_t i = 0; i < static_cast<int32_t>(Layouts.size()); ++i) {
+			ImGui::PushID(i);
+			if (ImGui::Selectable(Layouts[i].Name.c_str(), i == Selected)) {
+				Edit(i);
+			}
+			ImGui::PopID();
+		}
+		ImGui::EndCombo();
+	}
+	ImGui::PopItemWidth();
+	ImGui::SameLine();
+	if (ImGui::Button("New")) {
+		Struct::Layout layout;
+		layout.Name = "Layout " + std::to_string(Layouts.size() + 1);
+		layout.Text = DEFLAYOUT;
+		std::string error;
+		layout.Parse(error);
+		Layouts.push_back(std::move(layout));
+		Edit(static_cast<int32_t>(Layouts.size()) - 1);
+		Editing = true;
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Delete") && (Selected >= 0)) {
+		Layouts.erase(Layouts.begin() + Selected);
+		Edit(std::min<int32_t>(Selected, static_cast<int32_t>(Layouts.size()) - 1));
+	}
+	ImGui::SameLine();
+	ImGui::Checkbox("Edit", &Editing);
+	ImGui::SameLine();
+	ImGui::Checkbox("Continuous", &Continuous);
+	ImGui::SameLine();
+	if (Banks::Combo("##Space", Space)) {
+		Dirty = true;
+	}
+
+	if (Error[0]) {
+		ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%s", Error);
+	}
+
+	if (Editing && (Selected >= 0)) {
+		ImGui::PushItemWidth(w * 8.0f);
+		ImGui::InputText("##Name", EditName, sizeof(EditName));
+		ImGui::PopItemWidth();
+		ImGui::SameLine();
+		if (ImGui::Button("Apply")) {
+			Apply();
+		}
+		ImGui::InputTextMultiline("##Text", EditText, sizeof(EditText), ImVec2(-FLT_MIN, w * 8.0f));
+		if (ImGui::IsItemHovered()) {
+			ImGui::SetTooltip("rows n, stride n, then: name type location\n"
+				"types: byte sbyte word ptr fixI.F sfixI.F lohi, type[n] for arrays\n"
+				"location: label or $hex, +hex offset, lohi uses lo/hi");
+		}
+	}
+
+	//Table of rows, only the visible rows are asked for
+	if ((Selected >= 0) && !Layouts[Selected].Fields.empty()) {
+		const auto &layout = Layouts[Selected];
+		const int32_t columns = static_cast<int32_t>(layout.Fields.size()) + 1;
+		if (ImGui::BeginTable("##Rows", columns, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg
+			| ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable)) {
+			ImGui::TableSetupScrollFreeze(0, 1);
+			ImGui::TableSetupColumn("#");
+			for ( const auto &field : layout.Fields ) {
+				ImGui::TableSetupColumn(field.Name.c_str());
+			}
+			ImGui::TableHeadersRow();
+
+			const bool resolved = (Bases.size() == layout.Fields.size());
+			const uint8_t *pimage = Shadow::QImage(Space);
+			uint32_t first = layout.Rows;
+			uint32_t last = 0;
+			ImGuiListClipper clipper;
+			clipper.Begin(static_cast<int32_t>(layout.Rows));
+			while (clipper.Step()) {
+				for ( int32_t row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+					first = std::min(first, static_cast<uint32_t>(row));
+					last = std::max(last, static_cast<uint32_t>(row));
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::Text("%d", row);
+					for ( size_t i = 0; i < layout.Fields.size(); ++i) {
+						ImGui::TableNextColumn();
+						if (resolved) {
+							char cell[CELLLEN];
+							const auto &field = layout.Fields[i];
+							Struct::Format(field, layout.Locate(field, Bases[i], row), pimage, cell, sizeof(cell));
+							ImGui::TextUnformatted(cell);
+						}
+					}
+				}
+			}
+			clipper.End();
+			ImGui::EndTable();
+
+			//Scrolled to other rows, ask for them
+			if ((first <= last) && ((first != FirstRow) || (last != LastRow))) {
+				FirstRow = first;
+				LastRow = last;
+				Dirty = true;
+			}
+		}
+	}
+
+	ImGui::End();
+}
+
+}	//namespace StructView
@@ -0,0 +1,251 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Timing.cpp
+//----------------------------------------------------------------------
+
+
+#include "Timing.h"
+#include "6502.h"
+#include "Flow.h"
+#include "Registers.h"
+#include "Shadow.h"
+#include "Xref.h"
+
+#include <algorithm>
+
+namespace Timing
+{
+
+constexpr uint32_t NOTTAKEN = 2;				//Cycles of a branch that falls through
+
+std::vector<Loop> Loops;						//Sorted by Head
+uint32_t FlowStamp = 0xffffffff;				//Sources of the loops
+uint32_t ShadowStamp = 0xffffffff;
+
+//----------------------------------------------------------------
+///Return true if two addresses are on different pages
+constexpr bool Crosses( uint32_t aA, uint32_t aB )
+{
+	return ((aA ^ aB) & 0xff00) != 0;
+}
+
+//----------------------------------------------------------------
+Cost QInstruction( uint16_t aAddress )
+{
+	const uint8_t *pimage = Shadow::QImage();
+	const uint8_t op = pimage[aAddress];
+	const OpCode &rop = OpCode::Get(op);
+	const uint8_t low = pimage[(aAddress + 1) & 0xffff];
+	const uint16_t word = low | (pimage[(aAddress + 2) & 0xffff] << 8);
+	Cost cost{ rop.Cycles, rop.Cycles };
+
+	switch (rop.eMode) {
+		case ADDRESS_MODE::RELATIVE:
+		{
+			const uint32_t next = aAddress + 2;
+			const uint32_t target = (next + static_cast<int8_t>(low)) & 0xffff;
+			cost.Min = NOTTAKEN;
+			cost.Max = NOTTAKEN + 1 + (Crosses(next, target) ? 1 : 0);
+			break;
+		}
+		case ADDRESS_MODE::ABSOLUTE_X:
+		case ADDRESS_MODE::ABSOLUTE_Y:
+		case ADDRESS_MODE::INDIRECT_Y:
+			//Stores and read-modify-writes always take the extra cycle,
+			// reads only when the index carries into the next page
+			if (Xref::QAccess(op) == Xref::ACCESS::READ) {
+				const uint16_t base = (rop.eMode == ADDRESS_MODE::INDIRECT_Y)
+					? pimage[low] | (pimage[(low + 1) & 0xff] << 8)
+					: word;
+				if (const auto cpu = Registers::QCPU(); cpu.IP == aAddress) {
+					const uint8_t index = (rop.eMode == ADDRESS_MODE::ABSOLUTE_X) ? cpu.XR : cpu.YR;
+					cost.Min += Crosses(base, base + index) ? 1 : 0;
+					cost.Max = cost.Min;
+				}
+				else if (base & 0xff) {
+					cost.Max += 1;				//Index of 0 can't cross
+				}
+			}
+			break;
+		default:
+			break;
+	}
+	return cost;
+}
+
+//----------------------------------------------------------------
+///Cycles of a block up to its last instruction
+Cost Body( const Flow::Block &arBlock )
+{
+	Cost cost;
+	for ( uint32_t addr = arBlock.Start; addr < arBlock.Last; addr += OpCode::Get(Shadow::QImage()[addr]).QSize()) {
+		const Cost instruction = QInstruction(static_cast<uint16_t>(addr));
+		cost.Min += instruction.Min;
+		cost.Max += instruction.Max;
+	}
+	return cost;
+}
+
+//----------------------------------------------------------------
+///Cycles of the last instruction of a block when it leaves for aTo
+Cost Exit( const Flow::Block &arBlock, uint32_t aTo )
+{
+	const Cost cost = QInstruction(arBlock.Last);
+	if (arBlock.Flags & Flow::BRANCH) {
+		return (aTo == arBlock.Target) ? Cost{ cost.Max, cost.Max } : Cost{ cost.Min, cost.Min };
+	}
+	return cost;
+}
+
+//----------------------------------------------------------------
+///Get index of the block starting at an address, or size if none
+size_t Find( uint32_t aAddress )
+{
+	const auto &rblocks = Flow::QBlocks();
+	if (aAddress < Flow::NONE) {
+		if (const Flow::Block *pblock = Flow::QBlock(static_cast<uint16_t>(aAddress)); pblock && (pblock->Start == aAddress)) {
+			return pblock - rblocks.data();
+		}
+	}
+	return rblocks.size();
+}
+
+//----------------------------------------------------------------
+///Cheapest and dearest paths from the head block forward to the latch
+/// and back to the head. Only blocks between the two are considered.
+/// Return false if the latch can't be reached from the head that way
+bool Iterate( size_t aHead, size_t aLatch, Loop &arLoop )
+{
+	const auto &rblocks = Flow::QBlocks();
+	const size_t count = aLatch - aHead + 1;
+
+	//Cycles from the head to the start of each block
+	std::vector<Cost> reach(count, { UINT32_MAX, 0 });
+	std::vector<bool> reached(count, false);
+	reach[0] = { 0, 0 };
+	reached[0] = true;
+
+	//Forward edges inside the loop as block index pairs
+	std::vector<std::pair<size_t, size_t>> edges;
+	for ( size_t i = 0; i < count; ++i) {
+		const Flow::Block &rblock = rblocks[aHead + i];
+		const uint32_t targets[2] = { rblock.Next, (rblock.Flags & Flow::CALL) ? Flow::NONE : rblock.Target };
+		for ( auto to : targets ) {
+			const size_t j = Find(to);
+			if ((j > aHead + i) && (j <= aLatch)) {
+				edges.push_back({ i, j - aHead });
+				if (reached[i]) {
+					const Cost body = Body(rblock);
+					const Cost exit = Exit(rblock, to);
+					reach[j - aHead].Min = std::min(reach[j - aHead].Min, reach[i].Min + body.Min + exit.Min);
+					reach[j - aHead].Max = std::max(reach[j - aHead].Max, reach[i].Max + body.Max + exit.Max);
+					reached[j - aHead] = true;
+				}
+			}
+		}
+	}
+	if (!reached[count - 1]) {
+		return false;
+	}
+
+	//Blocks on a path from the head to the latch, edges are in source order
+	std::vector<bool> body(count, false);
+	body[count - 1] = true;
+	for ( auto it = edges.rbegin(); it != edges.rend(); ++it) {
+		body[it->first] = body[it->first] || (reached[it->first] && body[it->second]);
+	}
+
+	const Flow::Block &rlatch = rblocks[aLatch];
+	const Cost latch = Body(rlatch);
+	const Cost back = Exit(rlatch, rblocks[aHead].Start);
+	arLoop.Head = rblocks[aHead].Start;
+	arLoop.Latch = rlatch.Start;
+	arLoop.Iteration = { reach[count - 1].Min + latch.Min + back.Min, reach[count - 1].Max + latch.Max + back.Max };
+	arLoop.Blocks = static_cast<uint32_t>(std::count(body.begin(), body.end(), true));
+	return true;
+}
+
+//----------------------------------------------------------------
+///Find loops as jumps or branches back to an earlier block of the same
+/// subroutine, if Flow or the memory changed
+void Check(  )
+{
+	const uint32_t flow = Flow::QStamp();
+	const uint32_t shadow = Shadow::QStamp(0, 0xffff);
+	if ((flow == FlowStamp) && (shadow == ShadowStamp)) {
+		return;
+	}
+	FlowStamp = flow;
+	ShadowStamp = shadow;
+
+	Loops.clear();
+	const auto &rblocks = Flow::QBlocks();
+	for ( size_t latch = 0; latch < rblocks.size(); ++latch) {
+		const Flow::Block &rblock = rblocks[latch];
+		const uint32_t targets[2] = { rblock.Next, (rblock.Flags & Flow::CALL) ? Flow::NONE : rblock.Target };
+		for ( auto to : targets ) {
+			if (const size_t head = Find(to); (head <= latch) && (rblocks[head].Owner == rblock.Owner)) {
+				if (Loop loop; Iterate(head, latch, loop)) {
+					Loops.push_back(loop);
+				}
+			}
+		}
+	}
+	std::stable_sort(Loops.begin(), Loops.end(), []( const Loop &arA, const Loop &arB ) { return arA.Head < arB.Head; });
+}
+
+//----------------------------------------------------------------
+Cost QBlock( uint16_t aAddress )
+{
+	const Flow::Block *pblock = Flow::QBlock(aAddress);
+	if (!pblock || (pblock->Start != aAddress)) {
+		return {};
+	}
+	const Cost body = Body(*pblock);
+	const Cost last = QInstruction(pblock->Last);
+	return { body.Min + last.Min, body.Max + last.Max };
+}
+
+//----------------------------------------------------------------
+const Loop *QLoop( uint16_t aAddress )
+{
+	Check();
+	auto it = std::lower_bound(Loops.begin(), Loops.end(), aAddress
+		, []( const Loop &arLoop, uint16_t aValue ) { return arLoop.Head < aValue; });
+	return ((it != Loops.end()) && (it->Head == aAddress)) ? &*it : nullptr;
+}
+
+//----------------------------------------------------------------
+const std::vector<Loop> &QLoops(  )
+{
+	Check();
+	return Loops;
+}
+
+}	//namespace Timing
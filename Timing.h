@@ -0,0 +1,84 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Timing.h
+//----------------------------------------------------------------------
+
+
+#pragma once
+
+#include "types.h"
+
+#include <vector>
+
+///Static cycle counts for the computer's code. Each instruction's cost
+/// comes from its OpCode Cycles plus the 6502 penalties: +1 for an
+/// indexed read that crosses a page and, for a branch, +1 when taken and
+/// +1 more when the target is on another page. Index registers are only
+/// known at the IP, so elsewhere a read that might cross a page is a
+/// range. Blocks and loops from Flow are totalled along their paths.
+/// Cycles spent in called subroutines are not included.
+namespace Timing
+{
+
+//----------------------------------------------------------------
+///Cycle range, for a branch Min is not taken and Max taken
+struct Cost
+{
+	uint32_t Min = 0;
+	uint32_t Max = 0;
+};
+
+//----------------------------------------------------------------
+///Loop closed by a jump or branch from the block at Latch back to Head
+struct Loop
+{
+	uint16_t Head;
+	uint16_t Latch;
+	Cost Iteration;								//Cycles from Head round to Head again
+	uint32_t Blocks;							//Blocks in the loop body
+};
+
+//----------------------------------------------------------------
+///Get cycles for the instruction at an address
+Cost QInstruction( uint16_t aAddress );
+
+//----------------------------------------------------------------
+///Get cycles to run the block starting at an address, from its
+/// cheapest to its dearest exit
+Cost QBlock( uint16_t aAddress );
+
+//----------------------------------------------------------------
+///Get the loop with its head at an address, nullptr if none
+const Loop *QLoop( uint16_t aAddress );
+
+//----------------------------------------------------------------
+///Get all loops sorted by head address
+const std::vector<Loop> &QLoops(  );
+
+}	//namespace Timing
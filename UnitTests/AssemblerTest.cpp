@@ -1,4 +1,7 @@
 #include "pch.h"
+#include <chrono>
+#include <string>
+#include <vector>
 #include "CppUnitTest.h"
 #include "CppUnitTestAssert.h"
 #include "Framework.h"
@@ -47,6 +50,16 @@ namespace UnitTests
 				{"lda $567B,Y", 0xB9, 0x7B, 0x56, 3, true},
 				{"STA 567D,y", 0x99, 0x7D, 0x56, 3, true},
 				{"LDA 567D,x", 0xBD, 0x7D, 0x56, 3, true},
+				{"NOP", 0xEA, 0, 0, 1, true},				//Documented wins over the undocumented NOPs
+				{"SBC #$12", 0xE9, 0x12, 0, 2, true},
+#if UNDOCUMENTED_OPCODES
+				{"LAX $12,Y", 0xB7, 0x12, 0, 2, true},
+				{"sax ($12,x)", 0x83, 0x12, 0, 2, true},
+				{"DCP $1234,X", 0xDF, 0x34, 0x12, 3, true},
+				{"ISC $1234,X", 0xFF, 0x34, 0x12, 3, true},		//Opcode $ff isn't a failure
+				{"SBX #$10", 0xCB, 0x10, 0, 2, true},
+				{"NOP #$10", 0x80, 0x10, 0, 2, true},
+#endif
 			};
 
 			Assembler::Assemble ass;
@@ -63,5 +76,97 @@ namespace UnitTests
 				Assert::AreEqual(t.Len, ass.Len, L"Len missmatch");
 			}
 		}
+
+		TEST_METHOD(TestFindAll)
+		{
+			//Every letter triple in both cases against the original linear search
+			char name[4] = {};
+			for ( char a = 'A'; a <= 'Z'; ++a) {
+				for ( char b = 'A'; b <= 'Z'; ++b) {
+					for ( char c = 'A'; c <= 'Z'; ++c) {
+						for ( uint32_t m = 0; m <= static_cast<uint32_t>(ADDRESS_MODE::ERROR); ++m) {
+							const ADDRESS_MODE mode = static_cast<ADDRESS_MODE>(m);
+							name[0] = a; name[1] = b; name[2] = c;
+							const uint16_t op = OpCode::FindReference(name, mode);
+							Assert::AreEqual(op, OpCode::Find(name, mode), L"Find missmatch");
+							name[0] += 'a' - 'A'; name[2] += 'a' - 'A';
+							Assert::AreEqual(op, OpCode::Find(name, mode), L"Lower case Find missmatch");
+						}
+					}
+				}
+			}
+			Assert::AreEqual(OpCode::NOTFOUND, OpCode::Find("L1A", ADDRESS_MODE::NONE), L"Non letter found");
+
+			const char *matches[0x10];
+			Assert::AreEqual(3u, OpCode::FindMatches(matches, 0x10, "LD"), L"LD completions");
+			Assert::AreEqual("LDY", matches[2], false, L"LD completion order");
+			Assert::AreEqual(0u, OpCode::FindMatches(matches, 0x10, "Q"), L"Q completions");
+			Assert::AreEqual(2u, OpCode::FindMatches(matches, 2, ""), L"Completions limit");
+		}
+
+		TEST_METHOD(TestAssembleBenchmark)
+		{
+			//Operand text per ADDRESS_MODE
+			const char *OperandA[] = {
+				"", " #$12", " $12", " $12,X", " $12,Y", " ($12,X)", " ($12),Y",
+				" $2210", " $1234", " $1234,X", " $1234,Y"
+			};
+
+			//Every opcode repeated out to 100K lines, except JMP ($xxxx)
+			// which the assembler has never parsed
+			constexpr uint32_t LINES = 100000;
+			std::vector<std::string> source;
+			std::vector<TestData> expect;
+			for ( uint32_t op = 0; source.size() < LINES; op = (op + 1) & 0xff) {
+				const OpCode &rop = OpCode::Get(static_cast<uint8_t>(op));
+				if ((rop == "BAD") || (rop == ADDRESS_MODE::INDIRECT)) {
+					continue;
+				}
+				source.push_back(std::string(rop.pName, 3) + OperandA[static_cast<uint32_t>(rop.eMode)]);
+
+				//Branches to $2210 from $2200 are $10, other operands $12 or $1234
+				const uint16_t found = OpCode::FindReference(rop.pName, rop.eMode);
+				const uint8_t len = rop.QSize();
+				const uint8_t b0 = (rop.eMode == ADDRESS_MODE::RELATIVE) ? 0x10 : (len == 3) ? 0x34 : (len == 2) ? 0x12 : 0;
+				expect.push_back({ nullptr, static_cast<uint8_t>(found), b0, static_cast<uint8_t>((len == 3) ? 0x12 : 0), len, found != OpCode::NOTFOUND });
+			}
+
+			Assembler::Assemble ass;
+			std::vector<TestData> results(LINES);
+			auto start = std::chrono::steady_clock::now();
+			for ( uint32_t i = 0; i < LINES; ++i) {
+				const bool bres = ass.FromString(source[i].c_str(), static_cast<uint32_t>(source[i].size()), 0x2200);
+				results[i] = { nullptr, ass.OP, ass.B0, ass.B1, ass.Len, bres };
+			}
+			const double assemble = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			//Name lookup alone, hashed and linear
+			auto lookup = [&]( uint16_t (*apFind)(const char*, ADDRESS_MODE) )
+			{
+				uint32_t sum = 0;
+				auto begin = std::chrono::steady_clock::now();
+				for ( uint32_t i = 0; i < LINES; ++i) {
+					sum += apFind(source[i].c_str(), OpCode::Get(results[i].OP).eMode);
+				}
+				const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+				return std::make_pair(ms, sum);
+			};
+			const auto hashed = lookup(OpCode::Find);
+			const auto linear = lookup(OpCode::FindReference);
+
+			char msg[0x80];
+			sprintf_s(msg, "100K lines: assemble %.2fms, find %.2fms, linear find %.2fms\n", assemble, hashed.first, linear.first);
+			Logger::WriteMessage(msg);
+
+			for ( uint32_t i = 0; i < LINES; ++i) {
+				Assert::IsTrue(expect[i].res, L"Opcode not in table");
+				Assert::AreEqual(expect[i].res, results[i].res, L"Result missmatch");
+				Assert::AreEqual(expect[i].OP, results[i].OP, L"Op missmatch");
+				Assert::AreEqual(expect[i].B0, results[i].B0, L"B0 missmatch");
+				Assert::AreEqual(expect[i].B1, results[i].B1, L"B1 missmatch");
+				Assert::AreEqual(expect[i].Len, results[i].Len, L"Len missmatch");
+			}
+			Assert::AreEqual(linear.second, hashed.second, L"Find missmatch");
+		}
 	};
 }
@@ -0,0 +1,79 @@
+#include "pch.h"
+#include <cstring>
+#include <vector>
+#include "CppUnitTest.h"
+#include "CppUnitTestAssert.h"
+#include "Framework.h"
+#include "Stubs.h"
+#include "../Boundaries.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	TEST_CLASS(BoundariesTests)
+	{
+	public:
+
+		//----------------------------------------------------------------
+		///Fill $1000-$2fff with pseudo random instructions, return their starts
+		static std::vector<uint16_t> MakeCode(  )
+		{
+			memset(Stubs::Image, 0, sizeof(Stubs::Image));
+			++Stubs::Stamp;
+			std::vector<uint16_t> starts;
+			uint32_t seed = 0x2468ace;
+			auto next = [&](  ) { seed = seed * 1664525 + 1013904223; return static_cast<uint8_t>(seed >> 24); };
+			for ( uint32_t addr = 0x1000; addr < 0x3000; ) {
+				uint8_t op;
+				do {
+					op = next();
+				} while (!op || (OpCode::Get(op) == "BAD"));
+				starts.push_back(static_cast<uint16_t>(addr));
+				Stubs::Image[addr] = op;
+				for ( uint32_t i = 1; i < OpCode::Get(op).QSize(); ++i) {
+					Stubs::Image[addr + i] = next();
+				}
+				addr += OpCode::Get(op).QSize();
+			}
+			return starts;
+		}
+
+		TEST_METHOD(TestPrevWithEntries)
+		{
+			Boundaries::Clear();
+			const auto starts = MakeCode();
+
+			//IPs seen every so often pin the decoding
+			for ( size_t i = 0; i < starts.size(); i += 50) {
+				Boundaries::AddEntry(starts[i]);
+			}
+			for ( size_t i = 1; i < starts.size(); ++i) {
+				Assert::AreEqual(starts[i - 1], Boundaries::QPrev(starts[i]), L"Previous start missmatch");
+			}
+			Assert::AreEqual(starts[starts.size() - 11], Boundaries::QPrev(starts.back(), 10), L"Ten back missmatch");
+		}
+
+		TEST_METHOD(TestClear)
+		{
+			Boundaries::Clear();
+			const auto starts = MakeCode();
+
+			//An entry inside an instruction forces the decoding out of step
+			uint32_t i = 100;
+			while (OpCode::Get(Stubs::Image[starts[i]]).QSize() < 2) {
+				++i;
+			}
+			const auto inside = static_cast<uint16_t>(starts[i] + 1);
+			Boundaries::AddEntry(inside);
+			Assert::AreEqual(inside, Boundaries::QPrev(starts[i + 1]), L"Entry not used");
+
+			//Gone once cleared, as after loading another program
+			Boundaries::Clear();
+			for ( size_t s = 0; s < starts.size(); s += 50) {
+				Boundaries::AddEntry(starts[s]);
+			}
+			Assert::AreEqual(starts[i], Boundaries::QPrev(starts[i + 1]), L"Entry kept after Clear");
+		}
+	};
+}
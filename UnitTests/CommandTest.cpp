@@ -21,5 +21,21 @@ namespace UnitTests
 			Assert::AreEqual<uint32_t>(static_cast<uint32_t>(p->QCommand()), 0xcc, L"Incorrect Command");
 			Assert::AreEqual<uint8_t>(p->QBody()[0], 1, L"Incorrect Body Value");
 		}
+
+		TEST_METHOD(CreateFillsToMaxSize)
+		{
+			//Small sizes are raised to DEFBODYLEN, larger ones kept. Either way
+			// the whole of QMaxSize must fit in the allocation
+			for ( uint32_t size : { 4u, DEFBODYLEN, DEFBODYLEN + 5, 0x412u } ) {
+				CommandPtr p = Command::Create(COMMAND::MEMORY_SET, size);
+				Assert::AreEqual<uint32_t>(p->QMaxSize(), (size < DEFBODYLEN) ? DEFBODYLEN : size, L"Incorrect Max Size");
+				for ( uint32_t i = 0; i < p->QMaxSize(); ++i) {
+					p->Add(static_cast<uint8_t>(i));
+				}
+				p->Add(0xee_u8);				//Full, so ignored
+				Assert::AreEqual<uint32_t>(p->QBodyLen(), p->QMaxSize(), L"Incorrect Body Length");
+				Assert::AreEqual<uint8_t>(p->QBody()[p->QMaxSize() - 1], static_cast<uint8_t>(p->QMaxSize() - 1), L"Incorrect Last Byte");
+			}
+		}
 	};
 }
@@ -0,0 +1,40 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "CppUnitTestAssert.h"
+#include "Framework.h"
+#include "../Compare.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	TEST_CLASS(CompareTests)
+	{
+	public:
+
+		TEST_METHOD(TestRuns)
+		{
+			static uint8_t a[0x2000] = { 0 };
+			static uint8_t b[0x2000] = { 0 };
+			b[0x0010] = 1;						//Single byte in a register
+			b[0x003f] = 1;						//Run across 64 byte blocks
+			b[0x0040] = 1;
+			b[0x0100] = 1;						//Two bytes with a gap of 1
+			b[0x0102] = 1;
+			b[0x1fff] = 1;						//Last byte
+
+			Compare::Run runs[8];
+			uint32_t bytes = 0;
+			Assert::AreEqual<uint32_t>(Compare::FindRuns(a, b, sizeof(a), runs, 8, bytes), 5, L"Run count");
+			Assert::AreEqual<uint32_t>(bytes, 6, L"Byte count");
+			Assert::AreEqual<uint32_t>(runs[1].Start, 0x3f, L"Block crossing start");
+			Assert::AreEqual<uint32_t>(runs[1].Len, 2, L"Block crossing length");
+			Assert::AreEqual<uint32_t>(runs[4].Start, 0x1fff, L"Tail run");
+
+			Assert::AreEqual<uint32_t>(Compare::FindRuns(a, b, sizeof(a), runs, 8, bytes, 1), 4, L"Merged count");
+			Assert::AreEqual<uint32_t>(runs[2].Len, 3, L"Merged length");
+
+			Assert::AreEqual<uint32_t>(Compare::FindRuns(a, b, sizeof(a), runs, 2, bytes), 2, L"Limited count");
+		}
+	};
+}
@@ -1,16 +1,14 @@
 #include "pch.h"
+#include <chrono>
+#include <cstring>
 #include "CppUnitTest.h"
 #include "CppUnitTestAssert.h"
 #include "Framework.h"
+#include "Stubs.h"
 #include "../Disassembler.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
-namespace Labels
-{
-	const char *Find( uint16_t ) { return nullptr; }
-}
-
 namespace UnitTests
 {
 
@@ -138,5 +136,63 @@ const OpCode *OpCodeDest[LINES];
 				}
 			}
 		}
+
+		TEST_METHOD(TestFormatBenchmark)
+		{
+			//Pseudo random memory, decoded one line at every address as DisCache does
+			static uint8_t memory[0x10002];
+			uint32_t seed = 0x1234567;
+			for ( auto &rbyte : memory ) {
+				seed = seed * 1664525 + 1013904223;
+				rbyte = static_cast<uint8_t>(seed >> 24);
+			}
+
+			char dis[2][0x40];
+			char bytes[2][0x10];
+			const OpCode *pops[2];
+			auto run = [&]( uint32_t aIndex, uint16_t (*apFunc)(const DisAssembler::Input&) )
+			{
+				auto start = std::chrono::steady_clock::now();
+				for ( uint32_t addr = 0; addr < 0x10000; ++addr) {
+					DisAssembler::Input input{ dis[aIndex], bytes[aIndex], &pops[aIndex], memory + addr, sizeof(dis[0]), 3, 1, static_cast<uint16_t>(addr) };
+					apFunc(input);
+				}
+				return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			};
+
+			const double table = run(0, DisAssembler::DisAssemble);
+			const double parser = run(1, DisAssembler::Reference);
+			char msg[0x80];
+			sprintf_s(msg, "64K lines: table %.2fms, parser %.2fms\n", table, parser);
+			Logger::WriteMessage(msg);
+
+			//Line by line equality, except JMP ($xxxx) which the parser never supported
+			auto compare = [&](  )
+			{
+				for ( uint32_t addr = 0; addr < 0x10000; ++addr) {
+					if (memory[addr] == 0x6c) {
+						continue;
+					}
+					for ( uint32_t i = 0; i < 2; ++i) {
+						DisAssembler::Input input{ dis[i], bytes[i], &pops[i], memory + addr, sizeof(dis[0]), 3, 1, static_cast<uint16_t>(addr) };
+						(i ? DisAssembler::Reference : DisAssembler::DisAssemble)(input);
+					}
+					Assert::AreEqual(dis[1], dis[0], false, L"DisAssembly missmatch");
+					Assert::AreEqual(bytes[1], bytes[0], false, L"Bytecode missmatch");
+					Assert::IsTrue(pops[0] == pops[1], L"Opcode missmatch");
+				}
+			};
+			compare();
+
+			//Again with labels replacing values, zero page ones included, and
+			// on operand bytes, which get a "label: " prefix
+			for ( uint32_t addr = 0; addr < 0x10000; addr += (addr < 0x100) ? 3 : 7) {
+				char name[8];
+				sprintf_s(name, "l%04x", addr);
+				Stubs::Names[static_cast<uint16_t>(addr)] = name;
+			}
+			compare();
+			Stubs::Names.clear();
+		}
 	};
 }
@@ -0,0 +1,50 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "CppUnitTestAssert.h"
+#include "Framework.h"
+#include "../Search.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	TEST_CLASS(SearchTests)
+	{
+	public:
+
+		TEST_METHOD(TestParse)
+		{
+			Search::Pattern p;
+			Assert::IsTrue(p.Parse("A9 ?? 8D", Search::MODE::BYTES), L"Bytes failed");
+			Assert::AreEqual<uint32_t>(p.Len, 3, L"Bytes length");
+			Assert::AreEqual<uint8_t>(p.Masks[1], 0, L"Wildcard mask");
+			Assert::IsTrue(p.Parse("$D020", Search::MODE::WORD), L"Word failed");
+			Assert::AreEqual<uint8_t>(p.Values[0], 0x20, L"Word not little endian");
+			Assert::IsFalse(p.Parse("A9 ZZ", Search::MODE::BYTES), L"Bad byte accepted");
+		}
+
+		TEST_METHOD(TestFind)
+		{
+			static uint8_t mem[0x10000] = { 0 };
+			const uint8_t code[] = { 0xA9, 0x01, 0x8D, 0x20, 0xD0 };
+			memcpy(&mem[0x1234], code, sizeof(code));
+			memcpy(&mem[0xfffb], code, sizeof(code));	//Match at the very end of memory
+			memcpy(&mem[0x4000], "\x08\x05\x0c\x0c\x0f", 5);	//HELLO in screen codes
+
+			Search::Pattern p;
+			uint16_t results[8];
+			p.Parse("A9 ?? 8D", Search::MODE::BYTES);
+			Assert::AreEqual<uint32_t>(Search::Find(p, mem, sizeof(mem), results, 8), 2, L"Bytes count");
+			Assert::AreEqual<uint16_t>(results[0], 0x1234, L"Bytes address");
+			Assert::AreEqual<uint16_t>(results[1], 0xfffb, L"Bytes tail address");
+
+			p.Parse("D020", Search::MODE::WORD);
+			Assert::AreEqual<uint32_t>(Search::Find(p, mem, sizeof(mem), results, 8), 2, L"Word count");
+			Assert::AreEqual<uint16_t>(results[0], 0x1237, L"Word address");
+
+			p.Parse("hello", Search::MODE::SCREEN, true);
+			Assert::AreEqual<uint32_t>(Search::Find(p, mem, sizeof(mem), results, 8), 1, L"Screen count");
+			Assert::AreEqual<uint16_t>(results[0], 0x4000, L"Screen address");
+		}
+	};
+}
@@ -0,0 +1,68 @@
+#include "pch.h"
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "CppUnitTest.h"
+#include "CppUnitTestAssert.h"
+#include "Framework.h"
+#include "Stubs.h"
+#include "../Source.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	TEST_CLASS(SourceTests)
+	{
+	public:
+
+		TEST_METHOD(TestWrite)
+		{
+			const uint8_t code[] = {
+				0xa2, 0x00,						//1000 ldx #$00
+				0xad, 0xfb, 0x00,				//1002 lda $00fb, zero page in an absolute op
+				0x8d, 0x01, 0x10,				//1005 sta $1001, inside the ldx
+				0x20, 0x00, 0x20,				//1008 jsr $2000, outside the range
+				0x2c, 0xa9, 0x01,				//100b bit $01a9, runs over the entry at 100c
+				0x60							//100e rts
+			};
+			memset(Stubs::Image, 0, sizeof(Stubs::Image));
+			memcpy(&Stubs::Image[0x1000], code, sizeof(code));
+
+			Source::Job job;
+			job.pImage = Stubs::Image;
+			job.Ranges = { { 0x1000, 0x100e, "" } };
+			job.Entries = { 0x1000, 0x100c };
+			job.FindLabel = []( uint16_t aAddress ) -> const char * {
+				return (aAddress == 0x1000) ? "start" : (aAddress == 0x2000) ? "ext" : nullptr;
+			};
+
+			std::string text;
+			Source::Write(job, [&]( const char *apText, uint32_t aSize ) { text.append(apText, aSize); });
+
+			const char *expected[] = {
+				"// Disassembled by c64debugger",
+				"",
+				".label ext = $2000",
+				"",
+				"* = $1000",
+				"start:",
+				"\tldx #$00",
+				"\tlda.abs $00FB",
+				"\tsta start+1",
+				"\tjsr ext",
+				"\t.byte $2C",
+				"\tlda #$01",
+				"\trts"
+			};
+			std::istringstream strm(text);
+			std::string line;
+			for ( const char *pexpected : expected ) {
+				Assert::IsTrue(static_cast<bool>(std::getline(strm, line)), L"Output too short");
+				Assert::AreEqual(pexpected, line.c_str(), false, L"Line missmatch");
+			}
+			Assert::IsFalse(static_cast<bool>(std::getline(strm, line)), L"Output too long");
+		}
+	};
+}
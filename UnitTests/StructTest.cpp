@@ -0,0 +1,135 @@
+#include "pch.h"
+#include <cstring>
+#include "CppUnitTest.h"
+#include "CppUnitTestAssert.h"
+#include "Framework.h"
+#include "../Struct.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Labels
+{
+	bool Find( const char *apName, uint16_t &arValue )
+	{
+		if (strcmp(apName, "sprites") == 0) {
+			arValue = 0xc000;
+			return true;
+		}
+		return false;
+	}
+}
+
+namespace UnitTests
+{
+	TEST_CLASS(StructTests)
+	{
+	public:
+
+		TEST_METHOD(TestParse)
+		{
+			Struct::Layout layout;
+			std::string error;
+			layout.Text = "rows 4   # four sprites\n"
+				"stride 8\n"
+				"\n"
+				"x lohi xlo/xhi\n"
+				"speed sfix4.4 sprites+2\n"
+				"frames byte[3] $c003\n";
+			Assert::IsTrue(layout.Parse(error), L"Layout failed");
+			Assert::AreEqual<uint32_t>(layout.Rows, 4, L"Rows");
+			Assert::AreEqual<uint32_t>(layout.Stride, 8, L"Stride");
+			Assert::AreEqual<size_t>(layout.Fields.size(), 3, L"Field count");
+			Assert::IsTrue(layout.Fields[0].Type == Struct::TYPE::LOHI, L"Lohi type");
+			Assert::AreEqual(std::string("xhi"), layout.Fields[0].HiLocation, L"Hi location");
+			Assert::IsTrue(layout.Fields[1].Type == Struct::TYPE::SFIXED, L"Fixed type");
+			Assert::AreEqual<uint32_t>(layout.Fields[1].Fraction, 4, L"Fraction bits");
+			Assert::AreEqual<uint32_t>(layout.Fields[2].QRowSize(), 3, L"Array row size");
+
+			//Errors name the line, which may hold printf directives
+			layout.Text = "rows 2\nname %s%n $1000\n";
+			Assert::IsFalse(layout.Parse(error), L"Bad type accepted");
+			Assert::AreEqual(std::string("Line 2: name %s%n $1000"), error, L"Error text");
+			layout.Text = "x fix4.3 $1000";
+			Assert::IsFalse(layout.Parse(error), L"7 bit fixed accepted");
+			layout.Text = "x lohi $1000";
+			Assert::IsFalse(layout.Parse(error), L"Lohi without hi accepted");
+			layout.Text = "rows 0\nx byte $1000";
+			Assert::IsFalse(layout.Parse(error), L"No rows accepted");
+			layout.Text = "# nothing\n";
+			Assert::IsFalse(layout.Parse(error), L"Empty layout accepted");
+			Assert::AreEqual(std::string("No fields"), error, L"Empty error text");
+		}
+
+		TEST_METHOD(TestResolve)
+		{
+			uint16_t address = 0;
+			Assert::IsTrue(Struct::Resolve("$d020", address), L"Hex failed");
+			Assert::AreEqual<uint16_t>(address, 0xd020, L"Hex address");
+			Assert::IsTrue(Struct::Resolve("sprites+10", address), L"Label failed");
+			Assert::AreEqual<uint16_t>(address, 0xc010, L"Label address");
+			Assert::IsFalse(Struct::Resolve("$12345", address), L"Long hex accepted");
+			Assert::IsFalse(Struct::Resolve("$zz", address), L"Bad hex accepted");
+			Assert::IsFalse(Struct::Resolve("missing", address), L"Unknown label accepted");
+
+			Struct::Layout layout;
+			std::string error;
+			layout.Text = "a byte $1000\nb word $1010\nc lohi $1020/$1030";
+			Assert::IsTrue(layout.Parse(error), L"Layout failed");
+			std::vector<Struct::Address> bases;
+			Assert::IsTrue(layout.Resolve(bases), L"Bases failed");
+			Assert::AreEqual<uint16_t>(layout.Locate(layout.Fields[1], bases[1], 3).Lo, 0x1016, L"Word array row");
+			Assert::AreEqual<uint16_t>(layout.Locate(layout.Fields[2], bases[2], 3).Hi, 0x1033, L"Hi table row");
+
+			layout.Text = "a byte missing\nb word $1010";
+			Assert::IsTrue(layout.Parse(error), L"Unresolved layout failed");
+			Assert::IsFalse(layout.Resolve(bases), L"Missing label resolved");
+			Assert::AreEqual<uint16_t>(bases[0].Lo, 0x1000, L"Bases changed by failed resolve");
+		}
+
+		TEST_METHOD(TestFormat)
+		{
+			static uint8_t image[0x10000] = { 0 };
+			const uint8_t data[] = { 0xff, 0x34, 0x12, 0x18, 0x88 };
+			memcpy(&image[0x2000], data, sizeof(data));
+			image[0x3000] = 0xcd;
+			image[0x3100] = 0xab;
+
+			struct Case
+			{
+				const char *pType;
+				uint16_t Lo;
+				uint16_t Hi;
+				const char *pResult;
+			};
+			const Case CaseA[] = {
+				{ "byte", 0x2000, 0, "FF" },
+				{ "sbyte", 0x2000, 0, "-1" },
+				{ "word", 0x2001, 0, "1234" },
+				{ "byte[3]", 0x2000, 0, "FF 34 12" },
+				{ "fix4.4", 0x2003, 0, "1.500" },
+				{ "sfix4.4", 0x2004, 0, "-7.500" },
+				{ "lohi", 0x3000, 0x3100, "ABCD" },
+			};
+
+			for ( const auto &rcase : CaseA ) {
+				Struct::Layout layout;
+				std::string error;
+				layout.Text = std::string("f ") + rcase.pType + " $0000/$0000";	//Only lohi uses the hi table
+				Assert::IsTrue(layout.Parse(error), L"Layout failed");
+				char text[0x40];
+				const uint32_t len = Struct::Format(layout.Fields[0], { rcase.Lo, rcase.Hi }, image, text, sizeof(text));
+				Assert::AreEqual<uint32_t>(len, static_cast<uint32_t>(strlen(rcase.pResult)), L"Length");
+				Assert::AreEqual(rcase.pResult, text, false, L"Format missmatch");
+			}
+
+			//Truncated to the destination, still terminated
+			Struct::Layout layout;
+			std::string error;
+			layout.Text = "f byte[3] $2000";
+			layout.Parse(error);
+			char text[6];
+			Assert::AreEqual<uint32_t>(Struct::Format(layout.Fields[0], { 0x2000, 0 }, image, text, sizeof(text)), 5, L"Truncated length");
+			Assert::AreEqual("FF 34", text, false, L"Truncated text");
+		}
+	};
+}
@@ -0,0 +1,53 @@
+#include "pch.h"
+#include "Stubs.h"
+#include "../BreakPoints.h"
+#include "../Labels.h"
+#include "../Program.h"
+#include "../Regions.h"
+#include "../Shadow.h"
+
+namespace Stubs
+{
+	uint8_t Image[0x10000] = { 0 };
+	uint32_t Stamp = 0;
+	std::unordered_map<uint16_t, std::string> Names;
+}
+
+namespace Shadow
+{
+	const uint8_t *QImage( Banks::Space ) { return Stubs::Image; }
+	uint32_t QStamp( uint16_t, uint16_t, Banks::Space ) { return Stubs::Stamp; }
+	void Fetch( uint16_t, uint16_t, Banks::Space ) { }
+}
+
+namespace BreakPoints
+{
+	bool ForEach( BREAKPOINTFN ) { return true; }
+	bool QBreakPoint( uint16_t ) { return false; }
+}
+
+namespace Labels
+{
+	const char *Find( uint16_t aValue )
+	{
+		auto it = Stubs::Names.find(aValue);
+		return (it != Stubs::Names.end()) ? it->second.c_str() : nullptr;
+	}
+	bool Read( const std::filesystem::path &, LabelMap & ) { return false; }
+	void ForEach( LABELFN ) { }
+	uint32_t QStamp(  ) { return 0; }
+}
+
+namespace Program
+{
+	uint32_t QStart(  ) { return 0x10000; }
+	uint32_t FindStart( const uint8_t *, uint32_t ) { return 0x10000; }
+}
+
+namespace Regions
+{
+	Span QLine( uint16_t aAddress, uint32_t aCodeSize ) { return { aAddress, aCodeSize, TYPE::UNKNOWN }; }
+	uint32_t QStamp(  ) { return 0; }
+	std::vector<uint16_t> QCodeMarks(  ) { return { }; }
+	uint32_t QMarkStamp(  ) { return 0; }
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+//Stand-ins for the live debugger state the modules under test reach for
+namespace Stubs
+{
+	extern uint8_t Image[0x10000];				//Memory returned by Shadow::QImage
+	extern uint32_t Stamp;						//Returned by Shadow::QStamp, bump when Image changes
+	extern std::unordered_map<uint16_t, std::string> Names;	//Labels found by Labels::Find, empty unless a test sets them
+}
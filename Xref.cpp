@@ -0,0 +1,328 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Xref.cpp
+//----------------------------------------------------------------------
+
+
+#include "Xref.h"
+#include "6502.h"
+#include "Code.h"
+#include "DisCache.h"
+#include "Flow.h"
+#include "Labels.h"
+#include "Shadow.h"
+
+#include <array>
+#include <imgui.h>
+#include <vector>
+
+#include "OpCodes.ipp"
+
+namespace Xref
+{
+
+constexpr uint32_t TIPREFS = 0x10;				//Most references listed in a tooltip
+
+//----------------------------------------------------------------
+constexpr bool Is( const char *apName, const char *apMatch )
+{
+	return (apName[0] == apMatch[0]) && (apName[1] == apMatch[1]) && (apName[2] == apMatch[2]);
+}
+
+//----------------------------------------------------------------
+///How each opcode accesses its operand, NONE for no memory operand
+constexpr std::array<ACCESS, 0x100> MakeAccess(  )
+{
+	std::array<ACCESS, 0x100> access{};
+	for ( uint32_t i = 0; i < access.size(); ++i) {
+		const OpCode &rop = OpCodeA[i];
+		switch (rop.eMode) {
+			case ADDRESS_MODE::NONE:
+			case ADDRESS_MODE::IMMEDIATE:
+			case ADDRESS_MODE::ERROR:
+				access[i] = ACCESS::NONE;
+				break;
+			case ADDRESS_MODE::INDIRECT_X:		//Pointers are read whatever is done through them
+			case ADDRESS_MODE::INDIRECT_Y:
+			case ADDRESS_MODE::INDIRECT:
+				access[i] = ACCESS::READ;
+				break;
+			case ADDRESS_MODE::RELATIVE:
+				access[i] = ACCESS::JUMP;
+				break;
+			default:
+				if (Is(rop.pName, "STA") || Is(rop.pName, "STX") || Is(rop.pName, "STY")
+					|| Is(rop.pName, "SAX")) {
+					access[i] = ACCESS::WRITE;
+				}
+				else if (Is(rop.pName, "ASL") || Is(rop.pName, "LSR") || Is(rop.pName, "ROL")
+					|| Is(rop.pName, "ROR") || Is(rop.pName, "INC") || Is(rop.pName, "DEC")
+					|| Is(rop.pName, "SLO") || Is(rop.pName, "RLA") || Is(rop.pName, "SRE")
+					|| Is(rop.pName, "RRA") || Is(rop.pName, "DCP") || Is(rop.pName, "ISC")) {
+					access[i] = ACCESS::RMW;
+				}
+				else if (Is(rop.pName, "JMP")) {
+					access[i] = ACCESS::JUMP;
+				}
+				else if (Is(rop.pName, "JSR")) {
+					access[i] = ACCESS::CALL;
+				}
+				else {
+					access[i] = ACCESS::READ;
+				}
+				break;
+		}
+	}
+	return access;
+}
+
+constexpr std::array<ACCESS, 0x100> AccessA = MakeAccess();
+
+static_assert(AccessA[0x8d] == ACCESS::WRITE && AccessA[0xee] == ACCESS::RMW && AccessA[0x20] == ACCESS::CALL);
+static_assert(AccessA[0x6c] == ACCESS::READ && AccessA[0xa9] == ACCESS::NONE && AccessA[0xd0] == ACCESS::JUMP);
+
+const char *AccessNameA[] = { "Read", "Write", "RMW", "Jump", "Call", "" };
+
+std::vector<uint32_t> Offsets(Shadow::IMAGESIZE + 1, 0);	//First ref of each address, then the end
+std::vector<Ref> Refs;							//References sorted by address
+uint32_t FlowStamp = 0xffffffff;				//Sources of the index
+uint32_t ShadowStamp = 0xffffffff;
+uint16_t Address = 0;							//Address shown in the window
+bool Enabled = false;							//Window enabled
+
+//----------------------------------------------------------------
+///Rebuild the index from the instructions in Flow's blocks with a
+/// counting sort on the referenced address
+void Build(  )
+{
+	struct Pending
+	{
+		uint16_t Address;
+		Ref Reference;
+	};
+	std::vector<Pending> pending;
+	pending.reserve(Refs.size());
+
+	const uint8_t *pimage = Shadow::QImage();
+	for ( const auto &rblock : Flow::QBlocks() ) {
+		for ( uint32_t addr = rblock.Start; addr < rblock.End; ) {
+			const uint8_t op = pimage[addr];
+			const uint32_t size = OpCode::Get(op).QSize();
+			if (const ACCESS eaccess = AccessA[op]; eaccess != ACCESS::NONE) {
+				uint16_t target = pimage[(addr + 1) & 0xffff];
+				if (size == 3) {
+					target |= pimage[(addr + 2) & 0xffff] << 8;
+				}
+				else if (OpCodeA[op].eMode == ADDRESS_MODE::RELATIVE) {
+					target = static_cast<uint16_t>(addr + 2 + static_cast<int8_t>(target));
+				}
+				pending.push_back({ target, { static_cast<uint16_t>(addr), eaccess } });
+			}
+			addr += size;
+		}
+	}
+
+	std::fill(Offsets.begin(), Offsets.end(), 0);
+	for ( const auto &rpending : pending ) {
+		++Offsets[rpending.Address + 1];
+	}
+	for ( uint32_t i = 1; i < Offsets.size(); ++i) {
+		Offsets[i] += Offsets[i - 1];
+	}
+
+	//Place each ref using a running copy of the offsets, blocks are in
+	// address order so sites stay sorted within an address
+	Refs.resize(pending.size());
+	std::vector<uint32_t> next(Offsets.begin(), Offsets.end() - 1);
+	for ( const auto &rpending : pending ) {
+		Refs[next[rpending.Address]++] = rpending.Reference;
+	}
+}
+
+//----------------------------------------------------------------
+///Rebuild the index if Flow or the memory changed
+void Check(  )
+{
+	const uint32_t flow = Flow::QStamp();
+	const uint32_t shadow = Shadow::QStamp(0, 0xffff);
+	if ((flow != FlowStamp) || (shadow != ShadowStamp)) {
+		FlowStamp = flow;
+		ShadowStamp = shadow;
+		Build();
+	}
+}
+
+//----------------------------------------------------------------
+void ToJson( nlohmann::json &arData )
+{
+	arData["Xref"] = {
+		{"On", Enabled},
+		{"Address", Address}
+	};
+}
+
+//----------------------------------------------------------------
+void FromJson( nlohmann::json &arData )
+{
+	auto obj = arData["Xref"];
+	if (!obj.is_null()) {
+		Enabled = obj["On"];
+		Address = obj["Address"];
+	}
+}
+
+//----------------------------------------------------------------
+ACCESS QAccess( uint8_t aOp )
+{
+	return AccessA[aOp];
+}
+
+//----------------------------------------------------------------
+const char *AccessName( ACCESS aeAccess )
+{
+	return AccessNameA[static_cast<uint32_t>(aeAccess)];
+}
+
+//----------------------------------------------------------------
+uint32_t QRefs( uint16_t aAddress, const Ref *&arpRefs )
+{
+	Check();
+	arpRefs = Refs.data() + Offsets[aAddress];
+	return Offsets[aAddress + 1] - Offsets[aAddress];
+}
+
+//----------------------------------------------------------------
+///Show one reference as "site label access in owner"
+void Text( const Ref &arRef )
+{
+	const char *plabel = Labels::Find(arRef.Site);
+	ImGui::Text("$%04X %s %s", arRef.Site, plabel ? plabel : "", AccessName(arRef.eAccess));
+	if (const Flow::Block *pblock = Flow::QBlock(arRef.Site); pblock && (pblock->Owner != arRef.Site)) {
+		const char *powner = Labels::Find(pblock->Owner);
+		ImGui::SameLine();
+		ImGui::TextDisabled("in %s%s$%04X", powner ? powner : "", powner ? " " : "", pblock->Owner);
+	}
+}
+
+//----------------------------------------------------------------
+void Tooltip( uint16_t aAddress )
+{
+	const Ref *prefs = nullptr;
+	const uint32_t count = QRefs(aAddress, prefs);
+	if (!count) {
+		return;
+	}
+
+	ImGui::BeginTooltip();
+	ImGui::Text("References to $%04X", aAddress);
+	for ( uint32_t i = 0; i < std::min(count, TIPREFS); ++i) {
+		Text(prefs[i]);
+	}
+	if (count > TIPREFS) {
+		ImGui::TextDisabled("%u more, right click to list all", count - TIPREFS);
+	}
+	ImGui::EndTooltip();
+
+	if (ImGui::IsMouseClicked(ImGuiMouseButton_Right)) {
+		DisplayOn(aAddress);
+	}
+}
+
+//----------------------------------------------------------------
+void DisplayOn(  )
+{
+	Enabled = true;
+}
+
+//----------------------------------------------------------------
+void DisplayOn( uint16_t aAddress )
+{
+	Address = aAddress;
+	Enabled = true;
+}
+
+//----------------------------------------------------------------
+void Display(  )
+{
+	if (!Enabled) return;						//Early out if view not visible
+
+	ImGui::SetNextWindowSize(ImVec2(330, 300), ImGuiCond_FirstUseEver);
+	ImGui::Begin("Xrefs", &Enabled);
+
+	ImGui::PushItemWidth(ImGui::GetFontSize() * 4.0f);
+	ImGui::InputScalar("Address", ImGuiDataType_U16, &Address, nullptr, nullptr, "%04x"
+		, ImGuiInputTextFlags_CharsHexadecimal);
+	ImGui::PopItemWidth();
+	if (const char *plabel = Labels::Find(Address); plabel) {
+		ImGui::SameLine();
+		ImGui::TextUnformatted(plabel);
+	}
+
+	const Ref *prefs = nullptr;
+	const uint32_t count = QRefs(Address, prefs);
+	ImGui::Text("%u references from %u blocks", count, static_cast<uint32_t>(Flow::QBlocks().size()));
+
+	if (ImGui::BeginTable("##Refs", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg
+		| ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable)) {
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("Address");
+		ImGui::TableSetupColumn("Label");
+		ImGui::TableSetupColumn("Instruction");
+		ImGui::TableSetupColumn("Access");
+		ImGui::TableHeadersRow();
+
+		ImGuiListClipper clipper;
+		clipper.Begin(static_cast<int>(count));
+		while (clipper.Step()) {
+			for ( int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+				const Ref &rref = prefs[row];
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				char text[8];
+				snprintf(text, sizeof(text), "%04x", rref.Site);
+				//Click shows the site in the Code view
+				if (ImGui::Selectable(text, false, ImGuiSelectableFlags_SpanAllColumns)) {
+					Code::SetAddress(rref.Site);
+				}
+				ImGui::TableNextColumn();
+				const char *plabel = Labels::Find(rref.Site);
+				ImGui::TextUnformatted(plabel ? plabel : "");
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(DisCache::Get(rref.Site).Text);
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(AccessName(rref.eAccess));
+			}
+		}
+		ImGui::EndTable();
+	}
+
+	ImGui::End();
+}
+
+}	//namespace Xref
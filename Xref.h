@@ -0,0 +1,104 @@
+//----------------------------------------------------------------------
+// Copyright (c) 2022, Guy Carver
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//
+//     * The name of Guy Carver may not be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// FILE    Xref.h
+//----------------------------------------------------------------------
+
+
+#pragma once
+
+#include "types.h"
+#include "json/json.hpp"
+
+///Cross references to every address from the code Flow found. Each
+/// instruction's zero page, absolute or pointer operand, branch or jump
+/// target is recorded with how it is accessed. References are kept
+/// sorted by address with an offset per address, so looking one up is a
+/// pair of array reads. The index is rebuilt when Flow or the Shadow
+/// changes, the next time it is asked for.
+namespace Xref
+{
+
+//----------------------------------------------------------------
+enum class ACCESS : uint8_t
+{
+	READ,
+	WRITE,
+	RMW,										//Read, modify, write
+	JUMP,										//Jump or branch
+	CALL,
+	NONE										//Not a reference
+};
+
+//----------------------------------------------------------------
+///Instruction at Site accessing an address
+struct Ref
+{
+	uint16_t Site;
+	ACCESS eAccess;
+};
+
+//----------------------------------------------------------------
+///Save data to Json
+void ToJson( nlohmann::json &arData );
+
+//----------------------------------------------------------------
+///Load data from Json
+void FromJson( nlohmann::json &arData );
+
+//----------------------------------------------------------------
+///Get how an opcode accesses its operand, NONE if it has no memory operand
+ACCESS QAccess( uint8_t aOp );
+
+//----------------------------------------------------------------
+///Get name of an access kind
+const char *AccessName( ACCESS aeAccess );
+
+//----------------------------------------------------------------
+///Get references to an address. arpRefs is set to the first one and
+/// the count is returned
+uint32_t QRefs( uint16_t aAddress, const Ref *&arpRefs );
+
+//----------------------------------------------------------------
+///Show references to an address in a tooltip if it has any, and open
+/// the window on them if the right mouse button is clicked
+void Tooltip( uint16_t aAddress );
+
+//----------------------------------------------------------------
+///Enable window
+void DisplayOn(  );
+
+//----------------------------------------------------------------
+///Enable window showing references to given address
+void DisplayOn( uint16_t aAddress );
+
+//----------------------------------------------------------------
+///Draw window
+void Display(  );
+
+}	//namespace Xref
@@ -2,11 +2,14 @@
 //
 
 #include "c64debugger.h"
+#include "ExportView.h"
 #include "Monitor.h"
 #include "Program.h"
+#include "Source.h"
 
 #include <windows.h>
 #include <chrono>
+#include <cstdio>
 #include <shellapi.h>
 #include <thread>
 #include <tlhelp32.h>
@@ -152,12 +155,32 @@ void RunApp( const char *apApp, const char *apParams = nullptr )
 	}
 }
 
+//----------------------------------------------------------------
+///This is a windows subsystem app so it starts with no console. Batch
+/// modes report on stdout/stderr, so use the console we were run from
+void AttachParentConsole(  )
+{
+	if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+		FILE *pfile = nullptr;
+		freopen_s(&pfile, "CONOUT$", "w", stdout);
+		freopen_s(&pfile, "CONOUT$", "w", stderr);
+	}
+}
+
 //----------------------------------------------------------------
 int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
 					[[maybe_unused]] _In_opt_ HINSTANCE hPrevInstance,
 					[[maybe_unused]] _In_ LPWSTR lpCmdLine,
 					_In_ int nCmdShow)
 {
+	auto args = ParseParams(lpCmdLine);
+	//Headless disassembly of .prg files, runs without a window or VICE
+	if ((args.size() > 1) && (args[0] == "-s")) {
+		AttachParentConsole();
+		std::vector<std::filesystem::path> paths(args.begin() + 1, args.end());
+		return static_cast<int32_t>(Source::Batch(paths));
+	}
+
 	// Initialize global strings
 	LoadStringW(hInstance, IDS_APP_TITLE, szTitle, MAX_LOADSTRING);
 	LoadStringW(hInstance, IDC_C64DEBUGGER, szWindowClass, MAX_LOADSTRING);
@@ -175,12 +198,16 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
 
 	MSG msg;
 
-	auto args = ParseParams(lpCmdLine);
 	if ((args.size() > 1) && (args[0] == "-p")) {
 		//Sleep for a bit to allow VICE to connect to us
 		std::this_thread::sleep_for(std::chrono::seconds(1));
 		Program::Load(args[1]);
 	}
+	//Batch export, runs once VICE connects then quits
+	else if ((args.size() > 1) && (args[0] == "-x")) {
+		AttachParentConsole();
+		ExportView::Batch(args[1]);
+	}
 
 	// Main message loop:
 	while (GetMessage(&msg, nullptr, 0, 0)) {
@@ -199,6 +226,9 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
 		}
 
 		Monitor::Display();
+		if (ExportView::QBatchDone()) {
+			::PostMessage(::FindWindowW(szWindowClass, nullptr), WM_CLOSE, 0, 0);
+		}
 
 		// Rendering
 		ImGui::Render();